@@ -24,9 +24,11 @@
 #include <crypto/ctr.h>
 #include <crypto/b128ops.h>
 #include <crypto/gcm.h>
+#include <crypto/gf128mul.h>
 #include <crypto/xts.h>
 #include <asm/cpu_device_id.h>
 #include <asm/simd.h>
+#include <asm/unaligned.h>
 #include <crypto/scatterwalk.h>
 #include <crypto/internal/aead.h>
 #include <crypto/internal/simd.h>
@@ -601,6 +603,35 @@ static int generic_gcmaes_set_authsize(struct crypto_aead *tfm,
 	return 0;
 }
 
+/* bytes processed per kernel_fpu_begin() section of a batch */
+#define GCM_BATCH_FPU_BYTES	(4 * PAGE_SIZE)
+
+/*
+ * Find the associated data and the data of a request in one or two
+ * segments, as network packets and the tcrypt buffers have them.  There is
+ * no highmem on x86_64, so the segments are in the linear mapping.
+ */
+static bool gcm_find_linear(struct scatterlist *sg, unsigned int assoclen,
+			    unsigned int datalen, u8 **assoc, u8 **data)
+{
+	if (sg->length >= assoclen + datalen) {
+		*assoc = sg_virt(sg);
+		*data = *assoc + assoclen;
+		return true;
+	}
+
+	if (sg->length != assoclen || sg_is_last(sg))
+		return false;
+
+	*assoc = sg_virt(sg);
+	sg = sg_next(sg);
+	if (sg->length < datalen)
+		return false;
+
+	*data = sg_virt(sg);
+	return true;
+}
+
 static int gcmaes_crypt_by_sg(bool enc, struct aead_request *req,
 			      unsigned int assoclen, u8 *hash_subkey,
 			      u8 *iv, void *aes_ctx, u8 *auth_tag,
@@ -836,7 +867,10 @@ static int xts_aesni_setkey(struct crypto_skcipher *tfm, const u8 *key,
 				  key + keylen, keylen);
 }
 
-static int xts_crypt(struct skcipher_request *req, bool encrypt)
+typedef void (*xts_crypt_func)(const struct crypto_aes_ctx *ctx, u8 *out,
+			       const u8 *in, unsigned int len, u8 *iv);
+
+static int xts_crypt(struct skcipher_request *req, xts_crypt_func crypt_func)
 {
 	struct crypto_skcipher *tfm = crypto_skcipher_reqtfm(req);
 	struct aesni_xts_ctx *ctx = crypto_skcipher_ctx(tfm);
@@ -883,14 +917,8 @@ static int xts_crypt(struct skcipher_request *req, bool encrypt)
 		if (nbytes < walk.total)
 			nbytes &= ~(AES_BLOCK_SIZE - 1);
 
-		if (encrypt)
-			aesni_xts_encrypt(aes_ctx(ctx->raw_crypt_ctx),
-					  walk.dst.virt.addr, walk.src.virt.addr,
-					  nbytes, walk.iv);
-		else
-			aesni_xts_decrypt(aes_ctx(ctx->raw_crypt_ctx),
-					  walk.dst.virt.addr, walk.src.virt.addr,
-					  nbytes, walk.iv);
+		crypt_func(aes_ctx(ctx->raw_crypt_ctx), walk.dst.virt.addr,
+			   walk.src.virt.addr, nbytes, walk.iv);
 		kernel_fpu_end();
 
 		err = skcipher_walk_done(&walk, walk.nbytes - nbytes);
@@ -915,14 +943,8 @@ static int xts_crypt(struct skcipher_request *req, bool encrypt)
 			return err;
 
 		kernel_fpu_begin();
-		if (encrypt)
-			aesni_xts_encrypt(aes_ctx(ctx->raw_crypt_ctx),
-					  walk.dst.virt.addr, walk.src.virt.addr,
-					  walk.nbytes, walk.iv);
-		else
-			aesni_xts_decrypt(aes_ctx(ctx->raw_crypt_ctx),
-					  walk.dst.virt.addr, walk.src.virt.addr,
-					  walk.nbytes, walk.iv);
+		crypt_func(aes_ctx(ctx->raw_crypt_ctx), walk.dst.virt.addr,
+			   walk.src.virt.addr, walk.nbytes, walk.iv);
 		kernel_fpu_end();
 
 		err = skcipher_walk_done(&walk, 0);
@@ -932,12 +954,12 @@ static int xts_crypt(struct skcipher_request *req, bool encrypt)
 
 static int xts_encrypt(struct skcipher_request *req)
 {
-	return xts_crypt(req, true);
+	return xts_crypt(req, aesni_xts_encrypt);
 }
 
 static int xts_decrypt(struct skcipher_request *req)
 {
-	return xts_crypt(req, false);
+	return xts_crypt(req, aesni_xts_decrypt);
 }
 
 static struct crypto_alg aesni_cipher_alg = {
@@ -1093,11 +1115,195 @@ static int generic_gcmaes_decrypt(struct aead_request *req)
 			      aes_ctx);
 }
 
+/*
+ * The keys, the GCM IV and the length of the associated data to hash of a
+ * request to the rfc4106 or the generic GCM, for the batch functions.
+ */
+static int gcmaes_batch_params(struct aead_request *req, bool rfc4106,
+			       u8 *iv, u8 **hash_subkey, void **aes_ctx)
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(req);
+	int assoclen;
+
+	if (rfc4106) {
+		struct aesni_rfc4106_gcm_ctx *ctx =
+			aesni_rfc4106_gcm_ctx_get(tfm);
+
+		if (unlikely(req->assoclen != 16 && req->assoclen != 20))
+			return -EINVAL;
+
+		memcpy(iv, ctx->nonce, 4);
+		memcpy(iv + 4, req->iv, 8);
+		*hash_subkey = ctx->hash_subkey;
+		*aes_ctx = &ctx->aes_key_expanded;
+		assoclen = req->assoclen - 8;
+	} else {
+		struct generic_gcmaes_ctx *ctx = generic_gcmaes_ctx_get(tfm);
+
+		memcpy(iv, req->iv, 12);
+		*hash_subkey = ctx->hash_subkey;
+		*aes_ctx = &ctx->aes_key_expanded;
+		assoclen = req->assoclen;
+	}
+	*((__be32 *)(iv + 12)) = cpu_to_be32(1);
+
+	return assoclen;
+}
+
+/*
+ * One request with linear buffers, see gcm_find_linear(), in the SIMD
+ * context the caller entered.  Returns -EAGAIN for the others.
+ */
+static int gcmaes_crypt_linear(bool enc, struct aead_request *req,
+			       unsigned int assoclen, u8 *hash_subkey,
+			       u8 *iv, void *aes_ctx)
+{
+	u8 databuf[sizeof(struct gcm_context_data) + (AESNI_ALIGN - 8)] __aligned(8);
+	struct gcm_context_data *data = PTR_ALIGN((void *)databuf, AESNI_ALIGN);
+	struct crypto_aead *tfm = crypto_aead_reqtfm(req);
+	unsigned long auth_tag_len = crypto_aead_authsize(tfm);
+	unsigned long len = req->cryptlen - (enc ? 0 : auth_tag_len);
+	u8 *assoc, *src, *dst, *unused;
+	u8 auth_tag[16];
+
+	if (!gcm_find_linear(req->src, req->assoclen, req->cryptlen,
+			     &assoc, &src) ||
+	    !gcm_find_linear(req->dst, req->assoclen,
+			     len + (enc ? auth_tag_len : 0), &unused, &dst))
+		return -EAGAIN;
+
+	if (static_branch_likely(&gcm_use_avx2) && len >= AVX_GEN4_OPTSIZE) {
+		aesni_gcm_init_avx_gen4(aes_ctx, data, iv, hash_subkey, assoc,
+					assoclen);
+		if (enc)
+			aesni_gcm_enc_update_avx_gen4(aes_ctx, data, dst, src,
+						      len);
+		else
+			aesni_gcm_dec_update_avx_gen4(aes_ctx, data, dst, src,
+						      len);
+		aesni_gcm_finalize_avx_gen4(aes_ctx, data, auth_tag,
+					    auth_tag_len);
+	} else if (static_branch_likely(&gcm_use_avx) &&
+		   len >= AVX_GEN2_OPTSIZE) {
+		aesni_gcm_init_avx_gen2(aes_ctx, data, iv, hash_subkey, assoc,
+					assoclen);
+		if (enc)
+			aesni_gcm_enc_update_avx_gen2(aes_ctx, data, dst, src,
+						      len);
+		else
+			aesni_gcm_dec_update_avx_gen2(aes_ctx, data, dst, src,
+						      len);
+		aesni_gcm_finalize_avx_gen2(aes_ctx, data, auth_tag,
+					    auth_tag_len);
+	} else {
+		aesni_gcm_init(aes_ctx, data, iv, hash_subkey, assoc, assoclen);
+		if (len && enc)
+			aesni_gcm_enc_update(aes_ctx, data, dst, src, len);
+		else if (len)
+			aesni_gcm_dec_update(aes_ctx, data, dst, src, len);
+		aesni_gcm_finalize(aes_ctx, data, auth_tag, auth_tag_len);
+	}
+
+	if (enc) {
+		memcpy(dst + len, auth_tag, auth_tag_len);
+		return 0;
+	}
+
+	if (crypto_memneq(src + len, auth_tag, auth_tag_len)) {
+		memzero_explicit(auth_tag, sizeof(auth_tag));
+		return -EBADMSG;
+	}
+	return 0;
+}
+
+/*
+ * The requests with linear buffers are processed back to back in one SIMD
+ * context section, up to GCM_BATCH_FPU_BYTES at a time; the others take
+ * the scatterlist walking path of single requests.
+ */
+static void gcmaes_crypt_batch(struct aead_request **reqs, int *errs,
+			       unsigned int nreqs, bool rfc4106, bool enc)
+{
+	u8 ivbuf[16 + (AESNI_ALIGN - 8)] __aligned(8);
+	u8 *iv = PTR_ALIGN(&ivbuf[0], AESNI_ALIGN);
+	unsigned int i, fpu_bytes = 0;
+	bool in_fpu = false;
+	u8 *hash_subkey;
+	void *aes_ctx;
+	int assoclen;
+
+	for (i = 0; i < nreqs; i++) {
+		struct aead_request *req = reqs[i];
+
+		assoclen = gcmaes_batch_params(req, rfc4106, iv, &hash_subkey,
+					       &aes_ctx);
+		if (assoclen < 0) {
+			errs[i] = assoclen;
+			continue;
+		}
+
+		if (in_fpu && fpu_bytes >= GCM_BATCH_FPU_BYTES) {
+			kernel_fpu_end();
+			in_fpu = false;
+		}
+		if (!in_fpu) {
+			kernel_fpu_begin();
+			in_fpu = true;
+			fpu_bytes = 0;
+		}
+
+		errs[i] = gcmaes_crypt_linear(enc, req, assoclen, hash_subkey,
+					      iv, aes_ctx);
+		if (errs[i] != -EAGAIN) {
+			fpu_bytes += req->assoclen + req->cryptlen;
+			continue;
+		}
+
+		kernel_fpu_end();
+		in_fpu = false;
+		if (enc)
+			errs[i] = gcmaes_encrypt(req, assoclen, hash_subkey, iv,
+						 aes_ctx);
+		else
+			errs[i] = gcmaes_decrypt(req, assoclen, hash_subkey, iv,
+						 aes_ctx);
+	}
+
+	if (in_fpu)
+		kernel_fpu_end();
+}
+
+static void helper_rfc4106_encrypt_batch(struct aead_request **reqs,
+					 int *errs, unsigned int nreqs)
+{
+	gcmaes_crypt_batch(reqs, errs, nreqs, true, true);
+}
+
+static void helper_rfc4106_decrypt_batch(struct aead_request **reqs,
+					 int *errs, unsigned int nreqs)
+{
+	gcmaes_crypt_batch(reqs, errs, nreqs, true, false);
+}
+
+static void generic_gcmaes_encrypt_batch(struct aead_request **reqs,
+					 int *errs, unsigned int nreqs)
+{
+	gcmaes_crypt_batch(reqs, errs, nreqs, false, true);
+}
+
+static void generic_gcmaes_decrypt_batch(struct aead_request **reqs,
+					 int *errs, unsigned int nreqs)
+{
+	gcmaes_crypt_batch(reqs, errs, nreqs, false, false);
+}
+
 static struct aead_alg aesni_aeads[] = { {
 	.setkey			= common_rfc4106_set_key,
 	.setauthsize		= common_rfc4106_set_authsize,
 	.encrypt		= helper_rfc4106_encrypt,
 	.decrypt		= helper_rfc4106_decrypt,
+	.encrypt_batch		= helper_rfc4106_encrypt_batch,
+	.decrypt_batch		= helper_rfc4106_decrypt_batch,
 	.ivsize			= GCM_RFC4106_IV_SIZE,
 	.maxauthsize		= 16,
 	.base = {
@@ -1115,6 +1321,8 @@ static struct aead_alg aesni_aeads[] = { {
 	.setauthsize		= generic_gcmaes_set_authsize,
 	.encrypt		= generic_gcmaes_encrypt,
 	.decrypt		= generic_gcmaes_decrypt,
+	.encrypt_batch		= generic_gcmaes_encrypt_batch,
+	.decrypt_batch		= generic_gcmaes_decrypt_batch,
 	.ivsize			= GCM_AES_IV_SIZE,
 	.maxauthsize		= 16,
 	.base = {
@@ -1134,6 +1342,562 @@ static struct aead_alg aesni_aeads[0];
 
 static struct simd_aead_alg *aesni_simd_aeads[ARRAY_SIZE(aesni_aeads)];
 
+#ifdef CONFIG_AS_VAES_AVX512
+/*
+ * VAES/AVX-512 versions of XTS and GCM, working on four blocks per zmm
+ * register.  The assembly code finds the GHASH key powers right after the
+ * expanded AES key, see OFFSETOF_H_POWERS in aesni-intel_vaes-avx512.S.
+ */
+struct aes_gcm_vaes_ctx {
+	struct crypto_aes_ctx aes_key AESNI_ALIGN_ATTR;
+	/* H^16 down to H^1, byte-reflected and multiplied by x */
+	u8 h_powers[16][AES_BLOCK_SIZE];
+	u8 nonce[4];
+};
+
+#define GCM_VAES_CTX_SIZE (sizeof(struct aes_gcm_vaes_ctx) + AESNI_ALIGN_EXTRA)
+
+asmlinkage void aes_xts_encrypt_vaes_avx512(const struct crypto_aes_ctx *ctx,
+					    u8 *out, const u8 *in,
+					    unsigned int len, u8 *iv);
+asmlinkage void aes_xts_decrypt_vaes_avx512(const struct crypto_aes_ctx *ctx,
+					    u8 *out, const u8 *in,
+					    unsigned int len, u8 *iv);
+
+asmlinkage void aes_gcm_aad_update_vaes_avx512(const struct aes_gcm_vaes_ctx *key,
+					       u8 ghash_acc[16], const u8 *aad,
+					       int aadlen);
+asmlinkage void aes_gcm_enc_update_vaes_avx512(const struct aes_gcm_vaes_ctx *key,
+					       const u32 le_ctr[4], u8 ghash_acc[16],
+					       const u8 *src, u8 *dst, int datalen);
+asmlinkage void aes_gcm_dec_update_vaes_avx512(const struct aes_gcm_vaes_ctx *key,
+					       const u32 le_ctr[4], u8 ghash_acc[16],
+					       const u8 *src, u8 *dst, int datalen);
+asmlinkage void aes_gcm_final_vaes_avx512(const struct aes_gcm_vaes_ctx *key,
+					  const u32 le_ctr[4], u8 ghash_acc[16],
+					  u64 total_aadlen, u64 total_datalen);
+
+/*
+ * The VAES code only takes whole 64-byte chunks.  What is left, including
+ * the last full block and partial block of ciphertext stealing, goes to
+ * the AES-NI code, which continues from the tweak written back to iv.
+ */
+static __always_inline void
+xts_crypt_vaes_avx512(const struct crypto_aes_ctx *ctx, u8 *out, const u8 *in,
+		      unsigned int len, u8 *iv, xts_crypt_func vaes_func,
+		      xts_crypt_func aesni_func)
+{
+	unsigned int tail = len % AES_BLOCK_SIZE;
+	unsigned int bulk = len;
+
+	if (tail)
+		bulk -= AES_BLOCK_SIZE + tail;
+	bulk = round_down(bulk, 4 * AES_BLOCK_SIZE);
+
+	if (bulk)
+		vaes_func(ctx, out, in, bulk, iv);
+	if (len > bulk)
+		aesni_func(ctx, out + bulk, in + bulk, len - bulk, iv);
+}
+
+static void xts_enc_vaes_avx512(const struct crypto_aes_ctx *ctx, u8 *out,
+				const u8 *in, unsigned int len, u8 *iv)
+{
+	xts_crypt_vaes_avx512(ctx, out, in, len, iv,
+			      aes_xts_encrypt_vaes_avx512, aesni_xts_encrypt);
+}
+
+static void xts_dec_vaes_avx512(const struct crypto_aes_ctx *ctx, u8 *out,
+				const u8 *in, unsigned int len, u8 *iv)
+{
+	xts_crypt_vaes_avx512(ctx, out, in, len, iv,
+			      aes_xts_decrypt_vaes_avx512, aesni_xts_decrypt);
+}
+
+static int xts_encrypt_vaes_avx512(struct skcipher_request *req)
+{
+	return xts_crypt(req, xts_enc_vaes_avx512);
+}
+
+static int xts_decrypt_vaes_avx512(struct skcipher_request *req)
+{
+	return xts_crypt(req, xts_dec_vaes_avx512);
+}
+
+static inline struct
+aes_gcm_vaes_ctx *aes_gcm_vaes_ctx_get(struct crypto_aead *tfm)
+{
+	unsigned long align = AESNI_ALIGN;
+
+	if (align <= crypto_tfm_ctx_alignment())
+		align = 1;
+	return PTR_ALIGN(crypto_aead_ctx(tfm), align);
+}
+
+/*
+ * The key powers are computed without the FPU, so this works in any
+ * context.  They are converted to the representation of the assembly
+ * code: the 128-bit value with the bytes of the block in reverse order,
+ * multiplied by x modulo the reflected GHASH polynomial.
+ */
+static int gcm_setkey_vaes_avx512(struct crypto_aead *tfm, const u8 *key,
+				  unsigned int keylen, bool rfc4106)
+{
+	struct aes_gcm_vaes_ctx *ctx = aes_gcm_vaes_ctx_get(tfm);
+	be128 h = {}, p;
+	int i, err;
+
+	if (rfc4106) {
+		if (keylen < sizeof(ctx->nonce))
+			return -EINVAL;
+		keylen -= sizeof(ctx->nonce);
+		memcpy(ctx->nonce, key + keylen, sizeof(ctx->nonce));
+	}
+
+	err = aes_expandkey(&ctx->aes_key, key, keylen);
+	if (err)
+		return err;
+
+	aes_encrypt(&ctx->aes_key, (u8 *)&h, (u8 *)&h);
+	p = h;
+	for (i = ARRAY_SIZE(ctx->h_powers) - 1; i >= 0; i--) {
+		u64 hi = be64_to_cpu(p.a);
+		u64 lo = be64_to_cpu(p.b);
+		u64 carry = -(hi >> 63);
+
+		hi = (hi << 1) | (lo >> 63);
+		lo = (lo << 1) ^ (carry & 1);
+		hi ^= carry & 0xc200000000000000ULL;
+		put_unaligned_le64(lo, &ctx->h_powers[i][0]);
+		put_unaligned_le64(hi, &ctx->h_powers[i][8]);
+
+		gf128mul_lle(&p, &h);
+	}
+
+	memzero_explicit(&h, sizeof(h));
+	memzero_explicit(&p, sizeof(p));
+	return 0;
+}
+
+static int gcm_setkey_generic_vaes_avx512(struct crypto_aead *tfm,
+					  const u8 *key, unsigned int keylen)
+{
+	return gcm_setkey_vaes_avx512(tfm, key, keylen, false);
+}
+
+static int gcm_setkey_rfc4106_vaes_avx512(struct crypto_aead *tfm,
+					  const u8 *key, unsigned int keylen)
+{
+	return gcm_setkey_vaes_avx512(tfm, key, keylen, true);
+}
+
+/* the counter block of the first data block, as 128-bit value */
+static inline void gcm_init_le_ctr_vaes_avx512(u32 le_ctr[4], const u8 *iv)
+{
+	le_ctr[0] = 2;
+	le_ctr[1] = get_unaligned_be32(iv + 8);
+	le_ctr[2] = get_unaligned_be32(iv + 4);
+	le_ctr[3] = get_unaligned_be32(iv);
+}
+
+static int gcm_crypt_vaes_avx512(struct aead_request *req, const u8 *iv,
+				 unsigned int assoclen, bool enc)
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(req);
+	const struct aes_gcm_vaes_ctx *ctx = aes_gcm_vaes_ctx_get(tfm);
+	unsigned int authsize = crypto_aead_authsize(tfm);
+	unsigned int datalen = req->cryptlen - (enc ? 0 : authsize);
+	u8 ghash_acc[AES_BLOCK_SIZE] = {};
+	u8 auth_tag[AES_BLOCK_SIZE];
+	struct scatter_walk assoc_sg_walk;
+	struct skcipher_walk walk;
+	u8 *assocmem = NULL;
+	u32 le_ctr[4];
+	u8 *assoc;
+	int err;
+
+	gcm_init_le_ctr_vaes_avx512(le_ctr, iv);
+
+	/* Linearize assoc, if not already linear */
+	if (req->src->length >= assoclen && req->src->length) {
+		scatterwalk_start(&assoc_sg_walk, req->src);
+		assoc = scatterwalk_map(&assoc_sg_walk);
+	} else {
+		gfp_t flags = (req->base.flags & CRYPTO_TFM_REQ_MAY_SLEEP) ?
+			      GFP_KERNEL : GFP_ATOMIC;
+
+		assocmem = kmalloc(assoclen, flags);
+		if (unlikely(!assocmem))
+			return -ENOMEM;
+		assoc = assocmem;
+
+		scatterwalk_map_and_copy(assoc, req->src, 0, assoclen, 0);
+	}
+
+	if (assoclen) {
+		kernel_fpu_begin();
+		aes_gcm_aad_update_vaes_avx512(ctx, ghash_acc, assoc, assoclen);
+		kernel_fpu_end();
+	}
+
+	if (!assocmem)
+		scatterwalk_unmap(assoc);
+	else
+		kfree(assocmem);
+
+	err = enc ? skcipher_walk_aead_encrypt(&walk, req, false)
+		  : skcipher_walk_aead_decrypt(&walk, req, false);
+
+	while (walk.nbytes > 0) {
+		unsigned int nbytes = walk.nbytes;
+
+		/* only the last call may have a partial block */
+		if (nbytes < walk.total)
+			nbytes = round_down(nbytes, AES_BLOCK_SIZE);
+
+		kernel_fpu_begin();
+		if (enc)
+			aes_gcm_enc_update_vaes_avx512(ctx, le_ctr, ghash_acc,
+						       walk.src.virt.addr,
+						       walk.dst.virt.addr,
+						       nbytes);
+		else
+			aes_gcm_dec_update_vaes_avx512(ctx, le_ctr, ghash_acc,
+						       walk.src.virt.addr,
+						       walk.dst.virt.addr,
+						       nbytes);
+		kernel_fpu_end();
+
+		le_ctr[0] += nbytes / AES_BLOCK_SIZE;
+		err = skcipher_walk_done(&walk, walk.nbytes - nbytes);
+	}
+
+	if (err)
+		return err;
+
+	le_ctr[0] = 1;
+	kernel_fpu_begin();
+	aes_gcm_final_vaes_avx512(ctx, le_ctr, ghash_acc, assoclen, datalen);
+	kernel_fpu_end();
+
+	if (enc) {
+		scatterwalk_map_and_copy(ghash_acc, req->dst,
+					 req->assoclen + req->cryptlen,
+					 authsize, 1);
+		return 0;
+	}
+
+	scatterwalk_map_and_copy(auth_tag, req->src, req->assoclen + datalen,
+				 authsize, 0);
+	if (crypto_memneq(auth_tag, ghash_acc, authsize)) {
+		memzero_explicit(ghash_acc, sizeof(ghash_acc));
+		return -EBADMSG;
+	}
+	return 0;
+}
+
+static int gcm_encrypt_generic_vaes_avx512(struct aead_request *req)
+{
+	return gcm_crypt_vaes_avx512(req, req->iv, req->assoclen, true);
+}
+
+static int gcm_decrypt_generic_vaes_avx512(struct aead_request *req)
+{
+	return gcm_crypt_vaes_avx512(req, req->iv, req->assoclen, false);
+}
+
+/*
+ * Build the GCM IV of an RFC4106 request.  The 8-byte IV at the end of the
+ * associated data is not hashed, the length to hash is returned.
+ */
+static int rfc4106_iv_vaes_avx512(struct aead_request *req,
+				  u8 iv[GCM_AES_IV_SIZE])
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(req);
+	const struct aes_gcm_vaes_ctx *ctx = aes_gcm_vaes_ctx_get(tfm);
+
+	if (unlikely(req->assoclen != 16 && req->assoclen != 20))
+		return -EINVAL;
+
+	memcpy(iv, ctx->nonce, sizeof(ctx->nonce));
+	memcpy(iv + sizeof(ctx->nonce), req->iv, GCM_RFC4106_IV_SIZE);
+
+	return req->assoclen - GCM_RFC4106_IV_SIZE;
+}
+
+static int gcm_crypt_rfc4106_vaes_avx512(struct aead_request *req, bool enc)
+{
+	u8 iv[GCM_AES_IV_SIZE];
+	int assoclen;
+
+	assoclen = rfc4106_iv_vaes_avx512(req, iv);
+	if (assoclen < 0)
+		return assoclen;
+
+	return gcm_crypt_vaes_avx512(req, iv, assoclen, enc);
+}
+
+static int gcm_encrypt_rfc4106_vaes_avx512(struct aead_request *req)
+{
+	return gcm_crypt_rfc4106_vaes_avx512(req, true);
+}
+
+static int gcm_decrypt_rfc4106_vaes_avx512(struct aead_request *req)
+{
+	return gcm_crypt_rfc4106_vaes_avx512(req, false);
+}
+
+/*
+ * One request with linear buffers, see gcm_find_linear(), in the SIMD
+ * context the caller entered.  Returns -EAGAIN for the others.
+ */
+static int gcm_crypt_linear_vaes_avx512(struct aead_request *req,
+					const u8 *iv, unsigned int assoclen,
+					bool enc)
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(req);
+	const struct aes_gcm_vaes_ctx *ctx = aes_gcm_vaes_ctx_get(tfm);
+	unsigned int authsize = crypto_aead_authsize(tfm);
+	unsigned int datalen = req->cryptlen - (enc ? 0 : authsize);
+	u8 ghash_acc[AES_BLOCK_SIZE] = {};
+	u8 *assoc, *src, *dst, *unused;
+	u32 le_ctr[4];
+
+	if (!gcm_find_linear(req->src, req->assoclen, req->cryptlen,
+			     &assoc, &src) ||
+	    !gcm_find_linear(req->dst, req->assoclen,
+			     datalen + (enc ? authsize : 0), &unused, &dst))
+		return -EAGAIN;
+
+	gcm_init_le_ctr_vaes_avx512(le_ctr, iv);
+
+	if (assoclen)
+		aes_gcm_aad_update_vaes_avx512(ctx, ghash_acc, assoc, assoclen);
+	if (enc)
+		aes_gcm_enc_update_vaes_avx512(ctx, le_ctr, ghash_acc, src, dst,
+					       datalen);
+	else
+		aes_gcm_dec_update_vaes_avx512(ctx, le_ctr, ghash_acc, src, dst,
+					       datalen);
+
+	le_ctr[0] = 1;
+	aes_gcm_final_vaes_avx512(ctx, le_ctr, ghash_acc, assoclen, datalen);
+
+	if (enc) {
+		memcpy(dst + datalen, ghash_acc, authsize);
+		return 0;
+	}
+
+	if (crypto_memneq(src + datalen, ghash_acc, authsize)) {
+		memzero_explicit(ghash_acc, sizeof(ghash_acc));
+		return -EBADMSG;
+	}
+	return 0;
+}
+
+/*
+ * The requests with linear buffers are processed back to back in one SIMD
+ * context section, up to GCM_BATCH_FPU_BYTES at a time; the others take
+ * the scatterlist walking path of single requests.
+ */
+static void gcm_crypt_batch_vaes_avx512(struct aead_request **reqs, int *errs,
+					unsigned int nreqs, bool rfc4106,
+					bool enc)
+{
+	unsigned int i, fpu_bytes = 0;
+	bool in_fpu = false;
+
+	for (i = 0; i < nreqs; i++) {
+		struct aead_request *req = reqs[i];
+		u8 ivbuf[GCM_AES_IV_SIZE];
+		const u8 *iv = req->iv;
+		int assoclen = req->assoclen;
+
+		if (rfc4106) {
+			assoclen = rfc4106_iv_vaes_avx512(req, ivbuf);
+			if (assoclen < 0) {
+				errs[i] = assoclen;
+				continue;
+			}
+			iv = ivbuf;
+		}
+
+		if (in_fpu && fpu_bytes >= GCM_BATCH_FPU_BYTES) {
+			kernel_fpu_end();
+			in_fpu = false;
+		}
+		if (!in_fpu) {
+			kernel_fpu_begin();
+			in_fpu = true;
+			fpu_bytes = 0;
+		}
+
+		errs[i] = gcm_crypt_linear_vaes_avx512(req, iv, assoclen, enc);
+		if (errs[i] != -EAGAIN) {
+			fpu_bytes += req->assoclen + req->cryptlen;
+			continue;
+		}
+
+		kernel_fpu_end();
+		in_fpu = false;
+		errs[i] = gcm_crypt_vaes_avx512(req, iv, assoclen, enc);
+	}
+
+	if (in_fpu)
+		kernel_fpu_end();
+}
+
+static void gcm_encrypt_batch_generic_vaes_avx512(struct aead_request **reqs,
+						  int *errs, unsigned int nreqs)
+{
+	gcm_crypt_batch_vaes_avx512(reqs, errs, nreqs, false, true);
+}
+
+static void gcm_decrypt_batch_generic_vaes_avx512(struct aead_request **reqs,
+						  int *errs, unsigned int nreqs)
+{
+	gcm_crypt_batch_vaes_avx512(reqs, errs, nreqs, false, false);
+}
+
+static void gcm_encrypt_batch_rfc4106_vaes_avx512(struct aead_request **reqs,
+						  int *errs, unsigned int nreqs)
+{
+	gcm_crypt_batch_vaes_avx512(reqs, errs, nreqs, true, true);
+}
+
+static void gcm_decrypt_batch_rfc4106_vaes_avx512(struct aead_request **reqs,
+						  int *errs, unsigned int nreqs)
+{
+	gcm_crypt_batch_vaes_avx512(reqs, errs, nreqs, true, false);
+}
+
+static struct skcipher_alg aes_vaes_avx512_skciphers[] = {
+	{
+		.base = {
+			.cra_name		= "__xts(aes)",
+			.cra_driver_name	= "__xts-aes-vaes-avx512",
+			.cra_priority		= 800,
+			.cra_flags		= CRYPTO_ALG_INTERNAL,
+			.cra_blocksize		= AES_BLOCK_SIZE,
+			.cra_ctxsize		= XTS_AES_CTX_SIZE,
+			.cra_module		= THIS_MODULE,
+		},
+		.min_keysize	= 2 * AES_MIN_KEY_SIZE,
+		.max_keysize	= 2 * AES_MAX_KEY_SIZE,
+		.ivsize		= AES_BLOCK_SIZE,
+		.walksize	= 2 * AES_BLOCK_SIZE,
+		.setkey		= xts_aesni_setkey,
+		.encrypt	= xts_encrypt_vaes_avx512,
+		.decrypt	= xts_decrypt_vaes_avx512,
+	}
+};
+
+static struct simd_skcipher_alg *
+aes_vaes_avx512_simd_skciphers[ARRAY_SIZE(aes_vaes_avx512_skciphers)];
+
+static struct aead_alg aes_vaes_avx512_aeads[] = { {
+	.setkey			= gcm_setkey_rfc4106_vaes_avx512,
+	.setauthsize		= common_rfc4106_set_authsize,
+	.encrypt		= gcm_encrypt_rfc4106_vaes_avx512,
+	.decrypt		= gcm_decrypt_rfc4106_vaes_avx512,
+	.encrypt_batch		= gcm_encrypt_batch_rfc4106_vaes_avx512,
+	.decrypt_batch		= gcm_decrypt_batch_rfc4106_vaes_avx512,
+	.ivsize			= GCM_RFC4106_IV_SIZE,
+	.chunksize		= AES_BLOCK_SIZE,
+	.maxauthsize		= 16,
+	.base = {
+		.cra_name		= "__rfc4106(gcm(aes))",
+		.cra_driver_name	= "__rfc4106-gcm-vaes-avx512",
+		.cra_priority		= 800,
+		.cra_flags		= CRYPTO_ALG_INTERNAL,
+		.cra_blocksize		= 1,
+		.cra_ctxsize		= GCM_VAES_CTX_SIZE,
+		.cra_alignmask		= 0,
+		.cra_module		= THIS_MODULE,
+	},
+}, {
+	.setkey			= gcm_setkey_generic_vaes_avx512,
+	.setauthsize		= generic_gcmaes_set_authsize,
+	.encrypt		= gcm_encrypt_generic_vaes_avx512,
+	.decrypt		= gcm_decrypt_generic_vaes_avx512,
+	.encrypt_batch		= gcm_encrypt_batch_generic_vaes_avx512,
+	.decrypt_batch		= gcm_decrypt_batch_generic_vaes_avx512,
+	.ivsize			= GCM_AES_IV_SIZE,
+	.chunksize		= AES_BLOCK_SIZE,
+	.maxauthsize		= 16,
+	.base = {
+		.cra_name		= "__gcm(aes)",
+		.cra_driver_name	= "__generic-gcm-vaes-avx512",
+		.cra_priority		= 800,
+		.cra_flags		= CRYPTO_ALG_INTERNAL,
+		.cra_blocksize		= 1,
+		.cra_ctxsize		= GCM_VAES_CTX_SIZE,
+		.cra_alignmask		= 0,
+		.cra_module		= THIS_MODULE,
+	},
+} };
+
+static struct simd_aead_alg *
+aes_vaes_avx512_simd_aeads[ARRAY_SIZE(aes_vaes_avx512_aeads)];
+
+static int __init register_vaes_avx512_algs(void)
+{
+	int err;
+
+	BUILD_BUG_ON(offsetof(struct aes_gcm_vaes_ctx, h_powers) != 484);
+
+	if (!boot_cpu_has(X86_FEATURE_VAES) ||
+	    !boot_cpu_has(X86_FEATURE_VPCLMULQDQ) ||
+	    !boot_cpu_has(X86_FEATURE_AVX512F) ||
+	    !boot_cpu_has(X86_FEATURE_AVX512BW) ||	/* kmovq */
+	    !boot_cpu_has(X86_FEATURE_AVX512VL) ||
+	    !boot_cpu_has(X86_FEATURE_BMI2) ||
+	    !cpu_has_xfeatures(XFEATURE_MASK_SSE | XFEATURE_MASK_YMM |
+			       XFEATURE_MASK_AVX512, NULL))
+		return 0;
+
+	pr_info("VAES/AVX-512 versions of xts and gcm engaged.\n");
+
+	err = simd_register_skciphers_compat(aes_vaes_avx512_skciphers,
+					     ARRAY_SIZE(aes_vaes_avx512_skciphers),
+					     aes_vaes_avx512_simd_skciphers);
+	if (err)
+		return err;
+
+	err = simd_register_aeads_compat(aes_vaes_avx512_aeads,
+					 ARRAY_SIZE(aes_vaes_avx512_aeads),
+					 aes_vaes_avx512_simd_aeads);
+	if (err)
+		simd_unregister_skciphers(aes_vaes_avx512_skciphers,
+					  ARRAY_SIZE(aes_vaes_avx512_skciphers),
+					  aes_vaes_avx512_simd_skciphers);
+	return err;
+}
+
+static void unregister_vaes_avx512_algs(void)
+{
+	/* nothing was registered if the CPU lacks the features */
+	if (!aes_vaes_avx512_simd_skciphers[0])
+		return;
+
+	simd_unregister_aeads(aes_vaes_avx512_aeads,
+			      ARRAY_SIZE(aes_vaes_avx512_aeads),
+			      aes_vaes_avx512_simd_aeads);
+	simd_unregister_skciphers(aes_vaes_avx512_skciphers,
+				  ARRAY_SIZE(aes_vaes_avx512_skciphers),
+				  aes_vaes_avx512_simd_skciphers);
+}
+#else
+static inline int register_vaes_avx512_algs(void)
+{
+	return 0;
+}
+
+static inline void unregister_vaes_avx512_algs(void)
+{
+}
+#endif /* CONFIG_AS_VAES_AVX512 */
+
 static const struct x86_cpu_id aesni_cpu_id[] = {
 	X86_MATCH_FEATURE(X86_FEATURE_AES, NULL),
 	{}
@@ -1180,8 +1944,15 @@ static int __init aesni_init(void)
 	if (err)
 		goto unregister_skciphers;
 
+	err = register_vaes_avx512_algs();
+	if (err)
+		goto unregister_aeads;
+
 	return 0;
 
+unregister_aeads:
+	simd_unregister_aeads(aesni_aeads, ARRAY_SIZE(aesni_aeads),
+			      aesni_simd_aeads);
 unregister_skciphers:
 	simd_unregister_skciphers(aesni_skciphers, ARRAY_SIZE(aesni_skciphers),
 				  aesni_simd_skciphers);
@@ -1192,6 +1963,7 @@ static int __init aesni_init(void)
 
 static void __exit aesni_exit(void)
 {
+	unregister_vaes_avx512_algs();
 	simd_unregister_aeads(aesni_aeads, ARRAY_SIZE(aesni_aeads),
 			      aesni_simd_aeads);
 	simd_unregister_skciphers(aesni_skciphers, ARRAY_SIZE(aesni_skciphers),
@@ -129,8 +129,10 @@ static inline __sum16 csum_tcpudp_magic(__be32 saddr, __be32 daddr,
  */
 extern __wsum csum_partial(const void *buff, int len, __wsum sum);
 
-/* Do not call this directly. Use the wrappers below */
+/* Do not call these directly. Use the wrappers below */
 extern __visible __wsum csum_partial_copy_generic(const void *src, void *dst, int len);
+extern int csum_partial_copy_avx2_blocks(const void *src, void *dst, int len,
+					 __wsum *sum);
 
 extern __wsum csum_and_copy_from_user(const void __user *src, void *dst, int len);
 extern __wsum csum_and_copy_to_user(const void *src, void __user *dst, int len);
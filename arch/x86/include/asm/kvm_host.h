@@ -1041,6 +1041,7 @@ struct kvm_x86_msr_filter {
 #define APICV_INHIBIT_REASON_IRQWIN     3
 #define APICV_INHIBIT_REASON_PIT_REINJ  4
 #define APICV_INHIBIT_REASON_X2APIC	5
+#define APICV_INHIBIT_REASON_APIC_ID_MODIFIED 6
 
 struct kvm_arch {
 	unsigned long n_used_mmu_pages;
@@ -1204,6 +1205,15 @@ struct kvm_arch {
 	 * the thread holds the MMU lock in write mode.
 	 */
 	spinlock_t tdp_mmu_pages_lock;
+
+	/*
+	 * Page table pages for eagerly splitting huge pages when dirty logging
+	 * is enabled.  They are topped up with the MMU lock dropped, so that
+	 * the splitting itself never has to allocate, and are protected by
+	 * slots_lock.
+	 */
+	struct kvm_mmu_memory_cache split_page_header_cache;
+	struct kvm_mmu_memory_cache split_shadow_page_cache;
 #endif /* CONFIG_X86_64 */
 
 	/*
@@ -1528,6 +1538,7 @@ extern u32 __read_mostly kvm_nr_uret_msrs;
 extern u64 __read_mostly host_efer;
 extern bool __read_mostly allow_smaller_maxphyaddr;
 extern bool __read_mostly enable_apicv;
+extern bool __read_mostly eager_page_split;
 extern struct kvm_x86_ops kvm_x86_ops;
 
 #define KVM_X86_OP(func) \
@@ -1578,6 +1589,9 @@ void kvm_mmu_slot_remove_write_access(struct kvm *kvm,
 				      int start_level);
 void kvm_mmu_zap_collapsible_sptes(struct kvm *kvm,
 				   const struct kvm_memory_slot *memslot);
+void kvm_mmu_slot_try_split_huge_pages(struct kvm *kvm,
+				       const struct kvm_memory_slot *memslot,
+				       int target_level);
 void kvm_mmu_slot_leaf_clear_dirty(struct kvm *kvm,
 				   const struct kvm_memory_slot *memslot);
 void kvm_mmu_zap_all(struct kvm *kvm);
@@ -46,15 +46,104 @@ copy_user_generic(void *to, const void *from, unsigned len)
 	return ret;
 }
 
+/*
+ * A copy of constant size 1, 2, 4 or 8 is a single move, which either
+ * faults or copies everything.  Doing it inline saves the call and the
+ * size checks in copy_user_*(), these are common for structure fields.
+ */
+#define __copy_user_const_size(size)					\
+	(__builtin_constant_p(size) &&					\
+	 ((size) == 1 || (size) == 2 || (size) == 4 || (size) == 8))
+
+#ifdef CONFIG_CC_HAS_ASM_GOTO_OUTPUT
+static __always_inline __must_check unsigned long
+__copy_from_user_const(void *dst, const void __user *src, unsigned long size)
+{
+	__uaccess_begin();
+	switch (size) {
+	case 1:
+		__get_user_size(*(u8 *)dst, (const u8 __user *)src, 1, Efault);
+		break;
+	case 2:
+		__get_user_size(*(u16 *)dst, (const u16 __user *)src, 2, Efault);
+		break;
+	case 4:
+		__get_user_size(*(u32 *)dst, (const u32 __user *)src, 4, Efault);
+		break;
+	case 8:
+		__get_user_size(*(u64 *)dst, (const u64 __user *)src, 8, Efault);
+		break;
+	}
+	__uaccess_end();
+	return 0;
+Efault:
+	__uaccess_end();
+	return size;
+}
+#else
+static __always_inline __must_check unsigned long
+__copy_from_user_const(void *dst, const void __user *src, unsigned long size)
+{
+	int err = 0;
+
+	__uaccess_begin();
+	switch (size) {
+	case 1:
+		__get_user_size(*(u8 *)dst, (const u8 __user *)src, 1, err);
+		break;
+	case 2:
+		__get_user_size(*(u16 *)dst, (const u16 __user *)src, 2, err);
+		break;
+	case 4:
+		__get_user_size(*(u32 *)dst, (const u32 __user *)src, 4, err);
+		break;
+	case 8:
+		__get_user_size(*(u64 *)dst, (const u64 __user *)src, 8, err);
+		break;
+	}
+	__uaccess_end();
+	return err ? size : 0;
+}
+#endif
+
+static __always_inline __must_check unsigned long
+__copy_to_user_const(void __user *dst, const void *src, unsigned long size)
+{
+	__uaccess_begin();
+	switch (size) {
+	case 1:
+		__put_user_size(*(const u8 *)src, (u8 __user *)dst, 1, Efault);
+		break;
+	case 2:
+		__put_user_size(*(const u16 *)src, (u16 __user *)dst, 2, Efault);
+		break;
+	case 4:
+		__put_user_size(*(const u32 *)src, (u32 __user *)dst, 4, Efault);
+		break;
+	case 8:
+		__put_user_size(*(const u64 *)src, (u64 __user *)dst, 8, Efault);
+		break;
+	}
+	__uaccess_end();
+	return 0;
+Efault:
+	__uaccess_end();
+	return size;
+}
+
 static __always_inline __must_check unsigned long
 raw_copy_from_user(void *dst, const void __user *src, unsigned long size)
 {
+	if (__copy_user_const_size(size))
+		return __copy_from_user_const(dst, src, size);
 	return copy_user_generic(dst, (__force void *)src, size);
 }
 
 static __always_inline __must_check unsigned long
 raw_copy_to_user(void __user *dst, const void *src, unsigned long size)
 {
+	if (__copy_user_const_size(size))
+		return __copy_to_user_const(dst, src, size);
 	return copy_user_generic((__force void *)dst, src, size);
 }
 
@@ -73,6 +162,16 @@ __copy_from_user_inatomic_nocache(void *dst, const void __user *src,
 	return __copy_user_nocache(dst, src, size, 0);
 }
 
+static inline int
+__copy_to_user_inatomic_nocache(void __user *dst, const void *src,
+				unsigned size)
+{
+	kasan_check_read(src, size);
+	return __copy_user_nocache((__force void *)dst,
+				   (__force const void __user *)src, size, 0);
+}
+#define __copy_to_user_inatomic_nocache __copy_to_user_inatomic_nocache
+
 static inline int
 __copy_from_user_flushcache(void *dst, const void __user *src, unsigned size)
 {
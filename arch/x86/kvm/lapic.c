@@ -312,6 +312,21 @@ static inline void kvm_apic_set_xapic_id(struct kvm_lapic *apic, u8 id)
 	atomic_set_release(&apic->vcpu->kvm->arch.apic_map_dirty, DIRTY);
 }
 
+/*
+ * The PID table used by IPI virtualization is indexed by the destination
+ * APIC ID, which is only the vCPU ID as long as the guest leaves the xAPIC
+ * ID alone.  Fall back to emulated IPIs, for good, once it doesn't.
+ */
+static void kvm_lapic_xapic_id_updated(struct kvm_lapic *apic)
+{
+	struct kvm *kvm = apic->vcpu->kvm;
+
+	if (kvm_xapic_id(apic) == apic->vcpu->vcpu_id)
+		return;
+
+	kvm_request_apicv_update(kvm, false, APICV_INHIBIT_REASON_APIC_ID_MODIFIED);
+}
+
 static inline void kvm_apic_set_ldr(struct kvm_lapic *apic, u32 id)
 {
 	kvm_lapic_set_reg(apic, APIC_LDR, id);
@@ -2008,10 +2023,12 @@ int kvm_lapic_reg_write(struct kvm_lapic *apic, u32 reg, u32 val)
 
 	switch (reg) {
 	case APIC_ID:		/* Local APIC ID */
-		if (!apic_x2apic_mode(apic))
+		if (!apic_x2apic_mode(apic)) {
 			kvm_apic_set_xapic_id(apic, val >> 24);
-		else
+			kvm_lapic_xapic_id_updated(apic);
+		} else {
 			ret = 1;
+		}
 		break;
 
 	case APIC_TASKPRI:
@@ -2190,15 +2207,25 @@ EXPORT_SYMBOL_GPL(kvm_lapic_set_eoi);
 /* emulate APIC access in a trap manner */
 void kvm_apic_write_nodecode(struct kvm_vcpu *vcpu, u32 offset)
 {
+	struct kvm_lapic *apic = vcpu->arch.apic;
 	u32 val = 0;
 
 	/* hw has done the conditional check and inst decode */
 	offset &= 0xff0;
 
-	kvm_lapic_reg_read(vcpu->arch.apic, offset, 4, &val);
+	/*
+	 * With IPI virtualization, x2APIC ICR writes that the CPU could not
+	 * deliver by itself trap here, with the whole 64-bit value written.
+	 */
+	if (apic_x2apic_mode(apic) && offset == APIC_ICR) {
+		kvm_x2apic_icr_write(apic, kvm_lapic_get_reg64(apic, APIC_ICR));
+		return;
+	}
+
+	kvm_lapic_reg_read(apic, offset, 4, &val);
 
 	/* TODO: optimize to just emulate side effect w/o one more write */
-	kvm_lapic_reg_write(vcpu->arch.apic, offset, val);
+	kvm_lapic_reg_write(apic, offset, val);
 }
 EXPORT_SYMBOL_GPL(kvm_apic_write_nodecode);
 
@@ -2359,7 +2386,7 @@ void kvm_lapic_reset(struct kvm_vcpu *vcpu, bool init_event)
 	if (!apic_x2apic_mode(apic))
 		kvm_apic_set_ldr(apic, 0);
 	kvm_lapic_set_reg(apic, APIC_ESR, 0);
-	kvm_lapic_set_reg(apic, APIC_ICR, 0);
+	kvm_lapic_set_reg64(apic, APIC_ICR, 0);
 	kvm_lapic_set_reg(apic, APIC_ICR2, 0);
 	kvm_lapic_set_reg(apic, APIC_TDCR, 0);
 	kvm_lapic_set_reg(apic, APIC_TMICT, 0);
@@ -2595,6 +2622,19 @@ static int kvm_apic_state_fixup(struct kvm_vcpu *vcpu,
 		/* In x2APIC mode, the LDR is fixed and based on the id */
 		if (set)
 			*ldr = kvm_apic_calc_x2apic_ldr(*id);
+
+		/*
+		 * KVM keeps the x2APIC ICR as one 64-bit register, userspace
+		 * still sees the destination in ICR2 like in xAPIC mode.
+		 */
+		if (set) {
+			__kvm_lapic_set_reg(s->regs, APIC_ICR + 4,
+					    __kvm_lapic_get_reg(s->regs, APIC_ICR2));
+		} else {
+			__kvm_lapic_set_reg(s->regs, APIC_ICR2,
+					    __kvm_lapic_get_reg(s->regs, APIC_ICR + 4));
+			__kvm_lapic_set_reg(s->regs, APIC_ICR + 4, 0);
+		}
 	}
 
 	return 0;
@@ -2632,6 +2672,8 @@ int kvm_apic_set_state(struct kvm_vcpu *vcpu, struct kvm_lapic_state *s)
 
 	atomic_set_release(&apic->vcpu->kvm->arch.apic_map_dirty, DIRTY);
 	kvm_recalculate_apic_map(vcpu->kvm);
+	if (!apic_x2apic_mode(apic))
+		kvm_lapic_xapic_id_updated(apic);
 	kvm_apic_set_version(vcpu);
 
 	apic_update_ppr(apic);
@@ -2792,6 +2834,24 @@ int kvm_lapic_set_vapic_addr(struct kvm_vcpu *vcpu, gpa_t vapic_addr)
 	return 0;
 }
 
+/*
+ * In x2APIC mode the ICR is a single 64-bit register, stored as such at
+ * APIC_ICR so that it matches what IPI virtualization writes.  APIC_ICR2
+ * is kept in sync for the code that sends IPIs through the xAPIC layout.
+ */
+int kvm_x2apic_icr_write(struct kvm_lapic *apic, u64 data)
+{
+	/* No delay here, so we always clear the pending bit */
+	data &= ~APIC_ICR_BUSY;
+
+	kvm_apic_send_ipi(apic, (u32)data, (u32)(data >> 32));
+	kvm_lapic_set_reg64(apic, APIC_ICR, data);
+	kvm_lapic_set_reg(apic, APIC_ICR2, (u32)(data >> 32));
+	trace_kvm_apic_write(APIC_ICR, data);
+	return 0;
+}
+EXPORT_SYMBOL_GPL(kvm_x2apic_icr_write);
+
 int kvm_x2apic_msr_write(struct kvm_vcpu *vcpu, u32 msr, u64 data)
 {
 	struct kvm_lapic *apic = vcpu->arch.apic;
@@ -2803,11 +2863,11 @@ int kvm_x2apic_msr_write(struct kvm_vcpu *vcpu, u32 msr, u64 data)
 	if (reg == APIC_ICR2)
 		return 1;
 
-	/* if this is ICR write vector before command */
 	if (reg == APIC_ICR)
-		kvm_lapic_reg_write(apic, APIC_ICR2, (u32)(data >> 32));
-	else if (data >> 32)
-		/* Bits 63:32 are reserved in all other registers. */
+		return kvm_x2apic_icr_write(apic, data);
+
+	/* Bits 63:32 are reserved in all other registers. */
+	if (data >> 32)
 		return 1;
 
 	return kvm_lapic_reg_write(apic, reg, (u32)data);
@@ -2816,7 +2876,7 @@ int kvm_x2apic_msr_write(struct kvm_vcpu *vcpu, u32 msr, u64 data)
 int kvm_x2apic_msr_read(struct kvm_vcpu *vcpu, u32 msr, u64 *data)
 {
 	struct kvm_lapic *apic = vcpu->arch.apic;
-	u32 reg = (msr - APIC_BASE_MSR) << 4, low, high = 0;
+	u32 reg = (msr - APIC_BASE_MSR) << 4, low;
 
 	if (!lapic_in_kernel(vcpu) || !apic_x2apic_mode(apic))
 		return 1;
@@ -2824,12 +2884,15 @@ int kvm_x2apic_msr_read(struct kvm_vcpu *vcpu, u32 msr, u64 *data)
 	if (reg == APIC_DFR || reg == APIC_ICR2)
 		return 1;
 
+	if (reg == APIC_ICR) {
+		*data = kvm_lapic_get_reg64(apic, APIC_ICR);
+		return 0;
+	}
+
 	if (kvm_lapic_reg_read(apic, reg, 4, &low))
 		return 1;
-	if (reg == APIC_ICR)
-		kvm_lapic_reg_read(apic, APIC_ICR2, 4, &high);
 
-	*data = (((u64)high) << 32) | low;
+	*data = low;
 
 	return 0;
 }
@@ -2841,6 +2904,9 @@ int kvm_hv_vapic_msr_write(struct kvm_vcpu *vcpu, u32 reg, u64 data)
 	if (!lapic_in_kernel(vcpu))
 		return 1;
 
+	if (reg == APIC_ICR && apic_x2apic_mode(apic))
+		return kvm_x2apic_icr_write(apic, data);
+
 	/* if this is ICR write vector before command */
 	if (reg == APIC_ICR)
 		kvm_lapic_reg_write(apic, APIC_ICR2, (u32)(data >> 32));
@@ -2859,6 +2925,11 @@ int kvm_hv_vapic_msr_read(struct kvm_vcpu *vcpu, u32 reg, u64 *data)
 	if (!lapic_in_kernel(vcpu))
 		return 1;
 
+	if (reg == APIC_ICR && apic_x2apic_mode(apic)) {
+		*data = kvm_lapic_get_reg64(apic, APIC_ICR);
+		return 0;
+	}
+
 	if (kvm_lapic_reg_read(apic, reg, 4, &low))
 		return 1;
 	if (reg == APIC_ICR)
@@ -87,6 +87,9 @@ __MODULE_PARM_TYPE(nx_huge_pages_recovery_ratio, "uint");
 static bool __read_mostly force_flush_and_sync_on_reuse;
 module_param_named(flush_on_reuse, force_flush_and_sync_on_reuse, bool, 0644);
 
+bool __read_mostly eager_page_split = true;
+module_param(eager_page_split, bool, 0644);
+
 /*
  * When setting this variable to true it enables Two-Dimensional-Paging
  * where the hardware walks 2 page tables:
@@ -3940,6 +3943,23 @@ static bool kvm_faultin_pfn(struct kvm_vcpu *vcpu, bool prefault, gfn_t gfn,
 		}
 	}
 
+	/*
+	 * Userspace populates the memory of these slots itself, e.g. while
+	 * it is still being migrated, so never sleep on a page that is not
+	 * mapped in yet and let the VMM install it instead.
+	 */
+	if (slot && (slot->flags & KVM_MEM_EXIT_ON_MISSING)) {
+		*pfn = gfn_to_pfn_memslot_nofault(slot, gfn, write, writable,
+						  hva);
+		if (*pfn != KVM_PFN_ERR_FAULT)
+			return false;
+
+		kvm_prepare_memory_fault_exit(vcpu, gfn_to_gpa(gfn), PAGE_SIZE,
+					      write);
+		*r = -EFAULT;
+		return true;
+	}
+
 	async = false;
 	*pfn = __gfn_to_pfn_memslot(slot, gfn, false, &async,
 				    write, writable, hva);
@@ -5785,6 +5805,30 @@ static bool slot_rmap_write_protect(struct kvm *kvm,
 	return __rmap_write_protect(kvm, rmap_head, false);
 }
 
+/*
+ * Split the huge pages mapped by the TDP MMU in the slot down to target_level
+ * before dirty logging starts, so that the vCPUs do not have to take write
+ * protection faults on huge pages and split them one by one, each time
+ * stalling on the allocation of a new page table.  No TLB flush is needed
+ * here, the write-protection or dirty bit clearing that follows flushes.
+ */
+void kvm_mmu_slot_try_split_huge_pages(struct kvm *kvm,
+				       const struct kvm_memory_slot *memslot,
+				       int target_level)
+{
+	u64 start = memslot->base_gfn;
+	u64 end = start + memslot->npages;
+
+	if (!is_tdp_mmu_enabled(kvm))
+		return;
+
+	read_lock(&kvm->mmu_lock);
+	kvm_tdp_mmu_try_split_huge_pages(kvm, memslot, start, end, target_level);
+	read_unlock(&kvm->mmu_lock);
+
+	kvm_tdp_mmu_free_split_caches(kvm);
+}
+
 void kvm_mmu_slot_remove_write_access(struct kvm *kvm,
 				      const struct kvm_memory_slot *memslot,
 				      int start_level)
@@ -183,6 +183,52 @@ int make_spte(struct kvm_vcpu *vcpu, unsigned int pte_access, int level,
 	return ret;
 }
 
+/*
+ * Construct an SPTE that maps a sub-page of the given huge page SPTE where
+ * `index` identifies which sub-page.
+ *
+ * This is used during huge page splitting to build the SPTEs that make up the
+ * new page table.
+ */
+u64 make_huge_page_split_spte(u64 huge_spte, int huge_level, int index)
+{
+	u64 child_spte;
+	int child_level;
+
+	if (WARN_ON_ONCE(!is_shadow_present_pte(huge_spte)))
+		return 0;
+
+	if (WARN_ON_ONCE(!is_large_pte(huge_spte)))
+		return 0;
+
+	child_spte = huge_spte;
+	child_level = huge_level - 1;
+
+	/*
+	 * The child_spte already has the base address of the huge page being
+	 * split. So we just have to OR in the offset to the page at the next
+	 * lower level for the given index.
+	 */
+	child_spte |= (index * KVM_PAGES_PER_HPAGE(child_level)) << PAGE_SHIFT;
+
+	if (child_level == PG_LEVEL_4K) {
+		child_spte &= ~PT_PAGE_SIZE_MASK;
+
+		/*
+		 * When splitting to a 4K page, the NX hugepage mitigation no
+		 * longer applies and the page can be made executable again.
+		 * Leave access-tracked SPTEs alone, an exec fault will fix
+		 * them up.
+		 */
+		if (is_nx_huge_page_enabled() && !is_access_track_spte(child_spte)) {
+			child_spte &= ~shadow_nx_mask;
+			child_spte |= shadow_x_mask;
+		}
+	}
+
+	return child_spte;
+}
+
 u64 make_nonleaf_spte(u64 *child_pt, bool ad_disabled)
 {
 	u64 spte = SPTE_MMU_PRESENT_MASK;
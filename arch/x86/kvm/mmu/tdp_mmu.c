@@ -25,6 +25,10 @@ bool kvm_mmu_init_tdp_mmu(struct kvm *kvm)
 	INIT_LIST_HEAD(&kvm->arch.tdp_mmu_roots);
 	spin_lock_init(&kvm->arch.tdp_mmu_pages_lock);
 
+	kvm->arch.split_page_header_cache.kmem_cache = mmu_page_header_cache;
+	kvm->arch.split_page_header_cache.gfp_zero = __GFP_ZERO;
+	kvm->arch.split_shadow_page_cache.gfp_zero = __GFP_ZERO;
+
 	return true;
 }
 
@@ -45,6 +49,9 @@ void kvm_mmu_uninit_tdp_mmu(struct kvm *kvm)
 	WARN_ON(atomic64_read(&kvm->arch.tdp_mmu_pages));
 	WARN_ON(!list_empty(&kvm->arch.tdp_mmu_roots));
 
+	kvm_mmu_free_memory_cache(&kvm->arch.split_page_header_cache);
+	kvm_mmu_free_memory_cache(&kvm->arch.split_shadow_page_cache);
+
 	/*
 	 * Ensure that all the outstanding RCU callbacks to free shadow pages
 	 * can run before the VM is torn down.
@@ -1292,6 +1299,208 @@ bool kvm_tdp_mmu_wrprot_slot(struct kvm *kvm,
 	return spte_set;
 }
 
+static bool tdp_mmu_need_topup_split_caches(struct kvm *kvm)
+{
+	return !kvm_mmu_memory_cache_nr_free_objects(&kvm->arch.split_page_header_cache) ||
+	       !kvm_mmu_memory_cache_nr_free_objects(&kvm->arch.split_shadow_page_cache);
+}
+
+/*
+ * Refill the split caches with the MMU lock dropped, so that the page tables
+ * can be allocated with reclaim allowed, without blocking the vCPUs faulting
+ * in parallel.  The caller must restart the walk, as after any other yield.
+ */
+static int tdp_mmu_topup_split_caches(struct kvm *kvm, struct tdp_iter *iter)
+{
+	int r;
+
+	rcu_read_unlock();
+	read_unlock(&kvm->mmu_lock);
+
+	iter->yielded = true;
+
+	r = kvm_mmu_topup_memory_cache(&kvm->arch.split_page_header_cache, 1);
+	if (!r)
+		r = kvm_mmu_topup_memory_cache(&kvm->arch.split_shadow_page_cache, 1);
+
+	read_lock(&kvm->mmu_lock);
+	rcu_read_lock();
+
+	return r;
+}
+
+static struct kvm_mmu_page *tdp_mmu_alloc_sp_for_split(struct kvm *kvm)
+{
+	struct kvm_mmu_page *sp;
+
+	sp = kvm_mmu_memory_cache_alloc(&kvm->arch.split_page_header_cache);
+	sp->spt = kvm_mmu_memory_cache_alloc(&kvm->arch.split_shadow_page_cache);
+	set_page_private(virt_to_page(sp->spt), (unsigned long)sp);
+
+	return sp;
+}
+
+/*
+ * Replace the huge SPTE the iterator is on with a page table mapping the same
+ * memory one level down.  Returns false if the SPTE changed under us, in
+ * which case @sp is left unused.
+ */
+static bool tdp_mmu_split_huge_page(struct kvm *kvm, struct tdp_iter *iter,
+				    struct kvm_mmu_page *sp)
+{
+	struct kvm_mmu_page *parent_sp = sptep_to_sp(rcu_dereference(iter->sptep));
+	const u64 huge_spte = iter->old_spte;
+	const int level = iter->level;
+	u64 new_spte;
+	int i;
+
+	sp->role = parent_sp->role;
+	sp->role.level--;
+	sp->gfn = iter->gfn;
+	sp->tdp_mmu_page = true;
+
+	/*
+	 * No need for atomics when writing to sp->spt since the page table has
+	 * not been linked in yet and thus is not reachable from any other CPU.
+	 */
+	for (i = 0; i < PT64_ENT_PER_PAGE; i++)
+		sp->spt[i] = make_huge_page_split_spte(huge_spte, level, i);
+
+	/*
+	 * Replace the huge SPTE with a pointer to the populated lower level
+	 * page table.  Since this is done without a TLB flush, vCPUs will see
+	 * a mix of the split mappings and the original huge mapping, depending
+	 * on what's currently in their TLB.  This is fine from a correctness
+	 * standpoint since the translation will be the same either way.
+	 */
+	new_spte = make_nonleaf_spte(sp->spt, !shadow_accessed_mask);
+	if (!tdp_mmu_set_spte_atomic_no_dirty_log(kvm, iter, new_spte)) {
+		trace_kvm_mmu_split_huge_page(iter->gfn, huge_spte, level, -EBUSY);
+		return false;
+	}
+
+	tdp_mmu_link_page(kvm, sp, false);
+	trace_kvm_mmu_get_page(sp, true);
+
+	/*
+	 * Setting the SPTE subtracted the huge page from the page stats, but
+	 * the new child SPTEs have to be accounted manually.
+	 */
+	kvm_update_page_stats(kvm, level - 1, PT64_ENT_PER_PAGE);
+
+	trace_kvm_mmu_split_huge_page(iter->gfn, huge_spte, level, 0);
+	return true;
+}
+
+static int tdp_mmu_split_huge_pages_root(struct kvm *kvm,
+					 struct kvm_mmu_page *root,
+					 gfn_t start, gfn_t end,
+					 int target_level)
+{
+	struct kvm_mmu_page *sp = NULL;
+	struct tdp_iter iter;
+	int ret = 0;
+
+	rcu_read_lock();
+
+	/*
+	 * Traverse the page table splitting all huge pages above the target
+	 * level into one lower level.  For example, if we encounter a 1GB page
+	 * we split it into 512 2MB pages.
+	 *
+	 * Since the TDP iterator uses a pre-order traversal, we are guaranteed
+	 * to visit an SPTE before ever visiting its children, which means we
+	 * will correctly recursively split huge pages that are more than one
+	 * level above the target level (e.g. splitting a 1GB to 512 2MB pages,
+	 * and then splitting each of those to 512 4KB pages).
+	 */
+	for_each_tdp_pte_min_level(iter, root->spt, root->role.level,
+				   target_level + 1, start, end) {
+retry:
+		if (tdp_mmu_iter_cond_resched(kvm, &iter, false, true))
+			continue;
+
+		if (!is_shadow_present_pte(iter.old_spte) ||
+		    !is_large_pte(iter.old_spte))
+			continue;
+
+		if (!sp) {
+			if (tdp_mmu_need_topup_split_caches(kvm)) {
+				ret = tdp_mmu_topup_split_caches(kvm, &iter);
+				if (ret) {
+					trace_kvm_mmu_split_huge_page(iter.gfn,
+								      iter.old_spte,
+								      iter.level, ret);
+					break;
+				}
+				continue;
+			}
+
+			sp = tdp_mmu_alloc_sp_for_split(kvm);
+		}
+
+		if (!tdp_mmu_split_huge_page(kvm, &iter, sp)) {
+			/*
+			 * The iter must explicitly re-read the SPTE because
+			 * the atomic cmpxchg failed.  The page table is kept
+			 * for the next attempt.
+			 */
+			iter.old_spte = READ_ONCE(*rcu_dereference(iter.sptep));
+			goto retry;
+		}
+
+		sp = NULL;
+	}
+
+	rcu_read_unlock();
+
+	/*
+	 * It's possible to exit the loop having never used the last sp if, for
+	 * example, a vCPU doing NX huge page splitting wins the race and
+	 * installs its own sp in place of the last sp we tried to split.
+	 */
+	if (sp)
+		tdp_mmu_free_sp(sp);
+
+	return ret;
+}
+
+/*
+ * Split all the huge pages mapping GFNs [start, end) down to target_level,
+ * under the MMU lock held for read so that the vCPUs keep faulting in
+ * parallel.  The page tables come from the per-VM split caches, which are
+ * emptied again once done.  Splitting is best effort: whatever is left
+ * because of an allocation failure is split on the next write fault.
+ */
+void kvm_tdp_mmu_try_split_huge_pages(struct kvm *kvm,
+				      const struct kvm_memory_slot *slot,
+				      gfn_t start, gfn_t end,
+				      int target_level)
+{
+	struct kvm_mmu_page *root;
+	int r = 0;
+
+	lockdep_assert_held(&kvm->slots_lock);
+	lockdep_assert_held_read(&kvm->mmu_lock);
+
+	for_each_valid_tdp_mmu_root_yield_safe(kvm, root, slot->as_id, true) {
+		r = tdp_mmu_split_huge_pages_root(kvm, root, start, end,
+						  target_level);
+		if (r) {
+			kvm_tdp_mmu_put_root(kvm, root, true);
+			break;
+		}
+	}
+}
+
+void kvm_tdp_mmu_free_split_caches(struct kvm *kvm)
+{
+	lockdep_assert_held(&kvm->slots_lock);
+
+	kvm_mmu_free_memory_cache(&kvm->arch.split_page_header_cache);
+	kvm_mmu_free_memory_cache(&kvm->arch.split_shadow_page_cache);
+}
+
 /*
  * Clear the dirty status of all the SPTEs mapping GFNs in the memslot. If
  * AD bits are enabled, this will involve clearing the dirty bit on each SPTE.
@@ -85,11 +85,21 @@ static bool vmx_can_use_vtd_pi(struct kvm *kvm)
 		irq_remapping_cap(IRQ_POSTING_CAP);
 }
 
+/*
+ * IPI virtualization posts interrupts to the PID of the destination vCPU
+ * behind KVM's back, so blocked vCPUs need the wakeup vector armed even
+ * when there is no assigned device.
+ */
+static bool vmx_needs_pi_wakeup(struct kvm_vcpu *vcpu)
+{
+	return vmx_can_use_ipiv(vcpu) || vmx_can_use_vtd_pi(vcpu->kvm);
+}
+
 void vmx_vcpu_pi_put(struct kvm_vcpu *vcpu)
 {
 	struct pi_desc *pi_desc = vcpu_to_pi_desc(vcpu);
 
-	if (!vmx_can_use_vtd_pi(vcpu->kvm))
+	if (!vmx_needs_pi_wakeup(vcpu))
 		return;
 
 	/* Set SN when the vCPU is preempted */
@@ -147,7 +157,7 @@ int pi_pre_block(struct kvm_vcpu *vcpu)
 	struct pi_desc old, new;
 	struct pi_desc *pi_desc = vcpu_to_pi_desc(vcpu);
 
-	if (!vmx_can_use_vtd_pi(vcpu->kvm) ||
+	if (!vmx_needs_pi_wakeup(vcpu) ||
 	    vmx_interrupt_blocked(vcpu))
 		return 0;
 
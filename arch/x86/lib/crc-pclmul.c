@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * CRC library functions using PCLMULQDQ and the SSE4.2 CRC32 instruction
+ *
+ * The generic crc32_le(), __crc32c_le(), crc32_be(), crc_t10dif_update()
+ * and crc64_be() are weak, the versions here replace them when the
+ * respective library is built in.  Buffers of 64 bytes and more are
+ * folded with carryless multiplications, see crc-pclmul_64.S, and the
+ * generic code does the rest.  __crc32c_le() uses the CRC32 instruction
+ * below that and when the FPU is not usable.
+ */
+
+#include <linux/crc32.h>
+#include <linux/crc64.h>
+#include <linux/crc-t10dif.h>
+#include <linux/init.h>
+#include <linux/jump_label.h>
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <asm/cpufeature.h>
+#include <asm/fpu/api.h>
+#include <asm/simd.h>
+#include <asm/unaligned.h>
+
+/* below this, saving the FPU state costs more than the folding saves */
+#define CRC_PCLMUL_MIN_LEN	64
+
+/* the zmm code needs 256 bytes and is faster from there on */
+#define CRC_VPCLMUL_MIN_LEN	256
+
+/*
+ * Multipliers for folding a 128-bit block across 2048, 512 and 128 bits,
+ * [0] for the low and [1] for the high 64 bits of the block.  The layout
+ * is known to crc-pclmul_64.S.
+ */
+struct crc_pclmul_consts {
+	u64 fold_across_2048[2];
+	u64 fold_across_512[2];
+	u64 fold_across_128[2];
+};
+
+asmlinkage void crc_fold_lsb_pclmul(const struct crc_pclmul_consts *consts,
+				    u64 crc, const u8 *p, size_t len, u8 *out);
+asmlinkage void crc_fold_msb_pclmul(const struct crc_pclmul_consts *consts,
+				    u64 crc, const u8 *p, size_t len, u8 *out);
+asmlinkage void
+crc_fold_lsb_vpclmul_avx512(const struct crc_pclmul_consts *consts, u64 crc,
+			    const u8 *p, size_t len, u8 *out);
+asmlinkage void
+crc_fold_msb_vpclmul_avx512(const struct crc_pclmul_consts *consts, u64 crc,
+			    const u8 *p, size_t len, u8 *out);
+
+static DEFINE_STATIC_KEY_FALSE(crc_use_pclmul);
+static DEFINE_STATIC_KEY_FALSE(crc_use_vpclmul_avx512);
+
+static __always_inline bool crc_pclmul_usable(size_t len)
+{
+	return len >= CRC_PCLMUL_MIN_LEN &&
+	       static_branch_likely(&crc_use_pclmul) && may_use_simd();
+}
+
+/*
+ * Fold the whole 16-byte blocks at the start of @p into @out, which then
+ * has the same remainder with a zero initial CRC.  @crc is aligned to bit
+ * 63 for the msb-first CRCs.  Returns the number of bytes consumed.
+ */
+static size_t crc_fold(const struct crc_pclmul_consts *consts, u64 crc,
+		       const u8 *p, size_t len, bool msb, u8 out[16])
+{
+	len = round_down(len, 16);
+
+	kernel_fpu_begin();
+	if (IS_ENABLED(CONFIG_AS_VPCLMULQDQ) && len >= CRC_VPCLMUL_MIN_LEN &&
+	    static_branch_likely(&crc_use_vpclmul_avx512)) {
+		if (msb)
+			crc_fold_msb_vpclmul_avx512(consts, crc, p, len, out);
+		else
+			crc_fold_lsb_vpclmul_avx512(consts, crc, p, len, out);
+	} else {
+		if (msb)
+			crc_fold_msb_pclmul(consts, crc, p, len, out);
+		else
+			crc_fold_lsb_pclmul(consts, crc, p, len, out);
+	}
+	kernel_fpu_end();
+
+	return len;
+}
+
+#if IS_BUILTIN(CONFIG_CRC32)
+static struct crc_pclmul_consts crc32_le_consts __ro_after_init;
+static struct crc_pclmul_consts crc32c_le_consts __ro_after_init;
+static struct crc_pclmul_consts crc32_be_consts __ro_after_init;
+static DEFINE_STATIC_KEY_FALSE(crc_use_crc32_insn);
+
+static u32 crc32c_insn(u32 crc, const u8 *p, size_t len)
+{
+	unsigned long crcl = crc;
+
+	for (; len >= 8; len -= 8, p += 8)
+		asm("crc32q %1, %0" : "+r" (crcl) : "rm" (get_unaligned((const u64 *)p)));
+	crc = crcl;
+	for (; len; len--, p++)
+		asm("crc32b %1, %0" : "+r" (crc) : "rm" (*p));
+
+	return crc;
+}
+
+static u32 crc32c_nofold(u32 crc, const u8 *p, size_t len)
+{
+	if (static_branch_likely(&crc_use_crc32_insn))
+		return crc32c_insn(crc, p, len);
+	return __crc32c_le_base(crc, p, len);
+}
+
+u32 __pure crc32_le(u32 crc, unsigned char const *p, size_t len)
+{
+	u8 folded[16];
+	size_t n;
+
+	if (!crc_pclmul_usable(len))
+		return crc32_le_base(crc, p, len);
+
+	n = crc_fold(&crc32_le_consts, crc, p, len, false, folded);
+	crc = crc32_le_base(0, folded, sizeof(folded));
+	return crc32_le_base(crc, p + n, len - n);
+}
+
+u32 __pure __crc32c_le(u32 crc, unsigned char const *p, size_t len)
+{
+	u8 folded[16];
+	size_t n;
+
+	if (!crc_pclmul_usable(len))
+		return crc32c_nofold(crc, p, len);
+
+	n = crc_fold(&crc32c_le_consts, crc, p, len, false, folded);
+	crc = crc32c_nofold(0, folded, sizeof(folded));
+	return crc32c_nofold(crc, p + n, len - n);
+}
+
+u32 __pure crc32_be(u32 crc, unsigned char const *p, size_t len)
+{
+	u8 folded[16];
+	size_t n;
+
+	if (!crc_pclmul_usable(len))
+		return crc32_be_base(crc, p, len);
+
+	n = crc_fold(&crc32_be_consts, (u64)crc << 32, p, len, true, folded);
+	crc = crc32_be_base(0, folded, sizeof(folded));
+	return crc32_be_base(crc, p + n, len - n);
+}
+#endif /* CONFIG_CRC32 */
+
+#if IS_BUILTIN(CONFIG_CRC_T10DIF)
+static struct crc_pclmul_consts crc_t10dif_consts __ro_after_init;
+
+__u16 crc_t10dif_update(__u16 crc, const unsigned char *p, size_t len)
+{
+	u8 folded[16];
+	size_t n;
+
+	if (!crc_pclmul_usable(len))
+		return crc_t10dif_update_base(crc, p, len);
+
+	n = crc_fold(&crc_t10dif_consts, (u64)crc << 48, p, len, true, folded);
+	crc = crc_t10dif_generic(0, folded, sizeof(folded));
+	return crc_t10dif_generic(crc, p + n, len - n);
+}
+#endif /* CONFIG_CRC_T10DIF */
+
+#if IS_BUILTIN(CONFIG_CRC64)
+static struct crc_pclmul_consts crc64_be_consts __ro_after_init;
+
+u64 __pure crc64_be(u64 crc, const void *p, size_t len)
+{
+	u8 folded[16];
+	size_t n;
+
+	if (!crc_pclmul_usable(len))
+		return crc64_be_base(crc, p, len);
+
+	n = crc_fold(&crc64_be_consts, crc, p, len, true, folded);
+	crc = crc64_be_base(0, folded, sizeof(folded));
+	return crc64_be_base(crc, p + n, len - n);
+}
+#endif /* CONFIG_CRC64 */
+
+/* x^@e modulo the @bits-bit polynomial @poly, whose x^@bits is implied */
+static u64 __init crc_xpow_mod(unsigned int e, u64 poly, unsigned int bits)
+{
+	u64 top = 1ULL << (bits - 1);
+	u64 mask = top | (top - 1);
+	u64 r = 1;
+
+	while (e--) {
+		bool carry = r & top;
+
+		r = (r << 1) & mask;
+		if (carry)
+			r ^= poly;
+	}
+
+	return r;
+}
+
+static u64 __init crc_bitrev64(u64 x)
+{
+	return (u64)bitrev32(x) << 32 | bitrev32(x >> 32);
+}
+
+static void __init crc_fold_consts(u64 k[2], unsigned int dist, u64 poly,
+				   unsigned int bits, bool msb)
+{
+	if (msb) {
+		k[0] = crc_xpow_mod(dist, poly, bits);
+		k[1] = crc_xpow_mod(dist + 64, poly, bits);
+	} else {
+		/*
+		 * The low half holds the high powers here.  Multiplying
+		 * reflected values yields the product shifted by one, which
+		 * the lower power makes up for.
+		 */
+		k[0] = crc_bitrev64(crc_xpow_mod(dist + 63, poly, bits));
+		k[1] = crc_bitrev64(crc_xpow_mod(dist - 1, poly, bits));
+	}
+}
+
+/* @poly is in msb-first order, also for the bit-reflected CRCs */
+static void __maybe_unused __init
+crc_pclmul_consts_init(struct crc_pclmul_consts *consts, u64 poly,
+		       unsigned int bits, bool msb)
+{
+	crc_fold_consts(consts->fold_across_2048, 2048, poly, bits, msb);
+	crc_fold_consts(consts->fold_across_512, 512, poly, bits, msb);
+	crc_fold_consts(consts->fold_across_128, 128, poly, bits, msb);
+}
+
+static int __init crc_pclmul_init(void)
+{
+#if IS_BUILTIN(CONFIG_CRC32)
+	if (boot_cpu_has(X86_FEATURE_XMM4_2))
+		static_branch_enable(&crc_use_crc32_insn);
+#endif
+
+	if (!boot_cpu_has(X86_FEATURE_PCLMULQDQ) ||
+	    !boot_cpu_has(X86_FEATURE_SSSE3) ||
+	    !cpu_has_xfeatures(XFEATURE_MASK_SSE, NULL))
+		return 0;
+
+#if IS_BUILTIN(CONFIG_CRC32)
+	crc_pclmul_consts_init(&crc32_le_consts, 0x04c11db7, 32, false);
+	crc_pclmul_consts_init(&crc32c_le_consts, 0x1edc6f41, 32, false);
+	crc_pclmul_consts_init(&crc32_be_consts, 0x04c11db7, 32, true);
+#endif
+#if IS_BUILTIN(CONFIG_CRC_T10DIF)
+	crc_pclmul_consts_init(&crc_t10dif_consts, 0x8bb7, 16, true);
+#endif
+#if IS_BUILTIN(CONFIG_CRC64)
+	crc_pclmul_consts_init(&crc64_be_consts, 0x42f0e1eba9ea3693ULL, 64,
+			       true);
+#endif
+	static_branch_enable(&crc_use_pclmul);
+
+	if (IS_ENABLED(CONFIG_AS_VPCLMULQDQ) &&
+	    boot_cpu_has(X86_FEATURE_VPCLMULQDQ) &&
+	    boot_cpu_has(X86_FEATURE_AVX512F) &&
+	    boot_cpu_has(X86_FEATURE_AVX512BW) &&	/* vpshufb */
+	    boot_cpu_has(X86_FEATURE_AVX512VL) &&	/* vpternlogq */
+	    cpu_has_xfeatures(XFEATURE_MASK_SSE | XFEATURE_MASK_YMM |
+			      XFEATURE_MASK_AVX512, NULL))
+		static_branch_enable(&crc_use_vpclmul_avx512);
+
+	return 0;
+}
+arch_initcall(crc_pclmul_init);
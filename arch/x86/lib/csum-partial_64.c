@@ -8,7 +8,37 @@
  
 #include <linux/compiler.h>
 #include <linux/export.h>
+#include <linux/init.h>
+#include <linux/jump_label.h>
+#include <linux/kernel.h>
+#include <linux/preempt.h>
+#include <linux/uaccess.h>
 #include <asm/checksum.h>
+#include <asm/cpufeature.h>
+#include <asm/fpu/api.h>
+#include <asm/simd.h>
+
+/* below this, saving the FPU state costs more than the vector loop saves */
+#define CSUM_AVX2_MIN_LEN	1024
+
+asmlinkage u64 csum_partial_avx2(const void *buff, unsigned long len);
+asmlinkage u64 csum_partial_copy_avx2(const void *src, void *dst,
+				      unsigned long len);
+
+static DEFINE_STATIC_KEY_FALSE(csum_use_avx2);
+
+/* netpoll can get here in NMI context, where may_use_simd() warns */
+static __always_inline bool csum_avx2_usable(int len)
+{
+	return len >= CSUM_AVX2_MIN_LEN &&
+	       static_branch_likely(&csum_use_avx2) && !in_nmi() &&
+	       may_use_simd();
+}
+
+static inline __wsum from64to32(u64 vsum)
+{
+	return (__force __wsum)add32_with_carry(vsum >> 32, vsum & 0xffffffff);
+}
 
 static inline unsigned short from32to16(unsigned a) 
 {
@@ -133,11 +163,57 @@ static unsigned do_csum(const unsigned char *buff, unsigned len)
  */
 __wsum csum_partial(const void *buff, int len, __wsum sum)
 {
-	return (__force __wsum)add32_with_carry(do_csum(buff, len),
+	int n = 0;
+
+	/* the blocks end at an even offset, so the sums just add up */
+	if (csum_avx2_usable(len)) {
+		u64 vsum;
+
+		n = round_down(len, 64);
+		kernel_fpu_begin();
+		vsum = csum_partial_avx2(buff, n);
+		kernel_fpu_end();
+		sum = csum_add(sum, from64to32(vsum));
+	}
+
+	return (__force __wsum)add32_with_carry(do_csum(buff + n, len - n),
 						(__force u32)sum);
 }
 EXPORT_SYMBOL(csum_partial);
 
+/*
+ * Copy and checksum the whole 64-byte blocks at the start of @src for
+ * csum_and_copy_from_user() and csum_partial_copy_nocheck(), which do the
+ * rest.  Returns the number of bytes done and adds their sum into @sum,
+ * or 0 if the vector code is not usable or reading @src faulted.  Page
+ * faults cannot be handled with the FPU in use, the fault handler could
+ * sleep and another task clobber the registers.  Without PREEMPT_COUNT
+ * the preempt_disable() in kernel_fpu_begin() does not tell the fault
+ * handler that, so page faults are disabled explicitly and the caller
+ * starts over without the FPU when one happens.
+ */
+int csum_partial_copy_avx2_blocks(const void *src, void *dst, int len,
+				  __wsum *sum)
+{
+	u64 vsum;
+	int n;
+
+	if (!csum_avx2_usable(len))
+		return 0;
+
+	n = round_down(len, 64);
+	kernel_fpu_begin();
+	pagefault_disable();
+	vsum = csum_partial_copy_avx2(src, dst, n);
+	pagefault_enable();
+	kernel_fpu_end();
+	if (vsum == -1ULL)
+		return 0;
+
+	*sum = csum_add(*sum, from64to32(vsum));
+	return n;
+}
+
 /*
  * this routine is used for miscellaneous IP-like checksums, mainly
  * in icmp.c
@@ -148,3 +224,11 @@ __sum16 ip_compute_csum(const void *buff, int len)
 }
 EXPORT_SYMBOL(ip_compute_csum);
 
+static int __init csum_avx2_init(void)
+{
+	if (boot_cpu_has(X86_FEATURE_AVX2) &&
+	    cpu_has_xfeatures(XFEATURE_MASK_SSE | XFEATURE_MASK_YMM, NULL))
+		static_branch_enable(&csum_use_avx2);
+	return 0;
+}
+arch_initcall(csum_avx2_init);
@@ -23,14 +23,21 @@
 __wsum
 csum_and_copy_from_user(const void __user *src, void *dst, int len)
 {
-	__wsum sum;
+	__wsum sum, vsum = 0;
+	int n;
 
 	might_sleep();
-	if (!user_access_begin(src, len))
+	if (!access_ok(src, len))
 		return 0;
-	sum = csum_partial_copy_generic((__force const void *)src, dst, len);
+	/* user_access_begin() split up, the vector code does its own STAC */
+	barrier_nospec();
+	n = csum_partial_copy_avx2_blocks((__force const void *)src, dst, len,
+					  &vsum);
+	__uaccess_begin();
+	sum = csum_partial_copy_generic((__force const void *)src + n, dst + n,
+					len - n);
 	user_access_end();
-	return sum;
+	return sum ? csum_add(sum, vsum) : 0;
 }
 EXPORT_SYMBOL(csum_and_copy_from_user);
 
@@ -71,7 +78,12 @@ EXPORT_SYMBOL(csum_and_copy_to_user);
 __wsum
 csum_partial_copy_nocheck(const void *src, void *dst, int len)
 {
-	return csum_partial_copy_generic(src, dst, len);
+	__wsum vsum = 0;
+	int n;
+
+	n = csum_partial_copy_avx2_blocks(src, dst, len, &vsum);
+	return csum_add(csum_partial_copy_generic(src + n, dst + n, len - n),
+			vsum);
 }
 EXPORT_SYMBOL(csum_partial_copy_nocheck);
 
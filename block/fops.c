@@ -91,7 +91,7 @@ static ssize_t __blkdev_direct_IO_simple(struct kiocb *iocb,
 
 	if (iov_iter_rw(iter) == READ) {
 		bio.bi_opf = REQ_OP_READ;
-		if (iter_is_iovec(iter))
+		if (user_backed_iter(iter))
 			should_dirty = true;
 	} else {
 		bio.bi_opf = dio_bio_write_op(iocb);
@@ -220,7 +220,7 @@ static ssize_t __blkdev_direct_IO(struct kiocb *iocb, struct iov_iter *iter,
 
 	dio->size = 0;
 	dio->multi_bio = false;
-	dio->should_dirty = is_read && iter_is_iovec(iter);
+	dio->should_dirty = is_read && user_backed_iter(iter);
 
 	/*
 	 * Don't plug for HIPRI/polled IO, as those should go straight
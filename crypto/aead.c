@@ -115,6 +115,119 @@ int crypto_aead_decrypt(struct aead_request *req)
 }
 EXPORT_SYMBOL_GPL(crypto_aead_decrypt);
 
+/* requests per batch call while their lengths are kept for the statistics */
+#define AEAD_BATCH_STATS_MAX	16
+
+/*
+ * Account the statistics of each request as crypto_aead_encrypt() and
+ * crypto_aead_decrypt() do.  A request may complete, and its memory go away,
+ * before batch() returns, so the lengths are saved beforehand.
+ */
+static void crypto_aead_do_batch(struct crypto_aead *aead,
+				 void (*batch)(struct aead_request **reqs,
+					       int *errs, unsigned int nreqs),
+				 struct aead_request **reqs, int *errs,
+				 unsigned int nreqs, bool enc)
+{
+	struct crypto_alg *alg = aead->base.__crt_alg;
+	unsigned int cryptlen[AEAD_BATCH_STATS_MAX];
+	unsigned int i, n;
+
+	if (!IS_ENABLED(CONFIG_CRYPTO_STATS)) {
+		batch(reqs, errs, nreqs);
+		return;
+	}
+
+	while (nreqs) {
+		n = min_t(unsigned int, nreqs, AEAD_BATCH_STATS_MAX);
+
+		for (i = 0; i < n; i++) {
+			cryptlen[i] = reqs[i]->cryptlen;
+			crypto_stats_get(alg);
+		}
+
+		batch(reqs, errs, n);
+
+		for (i = 0; i < n; i++) {
+			if (enc)
+				crypto_stats_aead_encrypt(cryptlen[i], alg,
+							  errs[i]);
+			else
+				crypto_stats_aead_decrypt(cryptlen[i], alg,
+							  errs[i]);
+		}
+
+		reqs += n;
+		errs += n;
+		nreqs -= n;
+	}
+}
+
+static int crypto_aead_crypt_batch(struct aead_request **reqs, int *errs,
+				   unsigned int nreqs, bool enc)
+{
+	struct crypto_aead *aead;
+	struct aead_alg *alg;
+	void (*batch)(struct aead_request **reqs, int *errs,
+		      unsigned int nreqs);
+	unsigned int i;
+	int ret = 0;
+
+	if (!nreqs)
+		return 0;
+
+	aead = crypto_aead_reqtfm(reqs[0]);
+	alg = crypto_aead_alg(aead);
+	batch = enc ? alg->encrypt_batch : alg->decrypt_batch;
+
+	for (i = 1; i < nreqs; i++) {
+		if (WARN_ON_ONCE(crypto_aead_reqtfm(reqs[i]) != aead)) {
+			for (i = 0; i < nreqs; i++)
+				errs[i] = -EINVAL;
+			return -EINVAL;
+		}
+	}
+
+	/*
+	 * The checks of the single request functions apply to the whole
+	 * batch, go through them when any request fails one.
+	 */
+	if (crypto_aead_get_flags(aead) & CRYPTO_TFM_NEED_KEY)
+		batch = NULL;
+	for (i = 0; i < nreqs && batch && !enc; i++) {
+		if (reqs[i]->cryptlen < crypto_aead_authsize(aead))
+			batch = NULL;
+	}
+
+	if (batch) {
+		crypto_aead_do_batch(aead, batch, reqs, errs, nreqs, enc);
+	} else {
+		for (i = 0; i < nreqs; i++)
+			errs[i] = enc ? crypto_aead_encrypt(reqs[i]) :
+					crypto_aead_decrypt(reqs[i]);
+	}
+
+	for (i = 0; i < nreqs && !ret; i++) {
+		if (errs[i] != -EINPROGRESS && errs[i] != -EBUSY)
+			ret = errs[i];
+	}
+	return ret;
+}
+
+int crypto_aead_encrypt_batch(struct aead_request **reqs, int *errs,
+			      unsigned int nreqs)
+{
+	return crypto_aead_crypt_batch(reqs, errs, nreqs, true);
+}
+EXPORT_SYMBOL_GPL(crypto_aead_encrypt_batch);
+
+int crypto_aead_decrypt_batch(struct aead_request **reqs, int *errs,
+			      unsigned int nreqs)
+{
+	return crypto_aead_crypt_batch(reqs, errs, nreqs, false);
+}
+EXPORT_SYMBOL_GPL(crypto_aead_decrypt_batch);
+
 static void crypto_aead_exit_tfm(struct crypto_tfm *tfm)
 {
 	struct crypto_aead *aead = __crypto_aead_cast(tfm);
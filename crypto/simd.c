@@ -349,6 +349,65 @@ static int simd_aead_decrypt(struct aead_request *req)
 	return crypto_aead_decrypt(subreq);
 }
 
+/* subrequests handed to the internal algorithm per batch call */
+#define SIMD_AEAD_BATCH_MAX	16
+
+/*
+ * When the SIMD unit is usable, hand the whole batch to the internal
+ * algorithm so it can enter the SIMD context once; otherwise each request
+ * goes through cryptd like a single one.
+ */
+static void simd_aead_crypt_batch(struct aead_request **reqs, int *errs,
+				  unsigned int nreqs, bool enc)
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(reqs[0]);
+	struct simd_aead_ctx *ctx = crypto_aead_ctx(tfm);
+	struct aead_request *subreqs[SIMD_AEAD_BATCH_MAX];
+	struct crypto_aead *child;
+	unsigned int i, n;
+
+	if (!crypto_simd_usable() ||
+	    (in_atomic() && cryptd_aead_queued(ctx->cryptd_tfm))) {
+		for (i = 0; i < nreqs; i++)
+			errs[i] = enc ? simd_aead_encrypt(reqs[i]) :
+					simd_aead_decrypt(reqs[i]);
+		return;
+	}
+
+	child = cryptd_aead_child(ctx->cryptd_tfm);
+
+	while (nreqs) {
+		n = min_t(unsigned int, nreqs, SIMD_AEAD_BATCH_MAX);
+
+		for (i = 0; i < n; i++) {
+			subreqs[i] = aead_request_ctx(reqs[i]);
+			*subreqs[i] = *reqs[i];
+			aead_request_set_tfm(subreqs[i], child);
+		}
+
+		if (enc)
+			crypto_aead_encrypt_batch(subreqs, errs, n);
+		else
+			crypto_aead_decrypt_batch(subreqs, errs, n);
+
+		reqs += n;
+		errs += n;
+		nreqs -= n;
+	}
+}
+
+static void simd_aead_encrypt_batch(struct aead_request **reqs, int *errs,
+				    unsigned int nreqs)
+{
+	simd_aead_crypt_batch(reqs, errs, nreqs, true);
+}
+
+static void simd_aead_decrypt_batch(struct aead_request **reqs, int *errs,
+				    unsigned int nreqs)
+{
+	simd_aead_crypt_batch(reqs, errs, nreqs, false);
+}
+
 static void simd_aead_exit(struct crypto_aead *tfm)
 {
 	struct simd_aead_ctx *ctx = crypto_aead_ctx(tfm);
@@ -437,6 +496,10 @@ struct simd_aead_alg *simd_aead_create_compat(const char *algname,
 	alg->setauthsize = simd_aead_setauthsize;
 	alg->encrypt = simd_aead_encrypt;
 	alg->decrypt = simd_aead_decrypt;
+	if (ialg->encrypt_batch)
+		alg->encrypt_batch = simd_aead_encrypt_batch;
+	if (ialg->decrypt_batch)
+		alg->decrypt_batch = simd_aead_decrypt_batch;
 
 	err = crypto_register_aead(alg);
 	if (err)
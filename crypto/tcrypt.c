@@ -63,6 +63,7 @@ static u32 type;
 static u32 mask;
 static int mode;
 static u32 num_mb = 8;
+static bool batch;
 static unsigned int klen;
 static char *tvmem[TVMEMSIZE];
 
@@ -155,16 +156,23 @@ struct test_mb_aead_data {
 };
 
 static int do_mult_aead_op(struct test_mb_aead_data *data, int enc,
-				u32 num_mb, int *rc)
+				u32 num_mb, int *rc, struct aead_request **reqs)
 {
 	int i, err = 0;
 
 	/* Fire up a bunch of concurrent requests */
-	for (i = 0; i < num_mb; i++) {
+	if (batch) {
 		if (enc == ENCRYPT)
-			rc[i] = crypto_aead_encrypt(data[i].req);
+			crypto_aead_encrypt_batch(reqs, rc, num_mb);
 		else
-			rc[i] = crypto_aead_decrypt(data[i].req);
+			crypto_aead_decrypt_batch(reqs, rc, num_mb);
+	} else {
+		for (i = 0; i < num_mb; i++) {
+			if (enc == ENCRYPT)
+				rc[i] = crypto_aead_encrypt(reqs[i]);
+			else
+				rc[i] = crypto_aead_decrypt(reqs[i]);
+		}
 	}
 
 	/* Wait for all requests to finish */
@@ -180,9 +188,27 @@ static int do_mult_aead_op(struct test_mb_aead_data *data, int enc,
 	return err;
 }
 
+/* the request array for crypto_aead_{en,de}crypt_batch() */
+static struct aead_request **test_mb_aead_reqs(struct test_mb_aead_data *data,
+					       u32 num_mb)
+{
+	struct aead_request **reqs;
+	int i;
+
+	reqs = kcalloc(num_mb, sizeof(*reqs), GFP_KERNEL);
+	if (!reqs)
+		return NULL;
+
+	for (i = 0; i < num_mb; i++)
+		reqs[i] = data[i].req;
+
+	return reqs;
+}
+
 static int test_mb_aead_jiffies(struct test_mb_aead_data *data, int enc,
 				int blen, int secs, u32 num_mb)
 {
+	struct aead_request **reqs;
 	unsigned long start, end;
 	int bcount;
 	int ret = 0;
@@ -192,9 +218,15 @@ static int test_mb_aead_jiffies(struct test_mb_aead_data *data, int enc,
 	if (!rc)
 		return -ENOMEM;
 
+	reqs = test_mb_aead_reqs(data, num_mb);
+	if (!reqs) {
+		kfree(rc);
+		return -ENOMEM;
+	}
+
 	for (start = jiffies, end = start + secs * HZ, bcount = 0;
 	     time_before(jiffies, end); bcount++) {
-		ret = do_mult_aead_op(data, enc, num_mb, rc);
+		ret = do_mult_aead_op(data, enc, num_mb, rc, reqs);
 		if (ret)
 			goto out;
 	}
@@ -203,6 +235,7 @@ static int test_mb_aead_jiffies(struct test_mb_aead_data *data, int enc,
 		bcount * num_mb, secs, (u64)bcount * blen * num_mb);
 
 out:
+	kfree(reqs);
 	kfree(rc);
 	return ret;
 }
@@ -210,6 +243,7 @@ static int test_mb_aead_jiffies(struct test_mb_aead_data *data, int enc,
 static int test_mb_aead_cycles(struct test_mb_aead_data *data, int enc,
 			       int blen, u32 num_mb)
 {
+	struct aead_request **reqs;
 	unsigned long cycles = 0;
 	int ret = 0;
 	int i;
@@ -219,9 +253,15 @@ static int test_mb_aead_cycles(struct test_mb_aead_data *data, int enc,
 	if (!rc)
 		return -ENOMEM;
 
+	reqs = test_mb_aead_reqs(data, num_mb);
+	if (!reqs) {
+		kfree(rc);
+		return -ENOMEM;
+	}
+
 	/* Warm-up run. */
 	for (i = 0; i < 4; i++) {
-		ret = do_mult_aead_op(data, enc, num_mb, rc);
+		ret = do_mult_aead_op(data, enc, num_mb, rc, reqs);
 		if (ret)
 			goto out;
 	}
@@ -231,7 +271,7 @@ static int test_mb_aead_cycles(struct test_mb_aead_data *data, int enc,
 		cycles_t start, end;
 
 		start = get_cycles();
-		ret = do_mult_aead_op(data, enc, num_mb, rc);
+		ret = do_mult_aead_op(data, enc, num_mb, rc, reqs);
 		end = get_cycles();
 
 		if (ret)
@@ -244,6 +284,7 @@ static int test_mb_aead_cycles(struct test_mb_aead_data *data, int enc,
 		(cycles + 4) / (8 * num_mb), blen);
 
 out:
+	kfree(reqs);
 	kfree(rc);
 	return ret;
 }
@@ -3088,6 +3129,8 @@ MODULE_PARM_DESC(sec, "Length in seconds of speed tests "
 		      "(defaults to zero which uses CPU cycles instead)");
 module_param(num_mb, uint, 0000);
 MODULE_PARM_DESC(num_mb, "Number of concurrent requests to be used in mb speed tests (defaults to 8)");
+module_param(batch, bool, 0);
+MODULE_PARM_DESC(batch, "Submit the requests of the mb AEAD speed tests as one batch");
 module_param(klen, uint, 0);
 MODULE_PARM_DESC(klen, "Key length (defaults to 0)");
 
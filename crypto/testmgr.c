@@ -2542,6 +2542,152 @@ static int test_aead(int enc, const struct aead_test_suite *suite,
 	return 0;
 }
 
+/* requests per crypto_aead_{en,de}crypt_batch() call of the batch tests */
+#define AEAD_BATCH_TEST_REQS	4
+
+/*
+ * Run a test vector through crypto_aead_{en,de}crypt_batch(), as several
+ * in-place requests for the same message.  The even ones have a linear
+ * buffer, the odd ones the associated data and the text in two scatterlist
+ * entries, like network packets often have them.
+ */
+static int test_aead_vec_batch(int enc, const struct aead_testvec *vec,
+			       unsigned int vec_num, struct aead_request **reqs)
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(reqs[0]);
+	const unsigned int ivsize = crypto_aead_ivsize(tfm);
+	const unsigned int authsize = vec->clen - vec->plen;
+	const unsigned int buflen = vec->alen + vec->clen;
+	const char *driver = crypto_aead_driver_name(tfm);
+	const char *op = enc ? "encryption" : "decryption";
+	struct scatterlist sgs[AEAD_BATCH_TEST_REQS][2];
+	struct crypto_wait waits[AEAD_BATCH_TEST_REQS];
+	u8 ivs[AEAD_BATCH_TEST_REQS][MAX_IVLEN];
+	u8 *bufs[AEAD_BATCH_TEST_REQS] = {};
+	int errs[AEAD_BATCH_TEST_REQS];
+	unsigned int i;
+	int err;
+
+	if ((enc && vec->novrfy) || vec->setkey_error ||
+	    vec->setauthsize_error)
+		return 0;
+
+	if (vec->wk)
+		crypto_aead_set_flags(tfm, CRYPTO_TFM_REQ_FORBID_WEAK_KEYS);
+	else
+		crypto_aead_clear_flags(tfm, CRYPTO_TFM_REQ_FORBID_WEAK_KEYS);
+
+	err = crypto_aead_setkey(tfm, vec->key, vec->klen);
+	if (!err)
+		err = crypto_aead_setauthsize(tfm, authsize);
+	if (err) {
+		pr_err("alg: aead: %s setkey or setauthsize failed on batch test vector %u; err=%d\n",
+		       driver, vec_num, err);
+		return err;
+	}
+
+	if (WARN_ON(ivsize > MAX_IVLEN))
+		return -EINVAL;
+
+	for (i = 0; i < AEAD_BATCH_TEST_REQS; i++) {
+		/* one more byte, the buffer is not empty */
+		bufs[i] = kmalloc(buflen + 1, GFP_KERNEL);
+		if (!bufs[i]) {
+			err = -ENOMEM;
+			goto out;
+		}
+		memcpy(bufs[i], vec->assoc, vec->alen);
+		memcpy(bufs[i] + vec->alen, enc ? vec->ptext : vec->ctext,
+		       enc ? vec->plen : vec->clen);
+
+		if ((i & 1) && vec->alen && vec->clen) {
+			sg_init_table(sgs[i], 2);
+			sg_set_buf(&sgs[i][0], bufs[i], vec->alen);
+			sg_set_buf(&sgs[i][1], bufs[i] + vec->alen, vec->clen);
+		} else {
+			sg_init_one(sgs[i], bufs[i], buflen);
+		}
+
+		if (vec->iv)
+			memcpy(ivs[i], vec->iv, ivsize);
+		else
+			memset(ivs[i], 0, ivsize);
+
+		crypto_init_wait(&waits[i]);
+		aead_request_set_callback(reqs[i], CRYPTO_TFM_REQ_MAY_BACKLOG,
+					  crypto_req_done, &waits[i]);
+		aead_request_set_crypt(reqs[i], sgs[i], sgs[i],
+				       enc ? vec->plen : vec->clen, ivs[i]);
+		aead_request_set_ad(reqs[i], vec->alen);
+	}
+
+	if (enc)
+		crypto_aead_encrypt_batch(reqs, errs, AEAD_BATCH_TEST_REQS);
+	else
+		crypto_aead_decrypt_batch(reqs, errs, AEAD_BATCH_TEST_REQS);
+
+	/* wait for all of them before freeing any buffer */
+	for (i = 0; i < AEAD_BATCH_TEST_REQS; i++)
+		errs[i] = crypto_wait_req(errs[i], &waits[i]);
+
+	for (i = 0; i < AEAD_BATCH_TEST_REQS; i++) {
+		err = errs[i];
+		if ((err == 0 && vec->novrfy) ||
+		    (err != vec->crypt_error &&
+		     !(err == -EBADMSG && vec->novrfy))) {
+			pr_err("alg: aead: %s batch %s failed on test vector %u, request %u; expected_error=%d%s, actual_error=%d\n",
+			       driver, op, vec_num, i, vec->crypt_error,
+			       vec->novrfy ? " or -EBADMSG" : "", err);
+			err = err ?: -EINVAL;
+			goto out;
+		}
+		if (err) /* Expectedly failed. */
+			continue;
+
+		if (memcmp(bufs[i] + vec->alen, enc ? vec->ctext : vec->ptext,
+			   enc ? vec->clen : vec->plen)) {
+			pr_err("alg: aead: %s batch %s test failed (wrong result) on test vector %u, request %u\n",
+			       driver, op, vec_num, i);
+			err = -EINVAL;
+			goto out;
+		}
+	}
+	err = 0;
+out:
+	for (i = 0; i < AEAD_BATCH_TEST_REQS; i++)
+		kfree(bufs[i]);
+	return err;
+}
+
+static int test_aead_batch(int enc, const struct aead_test_suite *suite,
+			   struct crypto_aead *tfm)
+{
+	struct aead_request *reqs[AEAD_BATCH_TEST_REQS] = {};
+	unsigned int i;
+	int err = 0;
+
+	for (i = 0; i < AEAD_BATCH_TEST_REQS; i++) {
+		reqs[i] = aead_request_alloc(tfm, GFP_KERNEL);
+		if (!reqs[i]) {
+			pr_err("alg: aead: failed to allocate batch requests for %s\n",
+			       crypto_aead_driver_name(tfm));
+			err = -ENOMEM;
+			goto out;
+		}
+	}
+
+	for (i = 0; i < suite->count; i++) {
+		err = test_aead_vec_batch(enc, &suite->vecs[i], i, reqs);
+		if (err)
+			goto out;
+		cond_resched();
+	}
+out:
+	for (i = 0; i < AEAD_BATCH_TEST_REQS; i++)
+		aead_request_free(reqs[i]);
+	return err;
+}
+
 static int alg_test_aead(const struct alg_test_desc *desc, const char *driver,
 			 u32 type, u32 mask)
 {
@@ -2588,6 +2734,14 @@ static int alg_test_aead(const struct alg_test_desc *desc, const char *driver,
 	if (err)
 		goto out;
 
+	err = test_aead_batch(ENCRYPT, suite, tfm);
+	if (err)
+		goto out;
+
+	err = test_aead_batch(DECRYPT, suite, tfm);
+	if (err)
+		goto out;
+
 	err = test_aead_extra(desc, req, tsgls);
 out:
 	free_cipher_test_sglists(tsgls);
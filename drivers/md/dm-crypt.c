@@ -133,7 +133,7 @@ struct iv_elephant_private {
 enum flags { DM_CRYPT_SUSPENDED, DM_CRYPT_KEY_VALID,
 	     DM_CRYPT_SAME_CPU, DM_CRYPT_NO_OFFLOAD,
 	     DM_CRYPT_NO_READ_WORKQUEUE, DM_CRYPT_NO_WRITE_WORKQUEUE,
-	     DM_CRYPT_WRITE_INLINE };
+	     DM_CRYPT_WRITE_INLINE, DM_CRYPT_INLINE_SYNC };
 
 enum cipher_flags {
 	CRYPT_MODE_INTEGRITY_AEAD,	/* Use authenticated mode for cipher */
@@ -215,6 +215,8 @@ struct crypt_config {
 	mempool_t tag_pool;
 	mempool_t req_pool;
 	mempool_t page_pool;
+	/* one-entry per-CPU cache of crypto requests, see crypt_get_req() */
+	void * __percpu *req_cache;
 
 	struct bio_set bs;
 	struct mutex bio_alloc_lock;
@@ -227,6 +229,10 @@ struct crypt_config {
 #define MAX_TAG_SIZE	480
 #define POOL_ENTRY_SIZE	512
 
+static bool inline_sync_crypt = true;
+module_param(inline_sync_crypt, bool, 0644);
+MODULE_PARM_DESC(inline_sync_crypt, "Encrypt and decrypt in the submitting and completing contexts, bypassing the kcryptd workqueues, when the cipher is synchronous");
+
 static DEFINE_SPINLOCK(dm_crypt_clients_lock);
 static unsigned dm_crypt_clients_n = 0;
 static volatile unsigned long dm_crypt_pages_per_client;
@@ -1124,6 +1130,34 @@ static bool crypt_integrity_hmac(struct crypt_config *cc)
 	return crypt_integrity_aead(cc) && cc->key_mac_size;
 }
 
+static bool crypt_cipher_is_async(struct crypt_config *cc)
+{
+	struct crypto_alg *alg;
+
+	if (crypt_integrity_aead(cc))
+		alg = &crypto_aead_alg(any_tfm_aead(cc))->base;
+	else
+		alg = &crypto_skcipher_alg(any_tfm(cc))->base;
+
+	return alg->cra_flags & CRYPTO_ALG_ASYNC;
+}
+
+/*
+ * The workqueues are bypassed when the table asks for it, or by default for
+ * synchronous ciphers, see DM_CRYPT_INLINE_SYNC.
+ */
+static bool crypt_no_read_workqueue(struct crypt_config *cc)
+{
+	return test_bit(DM_CRYPT_NO_READ_WORKQUEUE, &cc->flags) ||
+	       test_bit(DM_CRYPT_INLINE_SYNC, &cc->flags);
+}
+
+static bool crypt_no_write_workqueue(struct crypt_config *cc)
+{
+	return test_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags) ||
+	       test_bit(DM_CRYPT_INLINE_SYNC, &cc->flags);
+}
+
 /* Get sg containing data */
 static struct scatterlist *crypt_get_sg_data(struct crypt_config *cc,
 					     struct scatterlist *sg)
@@ -1457,13 +1491,36 @@ static int crypt_convert_block_skcipher(struct crypt_config *cc,
 static void kcryptd_async_done(struct crypto_async_request *async_req,
 			       int error);
 
+/*
+ * A request beyond the one in the per-bio data is needed each time the
+ * cipher goes asynchronous.  Keep the last one freed on every CPU, a
+ * one-entry cache rather than a pool, so that an alloc/free pair on the
+ * same CPU skips the mempool; req_pool is sized for the ones parked here
+ * to not eat into its reserve.
+ */
+static void *crypt_get_req(struct crypt_config *cc)
+{
+	void *req = this_cpu_xchg(*cc->req_cache, NULL);
+
+	if (likely(req))
+		return req;
+
+	return mempool_alloc(&cc->req_pool, in_interrupt() ? GFP_ATOMIC : GFP_NOIO);
+}
+
+static void crypt_put_req(struct crypt_config *cc, void *req)
+{
+	if (this_cpu_cmpxchg(*cc->req_cache, NULL, req))
+		mempool_free(req, &cc->req_pool);
+}
+
 static int crypt_alloc_req_skcipher(struct crypt_config *cc,
 				     struct convert_context *ctx)
 {
 	unsigned key_index = ctx->cc_sector & (cc->tfms_count - 1);
 
 	if (!ctx->r.req) {
-		ctx->r.req = mempool_alloc(&cc->req_pool, in_interrupt() ? GFP_ATOMIC : GFP_NOIO);
+		ctx->r.req = crypt_get_req(cc);
 		if (!ctx->r.req)
 			return -ENOMEM;
 	}
@@ -1485,7 +1542,7 @@ static int crypt_alloc_req_aead(struct crypt_config *cc,
 				 struct convert_context *ctx)
 {
 	if (!ctx->r.req_aead) {
-		ctx->r.req_aead = mempool_alloc(&cc->req_pool, in_interrupt() ? GFP_ATOMIC : GFP_NOIO);
+		ctx->r.req_aead = crypt_get_req(cc);
 		if (!ctx->r.req_aead)
 			return -ENOMEM;
 	}
@@ -1518,7 +1575,7 @@ static void crypt_free_req_skcipher(struct crypt_config *cc,
 	struct dm_crypt_io *io = dm_per_bio_data(base_bio, cc->per_bio_data_size);
 
 	if ((struct skcipher_request *)(io + 1) != req)
-		mempool_free(req, &cc->req_pool);
+		crypt_put_req(cc, req);
 }
 
 static void crypt_free_req_aead(struct crypt_config *cc,
@@ -1527,7 +1584,7 @@ static void crypt_free_req_aead(struct crypt_config *cc,
 	struct dm_crypt_io *io = dm_per_bio_data(base_bio, cc->per_bio_data_size);
 
 	if ((struct aead_request *)(io + 1) != req)
-		mempool_free(req, &cc->req_pool);
+		crypt_put_req(cc, req);
 }
 
 static void crypt_free_req(struct crypt_config *cc, void *req, struct bio *base_bio)
@@ -1965,7 +2022,7 @@ static void kcryptd_crypt_write_io_submit(struct dm_crypt_io *io, int async)
 	clone->bi_iter.bi_sector = cc->start + io->sector;
 
 	if ((likely(!async) && test_bit(DM_CRYPT_NO_OFFLOAD, &cc->flags)) ||
-	    test_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags)) {
+	    crypt_no_write_workqueue(cc)) {
 		submit_bio_noacct(clone);
 		return;
 	}
@@ -2074,8 +2131,7 @@ static void kcryptd_crypt_write_convert(struct dm_crypt_io *io)
 	sector += bio_sectors(clone);
 
 	crypt_inc_pending(io);
-	r = crypt_convert(cc, ctx,
-			  test_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags), true);
+	r = crypt_convert(cc, ctx, crypt_no_write_workqueue(cc), true);
 	/*
 	 * Crypto API backlogged the request, because its queue was full
 	 * and we're in softirq context, so continue from a workqueue
@@ -2139,8 +2195,7 @@ static void kcryptd_crypt_read_convert(struct dm_crypt_io *io)
 	crypt_convert_init(cc, &io->ctx, io->base_bio, io->base_bio,
 			   io->sector);
 
-	r = crypt_convert(cc, &io->ctx,
-			  test_bit(DM_CRYPT_NO_READ_WORKQUEUE, &cc->flags), true);
+	r = crypt_convert(cc, &io->ctx, crypt_no_read_workqueue(cc), true);
 	/*
 	 * Crypto API backlogged the request, because its queue was full
 	 * and we're in softirq context, so continue from a workqueue
@@ -2229,8 +2284,8 @@ static void kcryptd_queue_crypt(struct dm_crypt_io *io)
 {
 	struct crypt_config *cc = io->cc;
 
-	if ((bio_data_dir(io->base_bio) == READ && test_bit(DM_CRYPT_NO_READ_WORKQUEUE, &cc->flags)) ||
-	    (bio_data_dir(io->base_bio) == WRITE && test_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags))) {
+	if ((bio_data_dir(io->base_bio) == READ && crypt_no_read_workqueue(cc)) ||
+	    (bio_data_dir(io->base_bio) == WRITE && crypt_no_write_workqueue(cc))) {
 		/*
 		 * in_hardirq(): Crypto API's skcipher_walk_first() refuses to work in hard IRQ context.
 		 * irqs_disabled(): the kernel may run some IO completion from the idle thread, but
@@ -2698,6 +2753,7 @@ static void crypt_page_free(void *page, void *pool_data)
 static void crypt_dtr(struct dm_target *ti)
 {
 	struct crypt_config *cc = ti->private;
+	int cpu;
 
 	ti->private = NULL;
 
@@ -2716,6 +2772,16 @@ static void crypt_dtr(struct dm_target *ti)
 
 	bioset_exit(&cc->bs);
 
+	if (cc->req_cache) {
+		for_each_possible_cpu(cpu) {
+			void *req = *per_cpu_ptr(cc->req_cache, cpu);
+
+			if (req)
+				mempool_free(req, &cc->req_pool);
+		}
+		free_percpu(cc->req_cache);
+	}
+
 	mempool_exit(&cc->page_pool);
 	mempool_exit(&cc->req_pool);
 	mempool_exit(&cc->tag_pool);
@@ -3219,6 +3285,16 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 	if (ret < 0)
 		goto bad;
 
+	/*
+	 * A synchronous cipher gains nothing from the workqueues but their
+	 * context switches, run it from where the bios are submitted and
+	 * completed instead.  This is a default, not a table argument, so it
+	 * is not reported by the status and follows the module parameter on
+	 * a reload.
+	 */
+	if (inline_sync_crypt && !crypt_cipher_is_async(cc))
+		set_bit(DM_CRYPT_INLINE_SYNC, &cc->flags);
+
 	if (crypt_integrity_aead(cc)) {
 		cc->dmreq_start = sizeof(struct aead_request);
 		cc->dmreq_start += crypto_aead_reqsize(any_tfm_aead(cc));
@@ -3250,12 +3326,20 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 		sizeof(uint64_t) +
 		sizeof(unsigned int);
 
-	ret = mempool_init_kmalloc_pool(&cc->req_pool, MIN_IOS, cc->dmreq_start + additional_req_size);
+	ret = mempool_init_kmalloc_pool(&cc->req_pool, MIN_IOS + num_possible_cpus(),
+					cc->dmreq_start + additional_req_size);
 	if (ret) {
 		ti->error = "Cannot allocate crypt request mempool";
 		goto bad;
 	}
 
+	cc->req_cache = alloc_percpu(void *);
+	if (!cc->req_cache) {
+		ret = -ENOMEM;
+		ti->error = "Cannot allocate crypt request cache";
+		goto bad;
+	}
+
 	cc->per_bio_data_size = ti->per_io_data_size =
 		ALIGN(sizeof(struct dm_crypt_io) + cc->dmreq_start + additional_req_size,
 		      ARCH_KMALLOC_MINALIGN);
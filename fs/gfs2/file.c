@@ -781,16 +781,17 @@ static inline bool should_fault_in_pages(ssize_t ret, struct iov_iter *i,
 					 size_t *prev_count,
 					 size_t *window_size)
 {
-	char __user *p = i->iov[0].iov_base + i->iov_offset;
 	size_t count = iov_iter_count(i);
+	char __user *p;
 	int pages = 1;
 
 	if (likely(!count))
 		return false;
 	if (ret <= 0 && ret != -EFAULT)
 		return false;
-	if (!iter_is_iovec(i))
+	if (!user_backed_iter(i))
 		return false;
+	p = iov_iter_iovec(i).iov_base;
 
 	if (*prev_count != count || !*window_size) {
 		int pages, nr_dirtied;
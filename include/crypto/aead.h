@@ -116,6 +116,13 @@ struct aead_request {
  * @setkey: see struct skcipher_alg
  * @encrypt: see struct skcipher_alg
  * @decrypt: see struct skcipher_alg
+ * @encrypt_batch: Optional, encrypt several requests for the same
+ *		   transformation at once, storing the result of each in the
+ *		   array given.  A driver implements this when it can share
+ *		   setup, such as entering the SIMD context, between the
+ *		   requests.  A request going asynchronous reports
+ *		   -EINPROGRESS or -EBUSY there, as from @encrypt.
+ * @decrypt_batch: Optional, the counterpart of @encrypt_batch.
  * @ivsize: see struct skcipher_alg
  * @chunksize: see struct skcipher_alg
  * @init: Initialize the cryptographic transformation object. This function
@@ -139,6 +146,10 @@ struct aead_alg {
 	int (*setauthsize)(struct crypto_aead *tfm, unsigned int authsize);
 	int (*encrypt)(struct aead_request *req);
 	int (*decrypt)(struct aead_request *req);
+	void (*encrypt_batch)(struct aead_request **reqs, int *errs,
+			      unsigned int nreqs);
+	void (*decrypt_batch)(struct aead_request **reqs, int *errs,
+			      unsigned int nreqs);
 	int (*init)(struct crypto_aead *tfm);
 	void (*exit)(struct crypto_aead *tfm);
 
@@ -366,6 +377,41 @@ int crypto_aead_encrypt(struct aead_request *req);
  */
 int crypto_aead_decrypt(struct aead_request *req);
 
+/**
+ * crypto_aead_encrypt_batch() - encrypt several requests at once
+ * @reqs: the requests, all for the same transformation
+ * @errs: array receiving the result of each request, as crypto_aead_encrypt()
+ *	  would have returned it
+ * @nreqs: number of requests
+ *
+ * For callers with many independent messages, such as packets, at hand.
+ * The requests are processed in order, one after the other; they are not
+ * interleaved.  Drivers with batch support only share the per-request
+ * setup, such as entering the SIMD context, between them.  With the others
+ * this is one crypto_aead_encrypt() call per request.  If a request is for
+ * another transformation than the first, all of them fail with -EINVAL.
+ *
+ * Return: 0 if all requests succeeded or are in progress, else the first
+ *	   error in @errs.
+ */
+int crypto_aead_encrypt_batch(struct aead_request **reqs, int *errs,
+			      unsigned int nreqs);
+
+/**
+ * crypto_aead_decrypt_batch() - decrypt several requests at once
+ * @reqs: the requests, all for the same transformation
+ * @errs: array receiving the result of each request, as crypto_aead_decrypt()
+ *	  would have returned it
+ * @nreqs: number of requests
+ *
+ * See crypto_aead_encrypt_batch().
+ *
+ * Return: 0 if all requests succeeded or are in progress, else the first
+ *	   error in @errs, -EBADMSG for a failed authentication.
+ */
+int crypto_aead_decrypt_batch(struct aead_request **reqs, int *errs,
+			      unsigned int nreqs);
+
 /**
  * DOC: Asynchronous AEAD Request Handle
  *
@@ -8,4 +8,24 @@
 #include <linux/types.h>
 
 u64 __pure crc64_be(u64 crc, const void *p, size_t len);
+
+/* the generic version, for architecture code replacing the above */
+u64 __pure crc64_be_base(u64 crc, const void *p, size_t len);
+
+u64 __attribute_const__ crc64_be_shift(u64 crc, size_t len);
+
+/**
+ * crc64_be_combine - Combine the crc64_be() values of two buffers
+ * @crc1: crc64_be() of the first buffer
+ * @crc2: crc64_be() of the second buffer, seeded with 0
+ * @len2: length of the second buffer
+ *
+ * Return: crc64_be() of the two buffers concatenated, with the seed of
+ *	   @crc1.  This allows to compute the CRC of the parts of a buffer
+ *	   in parallel.
+ */
+static inline u64 crc64_be_combine(u64 crc1, u64 crc2, size_t len2)
+{
+	return crc64_be_shift(crc1, len2) ^ crc2;
+}
 #endif /* _LINUX_CRC64_H */
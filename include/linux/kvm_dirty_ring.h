@@ -17,6 +17,8 @@
  *               to allow userspace to harvest all the dirty pages
  * @dirty_gfns:  the array to keep the dirty gfns
  * @index:       index of this dirty ring
+ * @reset_lock:  serializes the resets of this ring, which can come both
+ *               from the VM and from the vcpu ioctls
  */
 struct kvm_dirty_ring {
 	u32 dirty_index;
@@ -25,6 +27,7 @@ struct kvm_dirty_ring {
 	u32 soft_limit;
 	struct kvm_dirty_gfn *dirty_gfns;
 	int index;
+	struct mutex reset_lock;
 };
 
 #if (KVM_DIRTY_LOG_PAGE_OFFSET == 0)
@@ -81,7 +84,7 @@ int kvm_dirty_ring_alloc(struct kvm_dirty_ring *ring, int index, u32 size);
 struct kvm_dirty_ring *kvm_dirty_ring_get(struct kvm *kvm);
 
 /*
- * called with kvm->slots_lock held, returns the number of
+ * called with kvm->slots_lock or kvm->srcu held, returns the number of
  * processed pages.
  */
 int kvm_dirty_ring_reset(struct kvm *kvm, struct kvm_dirty_ring *ring);
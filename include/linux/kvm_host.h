@@ -51,6 +51,8 @@
  * include/linux/kvm_h.
  */
 #define KVM_MEMSLOT_INVALID	(1UL << 16)
+/* A KVM_MEM_EXIT_ON_MISSING slot with VM_IO or VM_PFNMAP host mappings */
+#define KVM_MEMSLOT_PFNMAP	(1UL << 17)
 
 /*
  * Bit 63 of the memslot generation number is an "update in-progress flag",
@@ -319,6 +321,9 @@ struct kvm_vcpu {
 	sigset_t sigset;
 	unsigned int halt_poll_ns;
 	bool valid_wakeup;
+	/* Decaying log2 histogram of recent block times, in ns */
+	u16 halt_block_hist[HALT_POLL_HIST_COUNT];
+	u16 halt_block_count;
 
 #ifdef CONFIG_HAS_IOMEM
 	int mmio_needed;
@@ -722,6 +727,7 @@ struct kvm {
 	struct srcu_struct irq_srcu;
 	pid_t userspace_pid;
 	unsigned int max_halt_poll_ns;
+	unsigned int halt_poll_pct;
 	u32 dirty_ring_size;
 	bool vm_bugged;
 
@@ -967,6 +973,9 @@ kvm_pfn_t gfn_to_pfn_memslot_atomic(struct kvm_memory_slot *slot, gfn_t gfn);
 kvm_pfn_t __gfn_to_pfn_memslot(struct kvm_memory_slot *slot, gfn_t gfn,
 			       bool atomic, bool *async, bool write_fault,
 			       bool *writable, hva_t *hva);
+kvm_pfn_t gfn_to_pfn_memslot_nofault(struct kvm_memory_slot *slot, gfn_t gfn,
+				     bool write_fault, bool *writable,
+				     hva_t *hva);
 
 void kvm_release_pfn_clean(kvm_pfn_t pfn);
 void kvm_release_pfn_dirty(kvm_pfn_t pfn);
@@ -1560,6 +1569,7 @@ struct _kvm_stats_desc {
 	STATS_DESC_COUNTER(VCPU_GENERIC, halt_attempted_poll),		       \
 	STATS_DESC_COUNTER(VCPU_GENERIC, halt_poll_invalid),		       \
 	STATS_DESC_COUNTER(VCPU_GENERIC, halt_wakeup),			       \
+	STATS_DESC_COUNTER(VCPU_GENERIC, halt_poll_skipped),		       \
 	STATS_DESC_TIME_NSEC(VCPU_GENERIC, halt_poll_success_ns),	       \
 	STATS_DESC_TIME_NSEC(VCPU_GENERIC, halt_poll_fail_ns),		       \
 	STATS_DESC_TIME_NSEC(VCPU_GENERIC, halt_wait_ns),		       \
@@ -1568,7 +1578,11 @@ struct _kvm_stats_desc {
 	STATS_DESC_LOGHIST_TIME_NSEC(VCPU_GENERIC, halt_poll_fail_hist,	       \
 			HALT_POLL_HIST_COUNT),				       \
 	STATS_DESC_LOGHIST_TIME_NSEC(VCPU_GENERIC, halt_wait_hist,	       \
-			HALT_POLL_HIST_COUNT)
+			HALT_POLL_HIST_COUNT),				       \
+	STATS_DESC_COUNTER(VCPU_GENERIC, dirty_ring_push),		       \
+	STATS_DESC_COUNTER(VCPU_GENERIC, dirty_ring_reset),		       \
+	STATS_DESC_TIME_NSEC(VCPU_GENERIC, dirty_ring_reset_ns),	       \
+	STATS_DESC_COUNTER(VCPU_GENERIC, dirty_ring_full_exits)
 
 extern struct dentry *kvm_debugfs_dir;
 
@@ -1777,6 +1791,7 @@ extern unsigned int halt_poll_ns;
 extern unsigned int halt_poll_ns_grow;
 extern unsigned int halt_poll_ns_grow_start;
 extern unsigned int halt_poll_ns_shrink;
+extern unsigned int halt_poll_pct;
 
 struct kvm_device {
 	const struct kvm_device_ops *ops;
@@ -1867,6 +1882,16 @@ static inline bool kvm_is_visible_memslot(struct kvm_memory_slot *memslot)
 		!(memslot->flags & KVM_MEMSLOT_INVALID));
 }
 
+static inline void kvm_prepare_memory_fault_exit(struct kvm_vcpu *vcpu,
+						 gpa_t gpa, gpa_t size,
+						 bool is_write)
+{
+	vcpu->run->exit_reason = KVM_EXIT_MEMORY_FAULT;
+	vcpu->run->memory_fault.gpa = gpa;
+	vcpu->run->memory_fault.size = size;
+	vcpu->run->memory_fault.flags = is_write ? KVM_MEMORY_EXIT_FLAG_WRITE : 0;
+}
+
 struct kvm_vcpu *kvm_get_running_vcpu(void);
 struct kvm_vcpu * __percpu *kvm_get_running_vcpus(void);
 
@@ -88,12 +88,17 @@ struct kvm_vcpu_stat_generic {
 	u64 halt_attempted_poll;
 	u64 halt_poll_invalid;
 	u64 halt_wakeup;
+	u64 halt_poll_skipped;
 	u64 halt_poll_success_ns;
 	u64 halt_poll_fail_ns;
 	u64 halt_wait_ns;
 	u64 halt_poll_success_hist[HALT_POLL_HIST_COUNT];
 	u64 halt_poll_fail_hist[HALT_POLL_HIST_COUNT];
 	u64 halt_wait_hist[HALT_POLL_HIST_COUNT];
+	u64 dirty_ring_push;
+	u64 dirty_ring_reset;
+	u64 dirty_ring_reset_ns;
+	u64 dirty_ring_full_exits;
 };
 
 #define KVM_STATS_NAME_SIZE	48
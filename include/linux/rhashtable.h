@@ -22,6 +22,7 @@
 #include <linux/errno.h>
 #include <linux/jhash.h>
 #include <linux/list_nulls.h>
+#include <linux/prefetch.h>
 #include <linux/workqueue.h>
 #include <linux/rculist.h>
 #include <linux/bit_spinlock.h>
@@ -61,6 +62,9 @@ struct rhash_lock_head {};
  */
 #define RHT_ELASTICITY	16u
 
+/* Number of objects rhashtable_lookup_insert_bulk_fast() hashes ahead */
+#define RHT_BULK_BATCH	16u
+
 /**
  * struct bucket_table - Table of hash buckets
  * @size: Number of hash buckets
@@ -76,6 +80,7 @@ struct rhash_lock_head {};
 struct bucket_table {
 	unsigned int		size;
 	unsigned int		nest;
+	unsigned int		rehash;
 	u32			hash_rnd;
 	struct list_head	walkers;
 	struct rcu_head		rcu;
@@ -982,6 +987,189 @@ static inline void *rhashtable_lookup_get_insert_key(
 	return __rhashtable_insert_fast(ht, key, obj, params, false);
 }
 
+/* Internal function, please use rhashtable_lookup_insert_bulk_fast() instead.
+ * Links @obj into the locked bucket unless an object with the same key is
+ * already there.  @nelems is the number of elements in the table without
+ * the ones the caller is still about to insert.  Returns -EAGAIN when the
+ * slow path has to be taken.
+ */
+static inline int __rhashtable_insert_bulk_one(
+	struct rhashtable *ht, struct bucket_table *tbl,
+	struct rhash_lock_head __rcu **bkt, unsigned int hash,
+	struct rhash_head *obj, unsigned int nelems,
+	const struct rhashtable_params params)
+{
+	struct rhashtable_compare_arg arg = {
+		.ht = ht,
+		.key = (const char *)rht_obj(ht, obj) + ht->p.key_offset,
+	};
+	struct rhash_head *head;
+	int elasticity = RHT_ELASTICITY;
+
+	rht_for_each_from(head, rht_ptr(bkt, tbl, hash), tbl, hash) {
+		elasticity--;
+		if (!(params.obj_cmpfn ?
+		      params.obj_cmpfn(&arg, rht_obj(ht, head)) :
+		      rhashtable_compare(&arg, rht_obj(ht, head))))
+			return -EEXIST;
+	}
+
+	if (elasticity <= 0)
+		return -EAGAIN;
+
+	if (unlikely(nelems >= ht->max_elems))
+		return -E2BIG;
+
+	/* As rht_grow_above_100() */
+	if (unlikely(nelems > tbl->size &&
+		     (!ht->p.max_size || tbl->size < ht->p.max_size)))
+		return -EAGAIN;
+
+	head = rht_ptr(bkt, tbl, hash);
+	RCU_INIT_POINTER(obj->next, head);
+
+	/* bkt is the head of the list and holds the lock */
+	rht_assign_locked(bkt, obj);
+
+	return 0;
+}
+
+/* Internal function, please use rhashtable_lookup_insert_bulk_fast() instead.
+ * Inserts up to RHT_BULK_BATCH objects and returns a mask of those that
+ * could be inserted.
+ */
+static inline unsigned long __rhashtable_insert_bulk_batch(
+	struct rhashtable *ht, struct rhash_head **objs, unsigned int cnt,
+	const struct rhashtable_params params)
+{
+	unsigned int hashes[RHT_BULK_BATCH];
+	unsigned long todo = BIT(cnt) - 1;
+	unsigned long inserted = 0;
+	unsigned long slow = 0;
+	struct rhash_lock_head __rcu **bkt;
+	struct bucket_table *tbl;
+	unsigned int added = 0;
+	unsigned int i, j;
+
+	rcu_read_lock();
+
+	tbl = rht_dereference_rcu(ht->tbl, ht);
+	if (unlikely(rcu_access_pointer(tbl->future_tbl)))
+		goto slow_path;
+
+	/* Hash everything first so that the bucket loads overlap. */
+	for (i = 0; i < cnt; i++) {
+		hashes[i] = rht_head_hashfn(ht, tbl, objs[i], params);
+		if (likely(!tbl->nest))
+			prefetchw(&tbl->buckets[hashes[i]]);
+	}
+
+	/* Reserve the elements up front rather than counting each one. */
+	atomic_add(cnt, &ht->nelems);
+
+	for_each_set_bit(i, &todo, cnt) {
+		bkt = rht_bucket_insert(ht, tbl, hashes[i]);
+		if (!bkt)
+			break;
+		rht_lock(tbl, bkt);
+		if (unlikely(rcu_access_pointer(tbl->future_tbl))) {
+			rht_unlock(tbl, bkt);
+			break;
+		}
+
+		/* Everything else in the batch for this bucket goes in too. */
+		j = i;
+		for_each_set_bit_from(j, &todo, cnt) {
+			unsigned int nelems;
+			int err;
+
+			if (hashes[j] != hashes[i])
+				continue;
+
+			nelems = atomic_read(&ht->nelems) - (cnt - added);
+			err = __rhashtable_insert_bulk_one(ht, tbl, bkt,
+							   hashes[j], objs[j],
+							   nelems, params);
+			__clear_bit(j, &todo);
+			if (!err) {
+				__set_bit(j, &inserted);
+				added++;
+			} else if (err == -EAGAIN) {
+				__set_bit(j, &slow);
+			}
+		}
+
+		rht_unlock(tbl, bkt);
+	}
+
+	if (cnt != added)
+		atomic_sub(cnt - added, &ht->nelems);
+	if (added && rht_grow_above_75(ht, tbl))
+		schedule_work(&ht->run_work);
+
+	/* The rest could not take the fast path. */
+	todo |= slow;
+
+slow_path:
+	rcu_read_unlock();
+
+	for_each_set_bit(i, &todo, cnt) {
+		const char *key = rht_obj(ht, objs[i]);
+
+		if (!rhashtable_insert_slow(ht, key + ht->p.key_offset, objs[i]))
+			__set_bit(i, &inserted);
+	}
+
+	return inserted;
+}
+
+/**
+ * rhashtable_lookup_insert_bulk_fast - lookup and insert objects into hash table
+ * @ht:		hash table
+ * @objs:	array of pointers to the hash heads inside the objects
+ * @n:		number of objects in @objs
+ * @params:	hash table parameters
+ *
+ * Like rhashtable_lookup_insert_fast() for each of @objs, but the objects
+ * are hashed in batches of RHT_BULK_BATCH before any bucket is locked,
+ * objects that hash to the same bucket are inserted under a single bucket
+ * lock, and the element count is only updated once per batch.  Objects
+ * that are inserted become visible to lookups one at a time.
+ *
+ * This lookup function may only be used for fixed key hash table (key_len
+ * parameter set), and not on an rhltable.  It will BUG() if used
+ * inappropriately.
+ *
+ * It is safe to call this function from atomic context.
+ *
+ * Returns the number of objects inserted.  @objs is reordered so that
+ * these come first; the remaining ones were not inserted, usually because
+ * an object with the same key is already in the table.
+ * rhashtable_lookup_insert_fast() reports the reason for any of them.
+ */
+static inline unsigned int rhashtable_lookup_insert_bulk_fast(
+	struct rhashtable *ht, struct rhash_head **objs, unsigned int n,
+	const struct rhashtable_params params)
+{
+	unsigned int done, cnt, i, ins = 0;
+	unsigned long inserted;
+
+	BUG_ON(ht->p.obj_hashfn || ht->rhlist);
+
+	for (done = 0; done < n; done += cnt) {
+		cnt = min(n - done, RHT_BULK_BATCH);
+		inserted = __rhashtable_insert_bulk_batch(ht, objs + done, cnt,
+							  params);
+
+		for_each_set_bit(i, &inserted, cnt) {
+			swap(objs[ins], objs[done + i]);
+			ins++;
+		}
+	}
+
+	return ins;
+}
+
 /* Internal function, please use rhashtable_remove_fast() instead */
 static inline int __rhashtable_remove_fast_one(
 	struct rhashtable *ht, struct bucket_table *tbl,
@@ -282,6 +282,19 @@ __copy_from_user_inatomic_nocache(void *to, const void __user *from,
 
 #endif		/* ARCH_HAS_NOCACHE_UACCESS */
 
+/*
+ * Non-temporal stores to user memory, for copies to a buffer that will not
+ * be read again soon.  Architectures without them just do a normal copy.
+ */
+#ifndef __copy_to_user_inatomic_nocache
+static inline __must_check unsigned long
+__copy_to_user_inatomic_nocache(void __user *to, const void *from,
+				unsigned long n)
+{
+	return __copy_to_user_inatomic(to, from, n);
+}
+#endif
+
 extern __must_check int check_zeroed_user(const void __user *from, size_t size);
 
 /**
@@ -25,6 +25,7 @@ enum iter_type {
 	ITER_PIPE,
 	ITER_XARRAY,
 	ITER_DISCARD,
+	ITER_UBUF,
 };
 
 struct iov_iter_state {
@@ -40,6 +41,7 @@ struct iov_iter {
 	size_t iov_offset;
 	size_t count;
 	union {
+		void __user *ubuf;
 		const struct iovec *iov;
 		const struct kvec *kvec;
 		const struct bio_vec *bvec;
@@ -74,6 +76,17 @@ static inline bool iter_is_iovec(const struct iov_iter *i)
 	return iov_iter_type(i) == ITER_IOVEC;
 }
 
+static inline bool iter_is_ubuf(const struct iov_iter *i)
+{
+	return iov_iter_type(i) == ITER_UBUF;
+}
+
+/* Is this iterator backed by user memory, whatever its layout? */
+static inline bool user_backed_iter(const struct iov_iter *i)
+{
+	return iter_is_ubuf(i) || iter_is_iovec(i);
+}
+
 static inline bool iov_iter_is_kvec(const struct iov_iter *i)
 {
 	return iov_iter_type(i) == ITER_KVEC;
@@ -123,6 +136,11 @@ static inline size_t iov_length(const struct iovec *iov, unsigned long nr_segs)
 
 static inline struct iovec iov_iter_iovec(const struct iov_iter *iter)
 {
+	if (iter_is_ubuf(iter))
+		return (struct iovec) {
+			.iov_base = iter->ubuf + iter->iov_offset,
+			.iov_len = iter->count,
+		};
 	return (struct iovec) {
 		.iov_base = iter->iov->iov_base + iter->iov_offset,
 		.iov_len = min(iter->count,
@@ -130,6 +148,21 @@ static inline struct iovec iov_iter_iovec(const struct iov_iter *iter)
 	};
 }
 
+/*
+ * The iovec array of a user backed iterator, for the drivers that hand
+ * the segments to their hardware themselves.  The single buffer of an
+ * ITER_UBUF iterator, as write(2) builds, is described in @ubuf_iov.
+ */
+static inline const struct iovec *user_iter_iov(const struct iov_iter *i,
+						struct iovec *ubuf_iov)
+{
+	if (iter_is_ubuf(i)) {
+		*ubuf_iov = iov_iter_iovec(i);
+		return ubuf_iov;
+	}
+	return i->iov;
+}
+
 size_t copy_page_from_iter_atomic(struct page *page, unsigned offset,
 				  size_t bytes, struct iov_iter *i);
 void iov_iter_advance(struct iov_iter *i, size_t bytes);
@@ -139,10 +172,13 @@ size_t fault_in_iov_iter_writeable(const struct iov_iter *i, size_t bytes);
 size_t iov_iter_single_seg_count(const struct iov_iter *i);
 size_t copy_page_to_iter(struct page *page, size_t offset, size_t bytes,
 			 struct iov_iter *i);
+size_t copy_page_to_iter_nocache(struct page *page, size_t offset,
+				 size_t bytes, struct iov_iter *i);
 size_t copy_page_from_iter(struct page *page, size_t offset, size_t bytes,
 			 struct iov_iter *i);
 
 size_t _copy_to_iter(const void *addr, size_t bytes, struct iov_iter *i);
+size_t _copy_to_iter_nocache(const void *addr, size_t bytes, struct iov_iter *i);
 size_t _copy_from_iter(void *addr, size_t bytes, struct iov_iter *i);
 size_t _copy_from_iter_nocache(void *addr, size_t bytes, struct iov_iter *i);
 
@@ -155,6 +191,15 @@ size_t copy_to_iter(const void *addr, size_t bytes, struct iov_iter *i)
 		return _copy_to_iter(addr, bytes, i);
 }
 
+static __always_inline __must_check
+size_t copy_to_iter_nocache(const void *addr, size_t bytes, struct iov_iter *i)
+{
+	if (unlikely(!check_copy_size(addr, bytes, true)))
+		return 0;
+	else
+		return _copy_to_iter_nocache(addr, bytes, i);
+}
+
 static __always_inline __must_check
 size_t copy_from_iter(void *addr, size_t bytes, struct iov_iter *i)
 {
@@ -234,6 +279,8 @@ unsigned long iov_iter_alignment(const struct iov_iter *i);
 unsigned long iov_iter_gap_alignment(const struct iov_iter *i);
 void iov_iter_init(struct iov_iter *i, unsigned int direction, const struct iovec *iov,
 			unsigned long nr_segs, size_t count);
+void iov_iter_ubuf(struct iov_iter *i, unsigned int direction, void __user *buf,
+			size_t count);
 void iov_iter_kvec(struct iov_iter *i, unsigned int direction, const struct kvec *kvec,
 			unsigned long nr_segs, size_t count);
 void iov_iter_bvec(struct iov_iter *i, unsigned int direction, const struct bio_vec *bvec,
@@ -316,5 +363,6 @@ ssize_t __import_iovec(int type, const struct iovec __user *uvec,
 		 struct iov_iter *i, bool compat);
 int import_single_range(int type, void __user *buf, size_t len,
 		 struct iovec *iov, struct iov_iter *i);
+int import_ubuf(int type, void __user *buf, size_t len, struct iov_iter *i);
 
 #endif
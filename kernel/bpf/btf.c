@@ -5495,11 +5495,13 @@ static int btf_check_func_arg_match(struct bpf_verifier_env *env,
 	enum bpf_prog_type prog_type = env->prog->type == BPF_PROG_TYPE_EXT ?
 		env->prog->aux->dst_prog->type : env->prog->type;
 	struct bpf_verifier_log *log = &env->log;
+	u32 i, nargs, ref_id, ref_obj_id = 0;
 	bool is_kfunc = btf_is_kernel(btf);
 	const char *func_name, *ref_tname;
 	const struct btf_type *t, *ref_t;
 	const struct btf_param *args;
-	u32 i, nargs, ref_id;
+	int ref_regno = 0;
+	bool rel = false;
 
 	t = btf_type_by_id(btf, func_id);
 	if (!t || !btf_type_is_func(t)) {
@@ -5525,6 +5527,11 @@ static int btf_check_func_arg_match(struct bpf_verifier_env *env,
 		return -EINVAL;
 	}
 
+	/* Only kfunc can be release func */
+	if (is_kfunc)
+		rel = btf_kfunc_id_set_contains(env->prog,
+						BTF_KFUNC_TYPE_RELEASE,
+						func_id);
 	/* check that BTF function arguments match actual types that the
 	 * verifier sees.
 	 */
@@ -5595,6 +5602,24 @@ static int btf_check_func_arg_match(struct bpf_verifier_env *env,
 					reg_ref_tname);
 				return -EINVAL;
 			}
+
+			if (reg->ref_obj_id) {
+				if (ref_obj_id) {
+					bpf_log(log, "verifier internal error: more than one arg with ref_obj_id R%d %u %u\n",
+						regno, reg->ref_obj_id, ref_obj_id);
+					return -EFAULT;
+				}
+				/* The released object must be the one that
+				 * was acquired, not an embedded member.
+				 */
+				if (rel && reg->off) {
+					bpf_log(log, "R%d must have zero offset when passed to release func\n",
+						regno);
+					return -EINVAL;
+				}
+				ref_regno = regno;
+				ref_obj_id = reg->ref_obj_id;
+			}
 		} else if (ptr_to_mem_ok) {
 			const struct btf_type *resolve_ret;
 			u32 type_size;
@@ -5631,7 +5656,13 @@ static int btf_check_func_arg_match(struct bpf_verifier_env *env,
 		}
 	}
 
-	return 0;
+	if (rel && !ref_obj_id) {
+		bpf_log(log, "release kernel function %s expects refcounted PTR_TO_BTF_ID\n",
+			func_name);
+		return -EINVAL;
+	}
+	/* returns argument register number > 0 in case of reference release kfunc */
+	return rel ? ref_regno : 0;
 }
 
 /* Compare BTF of a function with given bpf_reg_state.
@@ -6073,6 +6104,98 @@ bool btf_id_set_contains(const struct btf_id_set *set, u32 id)
 	return bsearch(&id, set->ids, set->cnt, sizeof(u32), btf_id_cmp_func) != NULL;
 }
 
+/* Kernel function (kfunc) BTF ID sets
+ *
+ * Built-in kernel code registers the vmlinux functions that a group of
+ * program types may call directly. The verifier consults these sets in
+ * check_kfunc_call() in addition to bpf_verifier_ops::check_kfunc_call.
+ * Registration happens from initcalls, before any program can be loaded,
+ * so lookups only need to observe a consistent set count.
+ */
+enum btf_kfunc_hook {
+	BTF_KFUNC_HOOK_XDP,
+	BTF_KFUNC_HOOK_TC,
+	BTF_KFUNC_HOOK_STRUCT_OPS,
+	BTF_KFUNC_HOOK_TRACING,
+	BTF_KFUNC_HOOK_MAX,
+};
+
+#define BTF_KFUNC_SET_MAX_CNT	8
+
+struct btf_kfunc_set_tab {
+	const struct btf_kfunc_id_set *sets[BTF_KFUNC_HOOK_MAX][BTF_KFUNC_SET_MAX_CNT];
+	u32 cnt[BTF_KFUNC_HOOK_MAX];
+};
+
+static struct btf_kfunc_set_tab btf_kfunc_set_tab;
+static DEFINE_MUTEX(btf_kfunc_set_mutex);
+
+static int bpf_prog_type_to_kfunc_hook(enum bpf_prog_type prog_type)
+{
+	switch (prog_type) {
+	case BPF_PROG_TYPE_XDP:
+		return BTF_KFUNC_HOOK_XDP;
+	case BPF_PROG_TYPE_SCHED_CLS:
+	case BPF_PROG_TYPE_SCHED_ACT:
+		return BTF_KFUNC_HOOK_TC;
+	case BPF_PROG_TYPE_STRUCT_OPS:
+		return BTF_KFUNC_HOOK_STRUCT_OPS;
+	case BPF_PROG_TYPE_TRACING:
+	case BPF_PROG_TYPE_LSM:
+		return BTF_KFUNC_HOOK_TRACING;
+	default:
+		return BTF_KFUNC_HOOK_MAX;
+	}
+}
+
+bool btf_kfunc_id_set_contains(const struct bpf_prog *prog,
+			       enum btf_kfunc_type type, u32 kfunc_btf_id)
+{
+	enum bpf_prog_type prog_type = prog->type == BPF_PROG_TYPE_EXT ?
+		prog->aux->dst_prog->type : prog->type;
+	const struct btf_kfunc_id_set *kset;
+	int hook;
+	u32 i, cnt;
+
+	hook = bpf_prog_type_to_kfunc_hook(prog_type);
+	if (hook == BTF_KFUNC_HOOK_MAX || type >= BTF_KFUNC_TYPE_MAX)
+		return false;
+
+	/* Pairs with smp_store_release() in register_btf_kfunc_id_set() */
+	cnt = smp_load_acquire(&btf_kfunc_set_tab.cnt[hook]);
+	for (i = 0; i < cnt; i++) {
+		kset = btf_kfunc_set_tab.sets[hook][i];
+		if (kset->sets[type] &&
+		    btf_id_set_contains(kset->sets[type], kfunc_btf_id))
+			return true;
+	}
+	return false;
+}
+
+int register_btf_kfunc_id_set(enum bpf_prog_type prog_type,
+			      const struct btf_kfunc_id_set *kset)
+{
+	int hook, ret = 0;
+	u32 cnt;
+
+	hook = bpf_prog_type_to_kfunc_hook(prog_type);
+	if (hook == BTF_KFUNC_HOOK_MAX || !kset->check_set)
+		return -EINVAL;
+
+	mutex_lock(&btf_kfunc_set_mutex);
+	cnt = btf_kfunc_set_tab.cnt[hook];
+	if (cnt == BTF_KFUNC_SET_MAX_CNT) {
+		ret = -E2BIG;
+		goto unlock;
+	}
+	btf_kfunc_set_tab.sets[hook][cnt] = kset;
+	smp_store_release(&btf_kfunc_set_tab.cnt[hook], cnt + 1);
+unlock:
+	mutex_unlock(&btf_kfunc_set_mutex);
+	return ret;
+}
+EXPORT_SYMBOL_GPL(register_btf_kfunc_id_set);
+
 enum {
 	BTF_MODULE_F_LIVE = (1 << 0),
 };
@@ -17,6 +17,8 @@
 #include <linux/error-injection.h>
 #include <linux/btf_ids.h>
 #include <linux/bpf_lsm.h>
+#include <linux/sort.h>
+#include <linux/bsearch.h>
 
 #include <net/bpf_sk_storage.h>
 
@@ -1005,6 +1007,21 @@ static const struct bpf_func_proto bpf_get_func_ip_proto_kprobe = {
 	.arg1_type	= ARG_PTR_TO_CTX,
 };
 
+static u64 bpf_kprobe_multi_entry_ip(struct bpf_run_ctx *ctx);
+
+BPF_CALL_1(bpf_get_func_ip_kprobe_multi, struct pt_regs *, regs)
+{
+	/* kprobe multi runs from ftrace, there is no kprobe_running() */
+	return bpf_kprobe_multi_entry_ip(current->bpf_ctx);
+}
+
+static const struct bpf_func_proto bpf_get_func_ip_proto_kprobe_multi = {
+	.func		= bpf_get_func_ip_kprobe_multi,
+	.gpl_only	= true,
+	.ret_type	= RET_INTEGER,
+	.arg1_type	= ARG_PTR_TO_CTX,
+};
+
 BPF_CALL_1(bpf_get_attach_cookie_trace, void *, ctx)
 {
 	struct bpf_trace_run_ctx *run_ctx;
@@ -1165,7 +1182,9 @@ kprobe_prog_func_proto(enum bpf_func_id func_id, const struct bpf_prog *prog)
 		return &bpf_override_return_proto;
 #endif
 	case BPF_FUNC_get_func_ip:
-		return &bpf_get_func_ip_proto_kprobe;
+		return prog->expected_attach_type == BPF_TRACE_KPROBE_MULTI ?
+			&bpf_get_func_ip_proto_kprobe_multi :
+			&bpf_get_func_ip_proto_kprobe;
 	case BPF_FUNC_get_attach_cookie:
 		return &bpf_get_attach_cookie_proto_trace;
 	default:
@@ -2068,3 +2087,356 @@ static int __init bpf_event_init(void)
 
 fs_initcall(bpf_event_init);
 #endif /* CONFIG_MODULES */
+
+#ifdef CONFIG_DYNAMIC_FTRACE_WITH_REGS
+struct bpf_kprobe_multi_entry {
+	unsigned long addr;
+	u64 cookie;
+};
+
+/* One kretprobe per function for the return probes */
+struct bpf_kprobe_multi_rp {
+	struct kretprobe rp;
+	struct bpf_kprobe_multi_link *link;
+	u64 cookie;
+};
+
+struct bpf_kprobe_multi_link {
+	struct bpf_link link;
+	struct ftrace_ops ops;
+	/* sorted by address, for the cookie lookup */
+	struct bpf_kprobe_multi_entry *entries;
+	unsigned long *addrs;
+	u32 cnt;
+	/* only for BPF_F_KPROBE_MULTI_RETURN */
+	struct bpf_kprobe_multi_rp *rps;
+	struct kretprobe **rpp;
+};
+
+struct bpf_kprobe_multi_run_ctx {
+	struct bpf_trace_run_ctx trace_ctx;
+	unsigned long entry_ip;
+};
+
+static u64 bpf_kprobe_multi_entry_ip(struct bpf_run_ctx *ctx)
+{
+	struct bpf_kprobe_multi_run_ctx *run_ctx;
+
+	run_ctx = container_of(ctx, struct bpf_kprobe_multi_run_ctx,
+			       trace_ctx.run_ctx);
+	return run_ctx->entry_ip;
+}
+
+static void bpf_kprobe_multi_link_release(struct bpf_link *link)
+{
+	struct bpf_kprobe_multi_link *kmulti_link;
+
+	kmulti_link = container_of(link, struct bpf_kprobe_multi_link, link);
+	if (kmulti_link->rpp)
+		unregister_kretprobes(kmulti_link->rpp, kmulti_link->cnt);
+	else
+		unregister_ftrace_function(&kmulti_link->ops);
+}
+
+static void bpf_kprobe_multi_link_dealloc(struct bpf_link *link)
+{
+	struct bpf_kprobe_multi_link *kmulti_link;
+
+	kmulti_link = container_of(link, struct bpf_kprobe_multi_link, link);
+	ftrace_free_filter(&kmulti_link->ops);
+	kvfree(kmulti_link->rpp);
+	kvfree(kmulti_link->rps);
+	kvfree(kmulti_link->entries);
+	kvfree(kmulti_link->addrs);
+	kfree(kmulti_link);
+}
+
+static const struct bpf_link_ops bpf_kprobe_multi_link_lops = {
+	.release = bpf_kprobe_multi_link_release,
+	.dealloc = bpf_kprobe_multi_link_dealloc,
+};
+
+static int bpf_kprobe_multi_entry_cmp(const void *a, const void *b)
+{
+	const struct bpf_kprobe_multi_entry *ea = a, *eb = b;
+
+	if (ea->addr == eb->addr)
+		return 0;
+	return ea->addr < eb->addr ? -1 : 1;
+}
+
+static u64 bpf_kprobe_multi_cookie(struct bpf_kprobe_multi_link *link,
+				   unsigned long ip)
+{
+	struct bpf_kprobe_multi_entry key = { .addr = ip }, *entry;
+
+	entry = bsearch(&key, link->entries, link->cnt, sizeof(key),
+			bpf_kprobe_multi_entry_cmp);
+	return entry ? entry->cookie : 0;
+}
+
+/* Called with preemption disabled */
+static void
+kprobe_multi_link_prog_run(struct bpf_kprobe_multi_link *link,
+			   unsigned long entry_ip, u64 cookie,
+			   struct pt_regs *regs)
+{
+	struct bpf_kprobe_multi_run_ctx run_ctx = {
+		.trace_ctx.bpf_cookie = cookie,
+		.entry_ip = entry_ip,
+	};
+	struct bpf_run_ctx *old_run_ctx;
+
+	if (unlikely(__this_cpu_inc_return(bpf_prog_active) != 1))
+		goto out;
+
+	migrate_disable();
+	rcu_read_lock();
+	old_run_ctx = bpf_set_run_ctx(&run_ctx.trace_ctx.run_ctx);
+	bpf_prog_run(link->link.prog, regs);
+	bpf_reset_run_ctx(old_run_ctx);
+	rcu_read_unlock();
+	migrate_enable();
+
+ out:
+	__this_cpu_dec(bpf_prog_active);
+}
+
+static void
+kprobe_multi_link_handler(unsigned long ip, unsigned long parent_ip,
+			  struct ftrace_ops *ops, struct ftrace_regs *fregs)
+{
+	struct pt_regs *regs = ftrace_get_regs(fregs);
+	struct bpf_kprobe_multi_link *link;
+	int bit;
+
+	if (!regs)
+		return;
+
+	bit = ftrace_test_recursion_trylock(ip, parent_ip);
+	if (bit < 0)
+		return;
+
+	link = container_of(ops, struct bpf_kprobe_multi_link, ops);
+	preempt_disable_notrace();
+	kprobe_multi_link_prog_run(link, ip, bpf_kprobe_multi_cookie(link, ip),
+				   regs);
+	preempt_enable_notrace();
+	ftrace_test_recursion_unlock(bit);
+}
+
+#ifdef CONFIG_KRETPROBES
+static int
+kprobe_multi_link_ret_handler(struct kretprobe_instance *ri,
+			      struct pt_regs *regs)
+{
+	struct bpf_kprobe_multi_rp *mrp;
+
+	mrp = container_of(get_kretprobe(ri), struct bpf_kprobe_multi_rp, rp);
+	kprobe_multi_link_prog_run(mrp->link, (unsigned long)mrp->rp.kp.addr,
+				   mrp->cookie, regs);
+	return 0;
+}
+
+/*
+ * There is no return hook on top of ftrace in this tree, so the return
+ * probes are kretprobes.  They are registered in one call, but every
+ * function still gets its own kprobe.
+ */
+static int kprobe_multi_link_register_ret(struct bpf_kprobe_multi_link *link)
+{
+	u32 i;
+
+	link->rps = kvcalloc(link->cnt, sizeof(*link->rps), GFP_KERNEL);
+	link->rpp = kvmalloc_array(link->cnt, sizeof(*link->rpp), GFP_KERNEL);
+	if (!link->rps || !link->rpp)
+		return -ENOMEM;
+
+	for (i = 0; i < link->cnt; i++) {
+		struct bpf_kprobe_multi_rp *mrp = &link->rps[i];
+
+		mrp->rp.kp.addr = (kprobe_opcode_t *)link->entries[i].addr;
+		mrp->rp.handler = kprobe_multi_link_ret_handler;
+		mrp->link = link;
+		mrp->cookie = link->entries[i].cookie;
+		link->rpp[i] = &mrp->rp;
+	}
+
+	return register_kretprobes(link->rpp, link->cnt);
+}
+#else
+static int kprobe_multi_link_register_ret(struct bpf_kprobe_multi_link *link)
+{
+	return -EOPNOTSUPP;
+}
+#endif
+
+static int
+kprobe_multi_resolve_syms(const char __user * const __user *usyms, u32 cnt,
+			  unsigned long *addrs)
+{
+	unsigned long addr, usymbol;
+	char *func;
+	int err = 0;
+	u32 i;
+
+	func = kmalloc(KSYM_NAME_LEN, GFP_KERNEL);
+	if (!func)
+		return -ENOMEM;
+
+	for (i = 0; i < cnt; i++) {
+		if (get_user(usymbol, (unsigned long __user *)(usyms + i))) {
+			err = -EFAULT;
+			break;
+		}
+		err = strncpy_from_user(func, (const char __user *)usymbol,
+					KSYM_NAME_LEN);
+		if (err == KSYM_NAME_LEN)
+			err = -E2BIG;
+		if (err < 0)
+			break;
+		addr = kallsyms_lookup_name(func);
+		if (!addr) {
+			err = -ENOENT;
+			break;
+		}
+		addrs[i] = addr;
+		err = 0;
+		cond_resched();
+	}
+
+	kfree(func);
+	return err;
+}
+
+/* Attach @prog to all the functions in attr->link_create.kprobe_multi with
+ * one ftrace_ops, so that the call sites are patched in a single ftrace
+ * update instead of one kprobe registration per function.  Return probes,
+ * BPF_F_KPROBE_MULTI_RETURN, use a kretprobe per function instead.
+ */
+int bpf_kprobe_multi_link_attach(const union bpf_attr *attr, struct bpf_prog *prog)
+{
+	struct bpf_kprobe_multi_entry *entries = NULL;
+	struct bpf_kprobe_multi_link *link = NULL;
+	struct bpf_link_primer link_primer;
+	void __user *uaddrs, *usyms;
+	u64 __user *ucookies;
+	unsigned long *addrs;
+	u32 flags, cnt, i;
+	int err;
+
+	/* no support for 32bit archs yet */
+	if (sizeof(u64) != sizeof(void *))
+		return -EOPNOTSUPP;
+
+	if (prog->expected_attach_type != BPF_TRACE_KPROBE_MULTI)
+		return -EINVAL;
+
+	/* bpf_override_return() relies on a kprobe being hit */
+	if (prog->kprobe_override)
+		return -EINVAL;
+
+	flags = attr->link_create.kprobe_multi.flags;
+	if (flags & ~BPF_F_KPROBE_MULTI_RETURN)
+		return -EINVAL;
+
+	uaddrs = u64_to_user_ptr(attr->link_create.kprobe_multi.addrs);
+	usyms = u64_to_user_ptr(attr->link_create.kprobe_multi.syms);
+	if (!!uaddrs == !!usyms)
+		return -EINVAL;
+
+	cnt = attr->link_create.kprobe_multi.cnt;
+	if (!cnt)
+		return -EINVAL;
+
+	addrs = kvmalloc_array(cnt, sizeof(*addrs), GFP_KERNEL);
+	if (!addrs)
+		return -ENOMEM;
+
+	if (uaddrs) {
+		if (copy_from_user(addrs, uaddrs, array_size(cnt, sizeof(*addrs)))) {
+			err = -EFAULT;
+			goto error;
+		}
+	} else {
+		err = kprobe_multi_resolve_syms(usyms, cnt, addrs);
+		if (err)
+			goto error;
+	}
+
+	entries = kvmalloc_array(cnt, sizeof(*entries), GFP_KERNEL);
+	if (!entries) {
+		err = -ENOMEM;
+		goto error;
+	}
+
+	ucookies = u64_to_user_ptr(attr->link_create.kprobe_multi.cookies);
+	for (i = 0; i < cnt; i++) {
+		u64 cookie = 0;
+
+		if (ucookies && get_user(cookie, ucookies + i)) {
+			err = -EFAULT;
+			goto error;
+		}
+		entries[i].addr = addrs[i];
+		entries[i].cookie = cookie;
+	}
+
+	sort(entries, cnt, sizeof(*entries), bpf_kprobe_multi_entry_cmp, NULL);
+	for (i = 1; i < cnt; i++) {
+		if (entries[i].addr == entries[i - 1].addr) {
+			err = -EINVAL;
+			goto error;
+		}
+	}
+
+	link = kzalloc(sizeof(*link), GFP_KERNEL);
+	if (!link) {
+		err = -ENOMEM;
+		goto error;
+	}
+
+	bpf_link_init(&link->link, BPF_LINK_TYPE_KPROBE_MULTI,
+		      &bpf_kprobe_multi_link_lops, prog);
+
+	err = bpf_link_prime(&link->link, &link_primer);
+	if (err)
+		goto error;
+
+	link->entries = entries;
+	link->addrs = addrs;
+	link->cnt = cnt;
+
+	if (flags & BPF_F_KPROBE_MULTI_RETURN) {
+		err = kprobe_multi_link_register_ret(link);
+	} else {
+		link->ops.func = kprobe_multi_link_handler;
+		link->ops.flags = FTRACE_OPS_FL_SAVE_REGS | FTRACE_OPS_FL_RCU;
+		err = ftrace_set_filter_ips(&link->ops, addrs, cnt, 0, 0);
+		if (!err)
+			err = register_ftrace_function(&link->ops);
+	}
+	if (err) {
+		/* frees addrs, entries and the kretprobes through ->dealloc() */
+		bpf_link_cleanup(&link_primer);
+		return err;
+	}
+
+	return bpf_link_settle(&link_primer);
+
+error:
+	kfree(link);
+	kvfree(entries);
+	kvfree(addrs);
+	return err;
+}
+#else /* !CONFIG_DYNAMIC_FTRACE_WITH_REGS */
+int bpf_kprobe_multi_link_attach(const union bpf_attr *attr, struct bpf_prog *prog)
+{
+	return -EOPNOTSUPP;
+}
+static u64 bpf_kprobe_multi_entry_ip(struct bpf_run_ctx *ctx)
+{
+	return 0;
+}
+#endif
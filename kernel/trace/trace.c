@@ -1212,6 +1212,10 @@ int tracing_alloc_snapshot_instance(struct trace_array *tr)
 
 	if (!tr->allocated_snapshot) {
 
+		/* The mapped buffers can't be swapped with the snapshot */
+		if (tr->mapped)
+			return -EBUSY;
+
 		/* allocate spare buffer */
 		ret = resize_buffer_duplicate_size(&tr->max_buffer,
 				   &tr->array_buffer, RING_BUFFER_ALL_CPUS);
@@ -5764,6 +5768,8 @@ static const char readme_msg[] =
 	"\t            .syscall    display a syscall id as a syscall name\n"
 	"\t            .log2       display log2 value rather than raw number\n"
 	"\t            .buckets=size  display values in groups of size rather than raw number\n"
+	"\t            .loglin[=bits] display values in log-linear buckets, each power\n"
+	"\t                        of two split in 2^bits (default 3) linear buckets\n"
 	"\t            .usecs      display a common_timestamp in microseconds\n\n"
 	"\t    The 'pause' parameter can be used to pause an existing hist\n"
 	"\t    trigger or to start a hist trigger but not log any events\n"
@@ -5772,6 +5778,13 @@ static const char readme_msg[] =
 	"\t    The 'clear' parameter will clear the contents of a running\n"
 	"\t    hist trigger and leave its current paused/active state\n"
 	"\t    unchanged.\n\n"
+	"\t    The 'percentiles' parameter appends the p50, p90, p99 and\n"
+	"\t    p99.9 of the hitcounts to the output of a hist trigger with\n"
+	"\t    a single numeric key, typically bucketed by .log2, .buckets\n"
+	"\t    or .loglin.\n\n"
+	"\t    The 'percpu' parameter keeps the sums in per-CPU counters,\n"
+	"\t    added up when the histogram is read, which avoids cacheline\n"
+	"\t    contention on keys hit from many CPUs at once.\n\n"
 	"\t    The enable_hist and disable_hist triggers can be used to\n"
 	"\t    have one event conditionally start and stop another event's\n"
 	"\t    already-attached hist trigger.  The syntax is analogous to\n"
@@ -8442,14 +8455,28 @@ tracing_buffers_splice_read(struct file *file, loff_t *ppos,
 	return ret;
 }
 
-/* An ioctl call with cmd 0 to the ring buffer file will wake up all waiters */
+/*
+ * An ioctl call with cmd 0 to the ring buffer file will wake up all waiters.
+ * TRACE_MMAP_IOCTL_GET_READER moves the reader of a mapped buffer forward.
+ */
 static long tracing_buffers_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 {
 	struct ftrace_buffer_info *info = file->private_data;
 	struct trace_iterator *iter = &info->iter;
+	int err;
 
-	if (cmd)
+	if (cmd == TRACE_MMAP_IOCTL_GET_READER) {
+		if (trace_empty(iter) && !(file->f_flags & O_NONBLOCK)) {
+			err = wait_on_pipe(iter, 0);
+			if (err)
+				return err;
+		}
+
+		return ring_buffer_map_get_reader(iter->array_buffer->buffer,
+						  iter->cpu_file);
+	} else if (cmd) {
 		return -ENOIOCTLCMD;
+	}
 
 	mutex_lock(&trace_types_lock);
 
@@ -8463,6 +8490,76 @@ static long tracing_buffers_ioctl(struct file *file, unsigned int cmd, unsigned
 	return 0;
 }
 
+/* mremap() and fork() copy the vma, each copy is closed on its own */
+static void tracing_buffers_mmap_open(struct vm_area_struct *vma)
+{
+	struct ftrace_buffer_info *info = vma->vm_file->private_data;
+	struct trace_iterator *iter = &info->iter;
+
+	WARN_ON(ring_buffer_map_dup(iter->array_buffer->buffer, iter->cpu_file));
+
+	mutex_lock(&trace_types_lock);
+	iter->tr->mapped++;
+	mutex_unlock(&trace_types_lock);
+}
+
+static void tracing_buffers_mmap_close(struct vm_area_struct *vma)
+{
+	struct ftrace_buffer_info *info = vma->vm_file->private_data;
+	struct trace_iterator *iter = &info->iter;
+
+	WARN_ON(ring_buffer_unmap(iter->array_buffer->buffer, iter->cpu_file));
+
+	mutex_lock(&trace_types_lock);
+	iter->tr->mapped--;
+	mutex_unlock(&trace_types_lock);
+}
+
+/* The mapping is accounted once per vma, it must not be split */
+static int tracing_buffers_mmap_may_split(struct vm_area_struct *vma,
+					  unsigned long addr)
+{
+	return -EINVAL;
+}
+
+static const struct vm_operations_struct tracing_buffers_vmops = {
+	.open		= tracing_buffers_mmap_open,
+	.close		= tracing_buffers_mmap_close,
+	.may_split	= tracing_buffers_mmap_may_split,
+};
+
+static int tracing_buffers_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct ftrace_buffer_info *info = filp->private_data;
+	struct trace_iterator *iter = &info->iter;
+	int ret;
+
+	if (iter->snapshot)
+		return -EBUSY;
+
+	mutex_lock(&trace_types_lock);
+
+	/* A snapshot swap would pull the mapped pages away */
+#ifdef CONFIG_TRACER_MAX_TRACE
+	if (iter->tr->allocated_snapshot) {
+		ret = -EBUSY;
+		goto out;
+	}
+#endif
+
+	ret = ring_buffer_map(iter->array_buffer->buffer, iter->cpu_file, vma);
+	if (ret)
+		goto out;
+
+	iter->tr->mapped++;
+	vma->vm_ops = &tracing_buffers_vmops;
+
+ out:
+	mutex_unlock(&trace_types_lock);
+
+	return ret;
+}
+
 static const struct file_operations tracing_buffers_fops = {
 	.open		= tracing_buffers_open,
 	.read		= tracing_buffers_read,
@@ -8471,6 +8568,7 @@ static const struct file_operations tracing_buffers_fops = {
 	.flush		= tracing_buffers_flush,
 	.splice_read	= tracing_buffers_splice_read,
 	.unlocked_ioctl = tracing_buffers_ioctl,
+	.mmap		= tracing_buffers_mmap,
 	.llseek		= no_llseek,
 };
 
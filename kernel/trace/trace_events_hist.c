@@ -66,7 +66,8 @@
 	C(EMPTY_SORT_FIELD,	"Empty sort field"),			\
 	C(TOO_MANY_SORT_FIELDS,	"Too many sort fields (Max = 2)"),	\
 	C(INVALID_SORT_FIELD,	"Sort field must be a key or a val"),	\
-	C(INVALID_STR_OPERAND,	"String type can not be an operand in expression"),
+	C(INVALID_STR_OPERAND,	"String type can not be an operand in expression"), \
+	C(INVALID_PERCENTILES,	"Percentiles need a single numeric key"),
 
 #undef C
 #define C(a, b)		HIST_ERR_##a
@@ -121,6 +122,7 @@ struct hist_field {
 	unsigned int			size;
 	unsigned int			offset;
 	unsigned int                    is_signed;
+	/* bucket size for .buckets, sub-bucket bits for .loglin */
 	unsigned long			buckets;
 	const char			*type;
 	struct hist_field		*operands[HIST_FIELD_OPERANDS_MAX];
@@ -241,6 +243,39 @@ static u64 hist_field_bucket(struct hist_field *hist_field,
 	return val * buckets;
 }
 
+#define HIST_LOGLIN_BITS_DEFAULT	3
+#define HIST_LOGLIN_BITS_MAX		10
+
+/*
+ * Log-linear (HDR-style) buckets: each power of two is split into
+ * 2^bits linear sub-buckets, so that the bucket width stays within
+ * 1/2^bits of the value whatever its magnitude.  Values below
+ * 2^(bits + 1) are kept exact.
+ */
+static unsigned int hist_loglin_shift(u64 val, unsigned long bits)
+{
+	if (val < (2ULL << bits))
+		return 0;
+
+	return fls64(val) - 1 - bits;
+}
+
+static u64 hist_field_loglin(struct hist_field *hist_field,
+			     struct tracing_map_elt *elt,
+			     struct trace_buffer *buffer,
+			     struct ring_buffer_event *rbe,
+			     void *event)
+{
+	struct hist_field *operand = hist_field->operands[0];
+	unsigned int shift;
+
+	u64 val = operand->fn(operand, elt, buffer, rbe, event);
+
+	shift = hist_loglin_shift(val, hist_field->buckets);
+
+	return (val >> shift) << shift;
+}
+
 static u64 hist_field_plus(struct hist_field *hist_field,
 			   struct tracing_map_elt *elt,
 			   struct trace_buffer *buffer,
@@ -337,6 +372,7 @@ enum hist_field_flags {
 	HIST_FIELD_FL_CPU		= 1 << 15,
 	HIST_FIELD_FL_ALIAS		= 1 << 16,
 	HIST_FIELD_FL_BUCKET		= 1 << 17,
+	HIST_FIELD_FL_LOGLIN		= 1 << 18,
 };
 
 struct var_defs {
@@ -355,6 +391,8 @@ struct hist_trigger_attrs {
 	bool		cont;
 	bool		clear;
 	bool		ts_in_usecs;
+	bool		percentiles;
+	bool		percpu;
 	unsigned int	map_bits;
 
 	char		*assignment_str[TRACING_MAP_VARS_MAX];
@@ -1133,7 +1171,8 @@ static const char *hist_field_name(struct hist_field *field,
 		field_name = field->field->name;
 	else if (field->flags & HIST_FIELD_FL_LOG2 ||
 		 field->flags & HIST_FIELD_FL_ALIAS ||
-		 field->flags & HIST_FIELD_FL_BUCKET)
+		 field->flags & HIST_FIELD_FL_BUCKET ||
+		 field->flags & HIST_FIELD_FL_LOGLIN)
 		field_name = hist_field_name(field->operands[0], ++level);
 	else if (field->flags & HIST_FIELD_FL_CPU)
 		field_name = "common_cpu";
@@ -1355,6 +1394,10 @@ parse_hist_trigger_attrs(struct trace_array *tr, char *trigger_str)
 			attrs->cont = true;
 		else if (strcmp(str, "clear") == 0)
 			attrs->clear = true;
+		else if (strcmp(str, "percentiles") == 0)
+			attrs->percentiles = true;
+		else if (strcmp(str, "percpu") == 0)
+			attrs->percpu = true;
 		else {
 			ret = parse_action(str, attrs);
 			if (ret)
@@ -1505,6 +1548,8 @@ static const char *get_hist_field_flags(struct hist_field *hist_field)
 		flags_str = "log2";
 	else if (hist_field->flags & HIST_FIELD_FL_BUCKET)
 		flags_str = "buckets";
+	else if (hist_field->flags & HIST_FIELD_FL_LOGLIN)
+		flags_str = "loglin";
 	else if (hist_field->flags & HIST_FIELD_FL_TIMESTAMP_USECS)
 		flags_str = "usecs";
 
@@ -1693,10 +1738,17 @@ static struct hist_field *create_hist_field(struct hist_trigger_data *hist_data,
 		goto out;
 	}
 
-	if (flags & (HIST_FIELD_FL_LOG2 | HIST_FIELD_FL_BUCKET)) {
-		unsigned long fl = flags & ~(HIST_FIELD_FL_LOG2 | HIST_FIELD_FL_BUCKET);
-		hist_field->fn = flags & HIST_FIELD_FL_LOG2 ? hist_field_log2 :
-			hist_field_bucket;
+	if (flags & (HIST_FIELD_FL_LOG2 | HIST_FIELD_FL_BUCKET |
+		     HIST_FIELD_FL_LOGLIN)) {
+		unsigned long fl = flags & ~(HIST_FIELD_FL_LOG2 | HIST_FIELD_FL_BUCKET |
+					     HIST_FIELD_FL_LOGLIN);
+
+		if (flags & HIST_FIELD_FL_LOG2)
+			hist_field->fn = hist_field_log2;
+		else if (flags & HIST_FIELD_FL_BUCKET)
+			hist_field->fn = hist_field_bucket;
+		else
+			hist_field->fn = hist_field_loglin;
 		hist_field->operands[0] = create_hist_field(hist_data, field, fl, NULL);
 		if (!hist_field->operands[0])
 			goto free;
@@ -2034,6 +2086,22 @@ parse_field(struct hist_trigger_data *hist_data, struct trace_event_file *file,
 			if (ret || !(*buckets))
 				goto error;
 			*flags |= HIST_FIELD_FL_BUCKET;
+		} else if (strncmp(modifier, "loglin", 6) == 0) {
+			int ret;
+
+			modifier += 6;
+
+			*buckets = HIST_LOGLIN_BITS_DEFAULT;
+			if (*modifier == '=') {
+				modifier++;
+				ret = kstrtoul(modifier, 0, buckets);
+				if (ret || !(*buckets) ||
+				    *buckets > HIST_LOGLIN_BITS_MAX)
+					goto error;
+			} else if (*modifier) {
+				goto error;
+			}
+			*flags |= HIST_FIELD_FL_LOGLIN;
 		} else {
  error:
 			hist_err(tr, HIST_ERR_BAD_FIELD_MODIFIER, errpos(modifier));
@@ -4549,6 +4617,12 @@ create_hist_data(unsigned int map_bits,
 	if (ret)
 		goto free;
 
+	if (attrs->percentiles) {
+		ret = check_percentiles_key(hist_data);
+		if (ret)
+			goto free;
+	}
+
 	ret = create_sort_keys(hist_data);
 	if (ret)
 		goto free;
@@ -4563,6 +4637,9 @@ create_hist_data(unsigned int map_bits,
 		goto free;
 	}
 
+	if (attrs->percpu)
+		tracing_map_set_percpu_sums(hist_data->map);
+
 	ret = create_tracing_map_fields(hist_data);
 	if (ret)
 		goto free;
@@ -4749,6 +4826,25 @@ static void hist_trigger_stacktrace_print(struct seq_file *m,
 	}
 }
 
+/* The largest value falling into the bucket of key value @uval */
+static u64 hist_key_bucket_max(struct hist_field *key_field, u64 uval)
+{
+	unsigned int shift;
+
+	if (key_field->flags & HIST_FIELD_FL_LOG2)
+		return uval < 64 ? 1ULL << uval : U64_MAX;
+
+	if (key_field->flags & HIST_FIELD_FL_BUCKET)
+		return uval + key_field->buckets - 1;
+
+	if (key_field->flags & HIST_FIELD_FL_LOGLIN) {
+		shift = hist_loglin_shift(uval, key_field->buckets);
+		return uval + (1ULL << shift) - 1;
+	}
+
+	return uval;
+}
+
 static void hist_trigger_print_key(struct seq_file *m,
 				   struct hist_trigger_data *hist_data,
 				   void *key,
@@ -4820,6 +4916,10 @@ static void hist_trigger_print_key(struct seq_file *m,
 			uval = *(u64 *)(key + key_field->offset);
 			seq_printf(m, "%s: ~ %llu-%llu", field_name,
 				   uval, uval + buckets -1);
+		} else if (key_field->flags & HIST_FIELD_FL_LOGLIN) {
+			uval = *(u64 *)(key + key_field->offset);
+			seq_printf(m, "%s: ~ %llu-%llu", field_name, uval,
+				   hist_key_bucket_max(key_field, uval));
 		} else if (key_field->flags & HIST_FIELD_FL_STRING) {
 			seq_printf(m, "%s: %-50s", field_name,
 				   (char *)(key + key_field->offset));
@@ -4892,6 +4992,77 @@ static int print_entries(struct seq_file *m,
 	return n_entries;
 }
 
+/* In tenths of a percent */
+static const unsigned int hist_percentiles[] = { 500, 900, 990, 999 };
+
+/*
+ * Walk the single key in ascending order, accumulating hitcounts, and
+ * report for each percentile the upper bound of the bucket it falls in.
+ */
+static void hist_trigger_print_percentiles(struct seq_file *m,
+					   struct hist_trigger_data *hist_data)
+{
+	struct tracing_map_sort_entry **sort_entries = NULL;
+	struct tracing_map_sort_key sort_key;
+	struct hist_field *key_field;
+	u64 total = 0, cum = 0, uval;
+	unsigned int p = 0;
+	int i, n_entries;
+
+	key_field = hist_data->fields[hist_data->n_vals];
+
+	/* the key comes right after the sums in the map */
+	sort_key.field_idx = hist_data->n_vals - hist_data->n_vars;
+	sort_key.descending = false;
+
+	n_entries = tracing_map_sort_entries(hist_data->map, &sort_key, 1,
+					     &sort_entries);
+	if (n_entries <= 0)
+		return;
+
+	for (i = 0; i < n_entries; i++)
+		total += tracing_map_read_sum(sort_entries[i]->elt, HITCOUNT_IDX);
+
+	seq_printf(m, "\nPercentiles (%s):\n", hist_field_name(key_field, 0));
+
+	for (i = 0; i < n_entries && p < ARRAY_SIZE(hist_percentiles); i++) {
+		cum += tracing_map_read_sum(sort_entries[i]->elt, HITCOUNT_IDX);
+		uval = *(u64 *)(sort_entries[i]->key + key_field->offset);
+
+		while (p < ARRAY_SIZE(hist_percentiles) &&
+		       cum * 1000 >= total * hist_percentiles[p]) {
+			seq_printf(m, "    p%u.%u: %llu\n",
+				   hist_percentiles[p] / 10,
+				   hist_percentiles[p] % 10,
+				   hist_key_bucket_max(key_field, uval));
+			p++;
+		}
+	}
+
+	tracing_map_destroy_sort_entries(sort_entries, n_entries);
+}
+
+static int check_percentiles_key(struct hist_trigger_data *hist_data)
+{
+	unsigned long non_numeric = HIST_FIELD_FL_STRING |
+		HIST_FIELD_FL_STACKTRACE | HIST_FIELD_FL_SYM |
+		HIST_FIELD_FL_SYM_OFFSET | HIST_FIELD_FL_EXECNAME |
+		HIST_FIELD_FL_SYSCALL;
+	struct hist_field *key_field;
+
+	if (hist_data->n_keys != 1)
+		goto err;
+
+	key_field = hist_data->fields[hist_data->n_vals];
+	if (key_field->flags & non_numeric || key_field->is_signed)
+		goto err;
+
+	return 0;
+ err:
+	hist_err(hist_data->event_file->tr, HIST_ERR_INVALID_PERCENTILES, 0);
+	return -EINVAL;
+}
+
 static void hist_trigger_show(struct seq_file *m,
 			      struct event_trigger_data *data, int n)
 {
@@ -4912,6 +5083,9 @@ static void hist_trigger_show(struct seq_file *m,
 
 	track_data_snapshot_print(m, hist_data);
 
+	if (hist_data->attrs->percentiles)
+		hist_trigger_print_percentiles(m, hist_data);
+
 	seq_printf(m, "\nTotals:\n    Hits: %llu\n    Entries: %u\n    Dropped: %llu\n",
 		   (u64)atomic64_read(&hist_data->map->hits),
 		   n_entries, (u64)atomic64_read(&hist_data->map->drops));
@@ -5358,6 +5532,10 @@ static int event_hist_trigger_print(struct seq_file *m,
 			seq_puts(m, ".descending");
 	}
 	seq_printf(m, ":size=%u", (1 << hist_data->map->map_bits));
+	if (hist_data->attrs->percentiles)
+		seq_puts(m, ":percentiles");
+	if (hist_data->attrs->percpu)
+		seq_puts(m, ":percpu");
 	if (hist_data->enable_timestamps)
 		seq_printf(m, ":clock=%s", hist_data->attrs->clock);
 
@@ -5534,6 +5712,10 @@ static bool hist_trigger_match(struct event_trigger_data *data,
 	    hist_data->n_sort_keys != hist_data_test->n_sort_keys)
 		return false;
 
+	if (hist_data->attrs->percentiles != hist_data_test->attrs->percentiles ||
+	    hist_data->attrs->percpu != hist_data_test->attrs->percpu)
+		return false;
+
 	if (!ignore_filter) {
 		if ((data->filter_str && !data_test->filter_str) ||
 		   (!data->filter_str && data_test->filter_str))
@@ -5546,6 +5728,9 @@ static bool hist_trigger_match(struct event_trigger_data *data,
 
 		if (key_field->flags != key_field_test->flags)
 			return false;
+		/* the bucket size of .buckets, the sub-bucket bits of .loglin */
+		if (key_field->buckets != key_field_test->buckets)
+			return false;
 		if (!compatible_field(key_field->field, key_field_test->field))
 			return false;
 		if (key_field->offset != key_field_test->offset)
@@ -14,6 +14,7 @@
 #include <linux/vmalloc.h>
 #include <linux/jhash.h>
 #include <linux/slab.h>
+#include <linux/percpu.h>
 #include <linux/sort.h>
 #include <linux/kmemleak.h>
 
@@ -38,7 +39,25 @@
  */
 void tracing_map_update_sum(struct tracing_map_elt *elt, unsigned int i, u64 n)
 {
-	atomic64_add(n, &elt->fields[i].sum);
+	/*
+	 * The CPU may change under us when called from a preemptible
+	 * context, the atomic add keeps the per-CPU sum correct anyway.
+	 */
+	if (elt->sums)
+		atomic64_add(n, &raw_cpu_ptr(elt->sums)[i]);
+	else
+		atomic64_add(n, &elt->fields[i].sum);
+}
+
+static u64 tracing_map_sum_cpus(struct tracing_map_elt *elt, unsigned int i)
+{
+	u64 sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		sum += (u64)atomic64_read(&per_cpu_ptr(elt->sums, cpu)[i]);
+
+	return sum;
 }
 
 /**
@@ -49,12 +68,15 @@ void tracing_map_update_sum(struct tracing_map_elt *elt, unsigned int i, u64 n)
  * Retrieve the value of the sum i associated with the specified
  * tracing_map_elt instance.  The index i is the index returned by the
  * call to tracing_map_add_sum_field() when the tracing map was set
- * up.
+ * up.  For a map using per-CPU sums, the per-CPU values are added up.
  *
  * Return: The sum associated with field i for elt.
  */
 u64 tracing_map_read_sum(struct tracing_map_elt *elt, unsigned int i)
 {
+	if (elt->sums)
+		return tracing_map_sum_cpus(elt, i);
+
 	return (u64)atomic64_read(&elt->fields[i].sum);
 }
 
@@ -251,6 +273,23 @@ int tracing_map_add_var(struct tracing_map *map)
 	return ret;
 }
 
+/**
+ * tracing_map_set_percpu_sums - Keep the map's sums in per-CPU counters
+ * @map: The tracing_map
+ *
+ * Have tracing_map_update_sum() add to a counter private to the
+ * current CPU instead of the single shared one, so that hot elements
+ * hit from many CPUs don't bounce a cacheline on every update.  The
+ * per-CPU counters are added up when the sums are read or sorted.
+ *
+ * This costs one set of sums per possible CPU for each element, and
+ * must be called before tracing_map_init().
+ */
+void tracing_map_set_percpu_sums(struct tracing_map *map)
+{
+	map->percpu_sums = true;
+}
+
 /**
  * tracing_map_add_key_field - Add a field describing a tracing_map key
  * @map: The tracing_map
@@ -363,6 +402,14 @@ static void tracing_map_elt_clear(struct tracing_map_elt *elt)
 		if (elt->fields[i].cmp_fn == tracing_map_cmp_atomic64)
 			atomic64_set(&elt->fields[i].sum, 0);
 
+	if (elt->sums) {
+		int cpu;
+
+		for_each_possible_cpu(cpu)
+			for (i = 0; i < elt->map->n_fields; i++)
+				atomic64_set(&per_cpu_ptr(elt->sums, cpu)[i], 0);
+	}
+
 	for (i = 0; i < elt->map->n_vars; i++) {
 		atomic64_set(&elt->vars[i], 0);
 		elt->var_set[i] = false;
@@ -394,6 +441,7 @@ static void tracing_map_elt_free(struct tracing_map_elt *elt)
 	if (elt->map->ops && elt->map->ops->elt_free)
 		elt->map->ops->elt_free(elt);
 	kfree(elt->fields);
+	free_percpu(elt->sums);
 	kfree(elt->vars);
 	kfree(elt->var_set);
 	kfree(elt->key);
@@ -423,6 +471,15 @@ static struct tracing_map_elt *tracing_map_elt_alloc(struct tracing_map *map)
 		goto free;
 	}
 
+	if (map->percpu_sums) {
+		elt->sums = __alloc_percpu(map->n_fields * sizeof(*elt->sums),
+					   __alignof__(*elt->sums));
+		if (!elt->sums) {
+			err = -ENOMEM;
+			goto free;
+		}
+	}
+
 	elt->vars = kcalloc(map->n_vars, sizeof(*elt->vars), GFP_KERNEL);
 	if (!elt->vars) {
 		err = -ENOMEM;
@@ -1047,6 +1104,21 @@ static void sort_secondary(struct tracing_map *map,
 	}
 }
 
+/*
+ * Fold the per-CPU sums of @elt into its fields, so that the sort
+ * compares a stable snapshot rather than summing up every CPU on each
+ * comparison.
+ */
+static void tracing_map_merge_sums(struct tracing_map_elt *elt)
+{
+	unsigned int i;
+
+	for (i = 0; i < elt->map->n_fields; i++)
+		if (elt->fields[i].cmp_fn == tracing_map_cmp_atomic64)
+			atomic64_set(&elt->fields[i].sum,
+				     tracing_map_sum_cpus(elt, i));
+}
+
 /**
  * tracing_map_sort_entries - Sort the current set of tracing_map_elts in a map
  * @map: The tracing_map
@@ -1092,6 +1164,9 @@ int tracing_map_sort_entries(struct tracing_map *map,
 		if (!entry->key || !entry->val)
 			continue;
 
+		if (entry->val->sums)
+			tracing_map_merge_sums(entry->val);
+
 		entries[n_entries] = create_sort_entry(entry->val->key,
 						       entry->val);
 		if (!entries[n_entries++]) {
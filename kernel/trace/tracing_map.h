@@ -138,6 +138,7 @@ struct tracing_map_field {
 struct tracing_map_elt {
 	struct tracing_map		*map;
 	struct tracing_map_field	*fields;
+	atomic64_t __percpu		*sums;
 	atomic64_t			*vars;
 	bool				*var_set;
 	void				*key;
@@ -196,6 +197,7 @@ struct tracing_map {
 	unsigned int			n_keys;
 	struct tracing_map_sort_key	sort_key;
 	unsigned int			n_vars;
+	bool				percpu_sums;
 	atomic64_t			hits;
 	atomic64_t			drops;
 };
@@ -246,6 +248,7 @@ extern int tracing_map_init(struct tracing_map *map);
 
 extern int tracing_map_add_sum_field(struct tracing_map *map);
 extern int tracing_map_add_var(struct tracing_map *map);
+extern void tracing_map_set_percpu_sums(struct tracing_map *map);
 extern int tracing_map_add_key_field(struct tracing_map *map,
 				     unsigned int offset,
 				     tracing_map_cmp_fn_t cmp_fn);
@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Test cases and benchmark for the internet checksum functions
+ *
+ * csum_partial() and csum_partial_copy_nocheck() are checked against a
+ * 16 bits at a time sum over random data of random length, alignment and
+ * initial sum, with lengths on both sides of the thresholds the
+ * accelerated versions have.  The unfolded sums may differ in how they
+ * represent the result, so they are compared modulo 0xffff.
+ * csum_and_copy_from_user() is run on a user mapping whose pages fault
+ * in the middle of the copy.
+ */
+
+#include <kunit/test.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/mm.h>
+#include <linux/mman.h>
+#include <linux/prandom.h>
+#include <linux/preempt.h>
+#include <linux/sched.h>
+#include <linux/sched/mm.h>
+#include <linux/sched/signal.h>
+#include <linux/string.h>
+#include <linux/uaccess.h>
+#include <asm/unaligned.h>
+#include <net/checksum.h>
+
+#define CSUM_TEST_BUF_LEN	16384
+#define CSUM_TEST_ITERATIONS	1000
+
+static u8 *csum_test_src;
+static u8 *csum_test_dst;
+
+/* the one's complement sum of the 16-bit words in memory order */
+static u32 csum_ref(const u8 *p, size_t len, __wsum sum)
+{
+	u64 total = (__force u32)sum;
+	u8 last[2] = { 0, 0 };
+	size_t i;
+
+	for (i = 0; i + 1 < len; i += 2)
+		total += get_unaligned((const u16 *)(p + i));
+	if (len & 1) {
+		last[0] = p[len - 1];
+		total += get_unaligned((const u16 *)last);
+	}
+
+	return total % 0xffff;
+}
+
+static u32 csum_reduce(__wsum sum)
+{
+	return (u16)~(__force u16)csum_fold(sum) % 0xffff;
+}
+
+/* mostly short lengths, which the accelerated code handles differently */
+static size_t csum_random_len(void)
+{
+	switch (prandom_u32_max(4)) {
+	case 0:
+		return prandom_u32_max(64);
+	case 1:
+		return prandom_u32_max(2048);
+	default:
+		return prandom_u32_max(CSUM_TEST_BUF_LEN - 64);
+	}
+}
+
+static void csum_partial_test(struct kunit *test)
+{
+	int i;
+
+	for (i = 0; i < CSUM_TEST_ITERATIONS; i++) {
+		size_t len = csum_random_len();
+		size_t offset = prandom_u32_max(64);
+		const u8 *p = csum_test_src + offset;
+		__wsum sum = (__force __wsum)prandom_u32();
+
+		KUNIT_EXPECT_EQ_MSG(test, csum_reduce(csum_partial(p, len, sum)),
+				    csum_ref(p, len, sum),
+				    "len %zu offset %zu sum 0x%x", len, offset,
+				    (__force u32)sum);
+	}
+}
+
+static void csum_partial_copy_test(struct kunit *test)
+{
+	int i;
+
+	for (i = 0; i < CSUM_TEST_ITERATIONS; i++) {
+		size_t len = csum_random_len();
+		size_t soff = prandom_u32_max(64);
+		size_t doff = prandom_u32_max(64);
+		const u8 *src = csum_test_src + soff;
+		u8 *dst = csum_test_dst + doff;
+		__wsum sum;
+
+		memset(csum_test_dst, 0, CSUM_TEST_BUF_LEN);
+		sum = csum_partial_copy_nocheck(src, dst, len);
+
+		KUNIT_EXPECT_EQ_MSG(test, csum_reduce(sum), csum_ref(src, len, 0),
+				    "len %zu offsets %zu %zu", len, soff, doff);
+		KUNIT_EXPECT_EQ_MSG(test, memcmp(dst, src, len), 0,
+				    "len %zu offsets %zu %zu", len, soff, doff);
+	}
+}
+
+#if IS_BUILTIN(CONFIG_CHECKSUM_KUNIT_TEST) && defined(CONFIG_MMU)
+/*
+ * Give the test thread an address space, it goes away with the thread.
+ * mm_alloc() is not exported, so this needs the tests built in.
+ */
+static int csum_test_attach_mm(void)
+{
+	struct mm_struct *mm;
+
+	if (current->mm)
+		return 0;
+
+	mm = mm_alloc();
+	if (!mm)
+		return -ENOMEM;
+	mm->task_size = TASK_SIZE;
+	arch_pick_mmap_layout(mm, &current->signal->rlim[RLIMIT_STACK]);
+	kthread_use_mm(mm);
+	return 0;
+}
+
+/*
+ * Three pages: the first holds a copy of @data, the second is not
+ * populated yet and the third is not mapped.
+ */
+static unsigned long csum_test_user_map(const u8 *data)
+{
+	unsigned long addr;
+
+	addr = vm_mmap(NULL, 0, 3 * PAGE_SIZE, PROT_READ | PROT_WRITE,
+		       MAP_ANONYMOUS | MAP_PRIVATE, 0);
+	if (IS_ERR_VALUE(addr))
+		return 0;
+
+	if (vm_munmap(addr + 2 * PAGE_SIZE, PAGE_SIZE) ||
+	    copy_to_user((void __user *)addr, data, PAGE_SIZE)) {
+		vm_munmap(addr, 3 * PAGE_SIZE);
+		return 0;
+	}
+	return addr;
+}
+
+/*
+ * The copies start in the first page and end in the second or third, so
+ * they fault in the middle, also in the vector code, which has to leave
+ * the fault to the scalar code.  Those reaching into the hole fail.
+ */
+static void csum_and_copy_from_user_test(struct kunit *test)
+{
+	u8 *ref, *dst;
+	int i;
+
+	KUNIT_ASSERT_EQ(test, csum_test_attach_mm(), 0);
+
+	ref = kunit_kzalloc(test, 2 * PAGE_SIZE, GFP_KERNEL);
+	dst = kunit_kmalloc(test, 2 * PAGE_SIZE, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, ref);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, dst);
+	prandom_bytes(ref, PAGE_SIZE);
+
+	for (i = 0; i < 64; i++) {
+		bool hole = i & 1;
+		size_t offset = prandom_u32_max(PAGE_SIZE - 1024);
+		size_t end = PAGE_SIZE + 64 + prandom_u32_max(PAGE_SIZE - 64);
+		unsigned long addr = csum_test_user_map(ref);
+		size_t len;
+		__wsum sum;
+
+		KUNIT_ASSERT_NE(test, addr, 0UL);
+		if (hole)
+			end += PAGE_SIZE;
+		len = end - offset;
+
+		memset(dst, 0xff, 2 * PAGE_SIZE);
+		sum = csum_and_copy_from_user((const void __user *)addr + offset,
+					      dst, len);
+		vm_munmap(addr, 3 * PAGE_SIZE);
+
+		if (hole) {
+			KUNIT_EXPECT_EQ_MSG(test, (__force u32)sum, 0U,
+					    "len %zu offset %zu", len, offset);
+			continue;
+		}
+		KUNIT_EXPECT_NE_MSG(test, (__force u32)sum, 0U,
+				    "len %zu offset %zu", len, offset);
+		KUNIT_EXPECT_EQ_MSG(test, csum_reduce(sum),
+				    csum_ref(ref + offset, len, 0),
+				    "len %zu offset %zu", len, offset);
+		KUNIT_EXPECT_EQ_MSG(test, memcmp(dst, ref + offset, len), 0,
+				    "len %zu offset %zu", len, offset);
+	}
+}
+#else
+static void csum_and_copy_from_user_test(struct kunit *test)
+{
+	kunit_mark_skipped(test, "needs to be built in");
+}
+#endif
+
+static void csum_benchmark(struct kunit *test, bool copy)
+{
+	static const size_t lens[] = {
+		20, 64, 256, 576, 1023, 1024, 1500, 4096, 9000, 16000,
+	};
+	volatile __wsum sink;
+	u64 t;
+	int i, j, n;
+
+	if (!IS_ENABLED(CONFIG_CHECKSUM_BENCHMARK)) {
+		kunit_mark_skipped(test, "not enabled");
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		n = 10000000 / (lens[i] + 128);
+
+		/* warm up the caches and the FPU state */
+		sink = copy ? csum_partial_copy_nocheck(csum_test_src,
+							csum_test_dst, lens[i]) :
+			      csum_partial(csum_test_src, lens[i], 0);
+
+		preempt_disable();
+		t = ktime_get_ns();
+		for (j = 0; j < n; j++) {
+			if (copy)
+				sink = csum_partial_copy_nocheck(csum_test_src,
+								 csum_test_dst,
+								 lens[i]);
+			else
+				sink = csum_partial(csum_test_src, lens[i], 0);
+		}
+		t = ktime_get_ns() - t;
+		preempt_enable();
+
+		kunit_info(test, "len=%zu: %llu MB/s\n", lens[i],
+			   div64_u64((u64)n * lens[i] * 1000, t ?: 1));
+		cond_resched();
+	}
+}
+
+static void csum_partial_benchmark(struct kunit *test)
+{
+	csum_benchmark(test, false);
+}
+
+static void csum_partial_copy_benchmark(struct kunit *test)
+{
+	csum_benchmark(test, true);
+}
+
+static int csum_test_init(struct kunit *test)
+{
+	csum_test_src = kunit_kmalloc(test, CSUM_TEST_BUF_LEN, GFP_KERNEL);
+	csum_test_dst = kunit_kmalloc(test, CSUM_TEST_BUF_LEN, GFP_KERNEL);
+	if (!csum_test_src || !csum_test_dst)
+		return -ENOMEM;
+
+	prandom_bytes(csum_test_src, CSUM_TEST_BUF_LEN);
+	return 0;
+}
+
+static struct kunit_case csum_test_cases[] = {
+	KUNIT_CASE(csum_partial_test),
+	KUNIT_CASE(csum_partial_copy_test),
+	KUNIT_CASE(csum_and_copy_from_user_test),
+	KUNIT_CASE(csum_partial_benchmark),
+	KUNIT_CASE(csum_partial_copy_benchmark),
+	{}
+};
+
+static struct kunit_suite csum_test_suite = {
+	.name = "checksum",
+	.init = csum_test_init,
+	.test_cases = csum_test_cases,
+};
+kunit_test_suite(csum_test_suite);
+
+MODULE_DESCRIPTION("Unit tests and benchmarks for the internet checksum functions");
+MODULE_LICENSE("GPL");
@@ -60,7 +60,8 @@ static struct notifier_block crc_t10dif_nb = {
 	.notifier_call = crc_t10dif_notify,
 };
 
-__u16 crc_t10dif_update(__u16 crc, const unsigned char *buffer, size_t len)
+__u16 __weak crc_t10dif_update(__u16 crc, const unsigned char *buffer,
+			       size_t len)
 {
 	struct {
 		struct shash_desc shash;
@@ -83,6 +84,9 @@ __u16 crc_t10dif_update(__u16 crc, const unsigned char *buffer, size_t len)
 }
 EXPORT_SYMBOL(crc_t10dif_update);
 
+__u16 crc_t10dif_update_base(__u16, const unsigned char *, size_t)
+	__alias(crc_t10dif_update);
+
 __u16 crc_t10dif(const unsigned char *buffer, size_t len)
 {
 	return crc_t10dif_update(0, buffer, len);
@@ -34,6 +34,8 @@
 MODULE_DESCRIPTION("CRC64 calculations");
 MODULE_LICENSE("GPL v2");
 
+#define CRC64_ECMA182_POLY 0x42F0E1EBA9EA3693ULL
+
 /**
  * crc64_be - Calculate bitwise big-endian ECMA-182 CRC64
  * @crc: seed value for computation. 0 or (u64)~0 for a new CRC calculation,
@@ -41,7 +43,7 @@ MODULE_LICENSE("GPL v2");
  * @p: pointer to buffer over which CRC64 is run
  * @len: length of buffer @p
  */
-u64 __pure crc64_be(u64 crc, const void *p, size_t len)
+u64 __pure __weak crc64_be(u64 crc, const void *p, size_t len)
 {
 	size_t i, t;
 
@@ -55,3 +57,55 @@ u64 __pure crc64_be(u64 crc, const void *p, size_t len)
 	return crc;
 }
 EXPORT_SYMBOL_GPL(crc64_be);
+
+u64 __pure crc64_be_base(u64, const void *, size_t) __alias(crc64_be);
+
+/*
+ * This multiplies the polynomials x and y modulo the ECMA-182 polynomial,
+ * with the msbit being the x^63 coefficient as in crc64_be().
+ */
+static u64 __attribute_const__ crc64_gf2_multiply(u64 x, u64 y)
+{
+	u64 product = 0;
+	int i;
+
+	for (i = 63; i >= 0; i--) {
+		product = (product << 1) ^
+			  (product >> 63 ? CRC64_ECMA182_POLY : 0);
+		if (x >> i & 1)
+			product ^= y;
+	}
+
+	return product;
+}
+
+/**
+ * crc64_be_shift - Append @len 0 bytes to a crc64_be() value
+ * @crc: the CRC64 to shift
+ * @len: the number of bytes, @crc is multiplied by x^(8*@len)
+ *
+ * Runs in time proportional to log(@len), see crc64_be_combine().
+ */
+u64 __attribute_const__ crc64_be_shift(u64 crc, size_t len)
+{
+	u64 power = CRC64_ECMA182_POLY;	/* x^64 */
+	int i;
+
+	/* Shift up to 56 bits in the simple linear way */
+	for (i = 0; i < 8 * (int)(len & 7); i++)
+		crc = (crc << 1) ^ (crc >> 63 ? CRC64_ECMA182_POLY : 0);
+
+	len >>= 3;
+	while (len) {
+		/* "power" is x^(64 * 2^i), modulo the polynomial */
+		if (len & 1)
+			crc = crc64_gf2_multiply(crc, power);
+
+		len >>= 1;
+		if (len)
+			power = crc64_gf2_multiply(power, power);
+	}
+
+	return crc;
+}
+EXPORT_SYMBOL_GPL(crc64_be_shift);
@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Test cases and benchmark for the CRC library functions
+ *
+ * Every function is checked against a bit at a time implementation over
+ * random data of random length, alignment and initial CRC, with lengths
+ * on both sides of the thresholds the accelerated versions have.
+ */
+
+#include <kunit/test.h>
+#include <linux/crc-t10dif.h>
+#include <linux/crc32.h>
+#include <linux/crc64.h>
+#include <linux/ktime.h>
+#include <linux/preempt.h>
+#include <linux/prandom.h>
+#include <linux/sched.h>
+
+#define CRC_TEST_BUF_LEN	16384
+#define CRC_TEST_ITERATIONS	1000
+
+struct crc_variant {
+	int bits;
+	bool le;
+	u64 poly;	/* msb-first, x^bits implied */
+	u64 (*func)(u64 crc, const u8 *p, size_t len);
+	u64 (*combine)(u64 crc1, u64 crc2, size_t len2);
+};
+
+static u8 *crc_test_buf;
+
+static u64 crc_ref(const struct crc_variant *v, u64 crc, const u8 *p,
+		   size_t len)
+{
+	u64 top = 1ULL << (v->bits - 1);
+	u64 mask = top | (top - 1);
+	u64 rpoly = 0;
+	int i;
+
+	for (i = 0; i < v->bits; i++)
+		if (v->poly & (1ULL << i))
+			rpoly |= top >> i;
+
+	while (len--) {
+		if (v->le)
+			crc ^= *p++;
+		else
+			crc ^= (u64)*p++ << (v->bits - 8);
+		for (i = 0; i < 8; i++) {
+			if (v->le)
+				crc = (crc >> 1) ^ (crc & 1 ? rpoly : 0);
+			else
+				crc = ((crc << 1) & mask) ^
+				      (crc & top ? v->poly : 0);
+		}
+	}
+
+	return crc;
+}
+
+/* mostly short lengths, which the accelerated code handles differently */
+static size_t crc_random_len(void)
+{
+	switch (prandom_u32_max(4)) {
+	case 0:
+		return prandom_u32_max(64);
+	case 1:
+		return prandom_u32_max(1024);
+	default:
+		return prandom_u32_max(CRC_TEST_BUF_LEN - 64);
+	}
+}
+
+static u64 crc_random_seed(const struct crc_variant *v)
+{
+	u64 seed = (u64)prandom_u32() << 32 | prandom_u32();
+
+	return v->bits < 64 ? seed & ((1ULL << v->bits) - 1) : seed;
+}
+
+static void crc_test(struct kunit *test, const struct crc_variant *v)
+{
+	int i;
+
+	for (i = 0; i < CRC_TEST_ITERATIONS; i++) {
+		size_t len = crc_random_len();
+		size_t offset = prandom_u32_max(64);
+		const u8 *p = crc_test_buf + offset;
+		u64 crc = crc_random_seed(v);
+
+		KUNIT_EXPECT_EQ_MSG(test, v->func(crc, p, len),
+				    crc_ref(v, crc, p, len),
+				    "len %zu offset %zu crc 0x%llx", len,
+				    offset, crc);
+	}
+}
+
+static void crc_combine_test(struct kunit *test, const struct crc_variant *v)
+{
+	int i;
+
+	for (i = 0; i < CRC_TEST_ITERATIONS; i++) {
+		size_t len = crc_random_len();
+		size_t len1 = prandom_u32_max(len + 1);
+		u64 crc = crc_random_seed(v);
+		u64 crc1 = v->func(crc, crc_test_buf, len1);
+		u64 crc2 = v->func(0, crc_test_buf + len1, len - len1);
+
+		KUNIT_EXPECT_EQ_MSG(test, v->combine(crc1, crc2, len - len1),
+				    v->func(crc, crc_test_buf, len),
+				    "len %zu split at %zu", len, len1);
+	}
+}
+
+static void crc_benchmark(struct kunit *test, const struct crc_variant *v)
+{
+	static const size_t lens[] = {
+		1, 16, 64, 127, 128, 200, 256, 511, 512, 1024, 3173, 4096,
+		16384,
+	};
+	volatile u64 sink;
+	u64 t;
+	int i, j, n;
+
+	if (!IS_ENABLED(CONFIG_CRC_BENCHMARK)) {
+		kunit_mark_skipped(test, "not enabled");
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		n = 10000000 / (lens[i] + 128);
+
+		/* warm up the caches and the FPU state */
+		sink = v->func(0, crc_test_buf, lens[i]);
+
+		preempt_disable();
+		t = ktime_get_ns();
+		for (j = 0; j < n; j++)
+			sink = v->func(0, crc_test_buf, lens[i]);
+		t = ktime_get_ns() - t;
+		preempt_enable();
+
+		kunit_info(test, "len=%zu: %llu MB/s\n", lens[i],
+			   div64_u64((u64)n * lens[i] * 1000, t ?: 1));
+		cond_resched();
+	}
+}
+
+static u64 crc32_le_wrapper(u64 crc, const u8 *p, size_t len)
+{
+	return crc32_le(crc, p, len);
+}
+
+static u64 crc32_le_combine_wrapper(u64 crc1, u64 crc2, size_t len2)
+{
+	return crc32_le_combine(crc1, crc2, len2);
+}
+
+static const struct crc_variant crc_variant_crc32_le = {
+	.bits = 32,
+	.le = true,
+	.poly = 0x04c11db7,
+	.func = crc32_le_wrapper,
+	.combine = crc32_le_combine_wrapper,
+};
+
+static void crc32_le_test(struct kunit *test)
+{
+	crc_test(test, &crc_variant_crc32_le);
+}
+
+static void crc32_le_combine_test(struct kunit *test)
+{
+	crc_combine_test(test, &crc_variant_crc32_le);
+}
+
+static void crc32_le_benchmark(struct kunit *test)
+{
+	crc_benchmark(test, &crc_variant_crc32_le);
+}
+
+static u64 crc32c_le_wrapper(u64 crc, const u8 *p, size_t len)
+{
+	return __crc32c_le(crc, p, len);
+}
+
+static u64 crc32c_le_combine_wrapper(u64 crc1, u64 crc2, size_t len2)
+{
+	return __crc32c_le_combine(crc1, crc2, len2);
+}
+
+static const struct crc_variant crc_variant_crc32c_le = {
+	.bits = 32,
+	.le = true,
+	.poly = 0x1edc6f41,
+	.func = crc32c_le_wrapper,
+	.combine = crc32c_le_combine_wrapper,
+};
+
+static void crc32c_le_test(struct kunit *test)
+{
+	crc_test(test, &crc_variant_crc32c_le);
+}
+
+static void crc32c_le_combine_test(struct kunit *test)
+{
+	crc_combine_test(test, &crc_variant_crc32c_le);
+}
+
+static void crc32c_le_benchmark(struct kunit *test)
+{
+	crc_benchmark(test, &crc_variant_crc32c_le);
+}
+
+static u64 crc32_be_wrapper(u64 crc, const u8 *p, size_t len)
+{
+	return crc32_be(crc, p, len);
+}
+
+static const struct crc_variant crc_variant_crc32_be = {
+	.bits = 32,
+	.le = false,
+	.poly = 0x04c11db7,
+	.func = crc32_be_wrapper,
+};
+
+static void crc32_be_test(struct kunit *test)
+{
+	crc_test(test, &crc_variant_crc32_be);
+}
+
+static void crc32_be_benchmark(struct kunit *test)
+{
+	crc_benchmark(test, &crc_variant_crc32_be);
+}
+
+static u64 crc_t10dif_wrapper(u64 crc, const u8 *p, size_t len)
+{
+	return crc_t10dif_update(crc, p, len);
+}
+
+static const struct crc_variant crc_variant_crc_t10dif = {
+	.bits = 16,
+	.le = false,
+	.poly = 0x8bb7,
+	.func = crc_t10dif_wrapper,
+};
+
+static void crc_t10dif_test(struct kunit *test)
+{
+	crc_test(test, &crc_variant_crc_t10dif);
+}
+
+static void crc_t10dif_benchmark(struct kunit *test)
+{
+	crc_benchmark(test, &crc_variant_crc_t10dif);
+}
+
+static u64 crc64_be_wrapper(u64 crc, const u8 *p, size_t len)
+{
+	return crc64_be(crc, p, len);
+}
+
+static const struct crc_variant crc_variant_crc64_be = {
+	.bits = 64,
+	.le = false,
+	.poly = 0x42f0e1eba9ea3693ULL,
+	.func = crc64_be_wrapper,
+	.combine = crc64_be_combine,
+};
+
+static void crc64_be_test(struct kunit *test)
+{
+	crc_test(test, &crc_variant_crc64_be);
+}
+
+static void crc64_be_combine_test(struct kunit *test)
+{
+	crc_combine_test(test, &crc_variant_crc64_be);
+}
+
+static void crc64_be_benchmark(struct kunit *test)
+{
+	crc_benchmark(test, &crc_variant_crc64_be);
+}
+
+static int crc_test_init(struct kunit *test)
+{
+	crc_test_buf = kunit_kmalloc(test, CRC_TEST_BUF_LEN, GFP_KERNEL);
+	if (!crc_test_buf)
+		return -ENOMEM;
+
+	prandom_bytes(crc_test_buf, CRC_TEST_BUF_LEN);
+	return 0;
+}
+
+static struct kunit_case crc_test_cases[] = {
+	KUNIT_CASE(crc32_le_test),
+	KUNIT_CASE(crc32_le_combine_test),
+	KUNIT_CASE(crc32_le_benchmark),
+	KUNIT_CASE(crc32c_le_test),
+	KUNIT_CASE(crc32c_le_combine_test),
+	KUNIT_CASE(crc32c_le_benchmark),
+	KUNIT_CASE(crc32_be_test),
+	KUNIT_CASE(crc32_be_benchmark),
+	KUNIT_CASE(crc_t10dif_test),
+	KUNIT_CASE(crc_t10dif_benchmark),
+	KUNIT_CASE(crc64_be_test),
+	KUNIT_CASE(crc64_be_combine_test),
+	KUNIT_CASE(crc64_be_benchmark),
+	{}
+};
+
+static struct kunit_suite crc_test_suite = {
+	.name = "crc",
+	.init = crc_test_init,
+	.test_cases = crc_test_cases,
+};
+kunit_test_suite(crc_test_suite);
+
+MODULE_DESCRIPTION("Unit tests and benchmarks for the CRC library functions");
+MODULE_LICENSE("GPL");
@@ -21,6 +21,7 @@
 #include <linux/vmalloc.h>
 #include <linux/mm.h>
 #include <linux/jhash.h>
+#include <linux/ktime.h>
 #include <linux/random.h>
 #include <linux/rhashtable.h>
 #include <linux/err.h>
@@ -29,6 +30,14 @@
 #define HASH_DEFAULT_SIZE	64UL
 #define HASH_MIN_SIZE		4U
 
+/*
+ * A rehash is done in steps of about this long, so that the worker
+ * does not hold ht->mutex for the whole of a large table.  The clock is
+ * checked every RHT_REHASH_CHECK buckets.
+ */
+#define RHT_REHASH_BUDGET_NS	(1 * NSEC_PER_MSEC)
+#define RHT_REHASH_CHECK	64U
+
 union nested_table {
 	union nested_table __rcu *table;
 	struct rhash_lock_head __rcu *bucket;
@@ -314,6 +323,7 @@ static int rhashtable_rehash_table(struct rhashtable *ht)
 	struct bucket_table *old_tbl = rht_dereference(ht->tbl, ht);
 	struct bucket_table *new_tbl;
 	struct rhashtable_walker *walker;
+	u64 deadline = ktime_get_ns() + RHT_REHASH_BUDGET_NS;
 	unsigned int old_hash;
 	int err;
 
@@ -321,11 +331,22 @@ static int rhashtable_rehash_table(struct rhashtable *ht)
 	if (!new_tbl)
 		return 0;
 
-	for (old_hash = 0; old_hash < old_tbl->size; old_hash++) {
+	/* The buckets before old_tbl->rehash were emptied by earlier steps. */
+	for (old_hash = old_tbl->rehash; old_hash < old_tbl->size; old_hash++) {
 		err = rhashtable_rehash_chain(ht, old_hash);
-		if (err)
+		if (err) {
+			old_tbl->rehash = old_hash;
 			return err;
+		}
 		cond_resched();
+
+		/* Leave the rest to the next run of the worker. */
+		if (!((old_hash + 1) % RHT_REHASH_CHECK) &&
+		    old_hash + 1 < old_tbl->size &&
+		    ktime_get_ns() > deadline) {
+			old_tbl->rehash = old_hash + 1;
+			return -EAGAIN;
+		}
 	}
 
 	/* Publish the new table pointer. */
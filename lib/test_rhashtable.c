@@ -54,6 +54,10 @@ static bool enomem_retry = false;
 module_param(enomem_retry, bool, 0);
 MODULE_PARM_DESC(enomem_retry, "Retry insert even if -ENOMEM was returned (default: off)");
 
+static int bulk = 0;
+module_param(bulk, int, 0);
+MODULE_PARM_DESC(bulk, "Number of objects threads insert at once with rhashtable_lookup_insert_bulk_fast() (default: 0, one at a time)");
+
 struct test_obj_val {
 	int	id;
 	int	tid;
@@ -74,6 +78,8 @@ struct thread_data {
 	int id;
 	struct task_struct *task;
 	struct test_obj *objs;
+	u64 insert_ns;
+	u64 lookup_ns;
 };
 
 static u32 my_hashfn(const void *data, u32 len, u32 seed)
@@ -482,6 +488,87 @@ static int __init test_rhashtable_max(struct test_obj *array,
 	return err;
 }
 
+static int __init test_rhashtable_bulk(struct test_obj *array,
+				       unsigned int entries)
+{
+	unsigned int i, n = entries / 2, ins;
+	struct rhash_head **heads;
+	int err;
+
+	if (!n)
+		return 0;
+
+	heads = vmalloc(array_size(n, sizeof(*heads)));
+	if (!heads)
+		return -ENOMEM;
+
+	err = rhashtable_init(&ht, &test_rht_params);
+	if (err)
+		goto out_free;
+
+	/* Even keys go in first... */
+	for (i = 0; i < n; i++) {
+		array[i].value.id = i * 2;
+		heads[i] = &array[i].node;
+	}
+
+	ins = rhashtable_lookup_insert_bulk_fast(&ht, heads, n,
+						 test_rht_params);
+	if (ins != n) {
+		pr_warn("Test failed: bulk insert added %u of %u\n", ins, n);
+		err = -EINVAL;
+		goto out;
+	}
+
+	/* ...then all keys, of which only the odd ones are new. */
+	for (i = 0; i < n; i++) {
+		array[n + i].value.id = i;
+		heads[i] = &array[n + i].node;
+	}
+
+	ins = rhashtable_lookup_insert_bulk_fast(&ht, heads, n,
+						 test_rht_params);
+	if (ins != n / 2) {
+		pr_warn("Test failed: bulk insert added %u of %u new keys\n",
+			ins, n / 2);
+		err = -EINVAL;
+		goto out;
+	}
+
+	for (i = 0; i < n; i++) {
+		struct test_obj *obj = rht_obj(&ht, heads[i]);
+		struct test_obj *found;
+
+		if ((obj->value.id & 1) != (i < ins)) {
+			pr_warn("Test failed: key %d reported %sinserted\n",
+				obj->value.id, i < ins ? "" : "not ");
+			err = -EINVAL;
+			goto out;
+		}
+
+		found = rhashtable_lookup_fast(&ht, &obj->value,
+					       test_rht_params);
+		if (!found || (i < ins && found != obj)) {
+			pr_warn("Test failed: key %d not found after bulk insert\n",
+				obj->value.id);
+			err = -ENOENT;
+			goto out;
+		}
+	}
+
+	if (atomic_read(&ht.nelems) != n + n / 2) {
+		pr_warn("Test failed: nelems %d after bulk insert, expected %u\n",
+			atomic_read(&ht.nelems), n + n / 2);
+		err = -EINVAL;
+	}
+
+out:
+	rhashtable_destroy(&ht);
+out_free:
+	vfree(heads);
+	return err;
+}
+
 static unsigned int __init print_ht(struct rhltable *rhlt)
 {
 	struct rhashtable *ht;
@@ -629,10 +716,46 @@ static int thread_lookup_test(struct thread_data *tdata)
 	return err;
 }
 
+static int thread_insert_bulk(struct thread_data *tdata)
+{
+	int err = 0, insert_retries = 0;
+	struct rhash_head **heads;
+	unsigned int i, j, n, ins;
+
+	heads = kmalloc_array(bulk, sizeof(*heads), GFP_KERNEL);
+	if (!heads)
+		return -ENOMEM;
+
+	for (i = 0; i < tdata->entries; i += n) {
+		n = min_t(unsigned int, bulk, tdata->entries - i);
+		for (j = 0; j < n; j++)
+			heads[j] = &tdata->objs[i + j].node;
+
+		ins = rhashtable_lookup_insert_bulk_fast(&ht, heads, n,
+							 test_rht_params);
+
+		/* No key is inserted twice, retry the rest one by one */
+		for (j = ins; j < n; j++) {
+			err = insert_retry(&ht, rht_obj(&ht, heads[j]),
+					   test_rht_params);
+			if (err < 0)
+				goto out;
+			insert_retries += err;
+		}
+
+		cond_resched();
+	}
+	err = insert_retries;
+out:
+	kfree(heads);
+	return err;
+}
+
 static int threadfunc(void *data)
 {
 	int i, step, err = 0, insert_retries = 0;
 	struct thread_data *tdata = data;
+	u64 start;
 
 	if (atomic_dec_and_test(&startup_count))
 		wake_up(&startup_wait);
@@ -644,20 +767,38 @@ static int threadfunc(void *data)
 	for (i = 0; i < tdata->entries; i++) {
 		tdata->objs[i].value.id = i;
 		tdata->objs[i].value.tid = tdata->id;
-		err = insert_retry(&ht, &tdata->objs[i], test_rht_params);
+	}
+
+	start = ktime_get_ns();
+	if (bulk > 0) {
+		err = thread_insert_bulk(tdata);
 		if (err > 0) {
 			insert_retries += err;
 		} else if (err) {
-			pr_err("  thread[%d]: rhashtable_insert_fast failed\n",
+			pr_err("  thread[%d]: rhashtable_lookup_insert_bulk_fast failed\n",
 			       tdata->id);
 			goto out;
 		}
+	} else {
+		for (i = 0; i < tdata->entries; i++) {
+			err = insert_retry(&ht, &tdata->objs[i], test_rht_params);
+			if (err > 0) {
+				insert_retries += err;
+			} else if (err) {
+				pr_err("  thread[%d]: rhashtable_insert_fast failed\n",
+				       tdata->id);
+				goto out;
+			}
+		}
 	}
+	tdata->insert_ns = ktime_get_ns() - start;
 	if (insert_retries)
 		pr_info("  thread[%d]: %u insertions retried due to memory pressure\n",
 			tdata->id, insert_retries);
 
+	start = ktime_get_ns();
 	err = thread_lookup_test(tdata);
+	tdata->lookup_ns = ktime_get_ns() - start;
 	if (err) {
 		pr_err("  thread[%d]: rhashtable_lookup_test failed\n",
 		       tdata->id);
@@ -698,7 +839,7 @@ static int __init test_rht_init(void)
 {
 	unsigned int entries;
 	int i, err, started_threads = 0, failed_threads = 0;
-	u64 total_time = 0;
+	u64 total_time = 0, insert_ns = 0, lookup_ns = 0;
 	struct thread_data *tdata;
 	struct test_obj *objs;
 
@@ -743,6 +884,9 @@ static int __init test_rht_init(void)
 		total_time += time;
 	}
 
+	pr_info("test bulk insertion: %s\n",
+		test_rhashtable_bulk(objs, entries) == 0 ? "ok" : "failed");
+
 	pr_info("test if its possible to exceed max_size %d: %s\n",
 			test_rht_params.max_size, test_rhashtable_max(objs, entries) == 0 ?
 			"no, ok" : "YES, failed");
@@ -804,7 +948,17 @@ static int __init test_rht_init(void)
 			        i, err);
 			failed_threads++;
 		}
+		insert_ns = max(insert_ns, tdata[i].insert_ns);
+		lookup_ns = max(lookup_ns, tdata[i].lookup_ns);
 	}
+	/* The threads start together, the slowest one is the wall time */
+	pr_info("  %u threads: %llu inserts/s%s, %llu lookups/s\n",
+		started_threads,
+		div64_u64((u64)started_threads * entries * NSEC_PER_SEC,
+			  insert_ns ?: 1),
+		bulk > 0 ? " (bulk)" : "",
+		div64_u64((u64)started_threads * entries * NSEC_PER_SEC,
+			  lookup_ns ?: 1));
 	rhashtable_destroy(&ht);
 	vfree(tdata);
 	vfree(objs);
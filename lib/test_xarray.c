@@ -401,6 +401,135 @@ static noinline void check_insert(struct xarray *xa)
 	XA_BUG_ON(xa, !xa_empty(xa));
 }
 
+static noinline void __check_insert_batch(struct xarray *xa,
+		const unsigned long *indices, unsigned int nr)
+{
+	void *entries[16];
+	unsigned int i;
+
+	for (i = 0; i < nr; i++)
+		entries[i] = xa_mk_index(indices[i]);
+
+	XA_BUG_ON(xa, xa_insert_batch(xa, indices, entries, nr,
+				GFP_KERNEL) != nr);
+	for (i = 0; i < nr; i++)
+		XA_BUG_ON(xa, xa_load(xa, indices[i]) != entries[i]);
+
+	xa_destroy(xa);
+	XA_BUG_ON(xa, !xa_empty(xa));
+}
+
+static noinline void check_insert_batch(struct xarray *xa)
+{
+	static const unsigned long sparse[] = {
+		0, 1, 63, 64, 65, 4095, 4096, 1UL << 20, (1UL << 20) + 1,
+		LONG_MAX, ULONG_MAX - 1, ULONG_MAX,
+	};
+	XA_STATE(xas, xa, 0);
+	unsigned long indices[16];
+	void *entries[16], *old[16];
+	unsigned int i;
+
+	XA_BUG_ON(xa, !xa_empty(xa));
+
+	/* Runs that cross node boundaries at various heights */
+	for (i = 0; i < 16; i++)
+		indices[i] = 56 + i;
+	__check_insert_batch(xa, indices, 16);
+	for (i = 0; i < 16; i++)
+		indices[i] = 4088 + i;
+	__check_insert_batch(xa, indices, 16);
+	__check_insert_batch(xa, sparse, ARRAY_SIZE(sparse));
+	__check_insert_batch(xa, sparse + 1, 1);
+
+	/* Value entries are replaced and handed back */
+	for (i = 0; i < 16; i++) {
+		indices[i] = i;
+		entries[i] = xa;
+	}
+	xa_store_index(xa, 3, GFP_KERNEL);
+	xa_store_index(xa, 10, GFP_KERNEL);
+	do {
+		xas_lock(&xas);
+		i = xas_insert_batch(&xas, indices, entries, old, 16);
+		xas_unlock(&xas);
+	} while (xas_nomem(&xas, GFP_KERNEL));
+	XA_BUG_ON(xa, i != 16);
+	for (i = 0; i < 16; i++) {
+		XA_BUG_ON(xa, xa_load(xa, i) != xa);
+		XA_BUG_ON(xa, old[i] != ((i == 3 || i == 10) ?
+					 xa_mk_index(i) : NULL));
+	}
+	xa_destroy(xa);
+
+	/* Anything else stops the batch */
+	xa_store(xa, 5, xa, GFP_KERNEL);
+	for (i = 0; i < 16; i++)
+		entries[i] = xa_mk_index(i);
+	XA_BUG_ON(xa, xa_insert_batch(xa, indices, entries, 16,
+				GFP_KERNEL) != 5);
+	XA_BUG_ON(xa, xa_load(xa, 4) != xa_mk_index(4));
+	XA_BUG_ON(xa, xa_load(xa, 5) != xa);
+	XA_BUG_ON(xa, xa_load(xa, 6) != NULL);
+	xa_destroy(xa);
+
+	XA_BUG_ON(xa, xa_reserve(xa, 2, GFP_KERNEL) != 0);
+	XA_BUG_ON(xa, xa_insert_batch(xa, indices, entries, 16,
+				GFP_KERNEL) != 2);
+	xa_destroy(xa);
+
+#ifdef CONFIG_XARRAY_MULTI
+	/* So does a multi-index entry, even a value entry */
+	xa_store_order(xa, 4, 2, xa_mk_value(4), GFP_KERNEL);
+	XA_BUG_ON(xa, xa_insert_batch(xa, indices, entries, 16,
+				GFP_KERNEL) != 4);
+	XA_BUG_ON(xa, xa_load(xa, 7) != xa_mk_value(4));
+	xa_destroy(xa);
+#endif
+	XA_BUG_ON(xa, !xa_empty(xa));
+}
+
+#ifdef __KERNEL__
+/*
+ * Not a test as such, this compares filling a large range one entry at a
+ * time with filling it in batches of about a pagevec.
+ */
+static noinline void check_insert_batch_speed(struct xarray *xa)
+{
+	const unsigned long nr = 1UL << 18;
+	unsigned long indices[16];
+	void *entries[16];
+	unsigned long index;
+	unsigned int i, n;
+	u64 single, batch;
+
+	single = ktime_get_ns();
+	for (index = 0; index < nr; index++)
+		xa_store_index(xa, index, GFP_KERNEL);
+	single = ktime_get_ns() - single;
+	xa_destroy(xa);
+
+	batch = ktime_get_ns();
+	for (index = 0; index < nr; index += n) {
+		n = min_t(unsigned long, 16, nr - index);
+		for (i = 0; i < n; i++) {
+			indices[i] = index + i;
+			entries[i] = xa_mk_index(index + i);
+		}
+		XA_BUG_ON(xa, xa_insert_batch(xa, indices, entries, n,
+					GFP_KERNEL) != n);
+	}
+	batch = ktime_get_ns() - batch;
+	XA_BUG_ON(xa, xa_load(xa, nr - 1) != xa_mk_index(nr - 1));
+	xa_destroy(xa);
+
+	pr_info("XArray: %lu entries, xa_store() %llu ns, xa_insert_batch() %llu ns\n",
+		nr, single, batch);
+}
+#else
+static void check_insert_batch_speed(struct xarray *xa) { }
+#endif
+
 static noinline void check_cmpxchg(struct xarray *xa)
 {
 	void *FIVE = xa_mk_value(5);
@@ -1800,6 +1929,8 @@ static int xarray_checks(void)
 	check_xa_shrink(&array);
 	check_xas_erase(&array);
 	check_insert(&array);
+	check_insert_batch(&array);
+	check_insert_batch_speed(&array);
 	check_cmpxchg(&array);
 	check_reserve(&array);
 	check_reserve(&xa0);
@@ -845,6 +845,105 @@ void *xas_store(struct xa_state *xas, void *entry)
 }
 EXPORT_SYMBOL_GPL(xas_store);
 
+/*
+ * Move @xas forward to @index.  The walk restarts from the lowest node
+ * on the current path that covers @index instead of from the head.
+ */
+static void *xas_seek(struct xa_state *xas, unsigned long index)
+{
+	struct xa_node *node = xas->xa_node;
+	void *entry;
+
+	if (xas_not_node(node)) {
+		xas_set(xas, index);
+		return xas_load(xas);
+	}
+
+	while (((index ^ xas->xa_index) >> node->shift) > XA_CHUNK_MASK) {
+		node = xa_parent_locked(xas->xa, node);
+		if (!node) {
+			xas_set(xas, index);
+			return xas_load(xas);
+		}
+	}
+
+	xas->xa_index = index;
+	for (;;) {
+		entry = xas_descend(xas, node);
+		if (!xa_is_node(entry) || !node->shift)
+			return entry;
+		node = xa_to_node(entry);
+	}
+}
+
+/* Does the entry @xas was walked to cover more indices than its own? */
+static bool xas_is_multi(const struct xa_state *xas)
+{
+	struct xa_node *node = xas->xa_node;
+	unsigned int offset = xas->xa_offset;
+
+	if (!node)
+		return false;
+	if (node->shift)
+		return true;
+	if (!IS_ENABLED(CONFIG_XARRAY_MULTI))
+		return false;
+	if (offset != get_offset(xas->xa_index, node))
+		return true;
+	return offset < XA_CHUNK_MASK &&
+		xa_is_sibling(xa_entry_locked(xas->xa, node, offset + 1));
+}
+
+/**
+ * xas_insert_batch() - Store a batch of entries at ascending indices.
+ * @xas: XArray operation state.
+ * @indices: Indices to store at, in ascending order.
+ * @entries: Entries to store, which must not be %NULL.
+ * @old: If not %NULL, receives the entry that was at each index.
+ * @nr: Number of entries.
+ *
+ * Stores each entry like xas_store(), but only over an empty index or a
+ * value entry, such as a shadow entry.  The walk moves on from one index
+ * to the next instead of starting from the head each time, so storing a
+ * run of neighbouring indices mostly stays within one node.
+ *
+ * The batch stops at the first index that holds any other entry, or a
+ * multi-index entry, and @xas is left pointing at it.  If memory could
+ * not be allocated, @xas is in the error state.  The caller can then
+ * call xas_nomem() and submit the rest of the batch again.
+ *
+ * Context: Any context.  The caller should hold the xa_lock.
+ * Return: The number of entries stored.
+ */
+unsigned int xas_insert_batch(struct xa_state *xas,
+		const unsigned long *indices, void * const *entries,
+		void **old, unsigned int nr)
+{
+	unsigned int i;
+
+	for (i = 0; i < nr; i++) {
+		void *curr;
+
+		if (xas_error(xas))
+			break;
+
+		curr = xas_seek(xas, indices[i]);
+		if (curr && (!xa_is_value(curr) || xas_is_multi(xas)))
+			break;
+
+		xas_store(xas, entries[i]);
+		if (xas_error(xas))
+			break;
+		if (xa_track_free(xas->xa) && !curr)
+			xas_clear_mark(xas, XA_FREE_MARK);
+		if (old)
+			old[i] = curr;
+	}
+
+	return i;
+}
+EXPORT_SYMBOL_GPL(xas_insert_batch);
+
 /**
  * xas_get_mark() - Returns the state of this mark.
  * @xas: XArray operation state.
@@ -1662,6 +1761,40 @@ int __xa_insert(struct xarray *xa, unsigned long index, void *entry, gfp_t gfp)
 }
 EXPORT_SYMBOL(__xa_insert);
 
+/**
+ * xa_insert_batch() - Store a batch of entries at ascending indices.
+ * @xa: XArray.
+ * @indices: Indices to store at, in ascending order.
+ * @entries: Entries to store, which must not be %NULL.
+ * @nr: Number of entries.
+ * @gfp: Memory allocation flags.
+ *
+ * Stores the entries in one walk of the XArray with the xa_lock taken
+ * once, see xas_insert_batch().  Indices holding a value entry are
+ * overwritten.  The batch stops at the first index holding any other
+ * entry, or when memory cannot be allocated.
+ *
+ * Context: Any context.  Takes and releases the xa_lock.  May sleep if
+ * the @gfp flags permit.
+ * Return: The number of entries stored.
+ */
+unsigned int xa_insert_batch(struct xarray *xa, const unsigned long *indices,
+		void * const *entries, unsigned int nr, gfp_t gfp)
+{
+	XA_STATE(xas, xa, 0);
+	unsigned int done = 0;
+
+	do {
+		xas_lock(&xas);
+		done += xas_insert_batch(&xas, indices + done, entries + done,
+					 NULL, nr - done);
+		xas_unlock(&xas);
+	} while (xas_nomem(&xas, gfp));
+
+	return done;
+}
+EXPORT_SYMBOL(xa_insert_batch);
+
 #ifdef CONFIG_XARRAY_MULTI
 static void xas_set_range(struct xa_state *xas, unsigned long first,
 		unsigned long last)
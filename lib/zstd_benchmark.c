@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Benchmark for zstd decompression.
+ *
+ * A buffer of text-like data is compressed once through the crypto "zstd"
+ * compressor and then decompressed repeatedly, the throughput is reported
+ * in MB/s of decompressed data.  Going through the crypto API keeps the
+ * module independent of the lib/zstd interface, so the numbers can be
+ * compared across zstd versions.
+ */
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <linux/crypto.h>
+#include <linux/kernel.h>
+#include <linux/ktime.h>
+#include <linux/module.h>
+#include <linux/prandom.h>
+#include <linux/sched.h>
+#include <linux/string.h>
+#include <linux/vmalloc.h>
+
+static unsigned int size = 128 * 1024;
+module_param(size, uint, 0444);
+MODULE_PARM_DESC(size, "Size of the uncompressed data in bytes");
+
+static unsigned int iterations = 1000;
+module_param(iterations, uint, 0444);
+MODULE_PARM_DESC(iterations, "Number of times the data is decompressed");
+
+static const char * const zstd_bench_words[] = {
+	"static", "int", "unsigned", "long", "return", "struct", "if", "else",
+	"for", "while", "const", "void", "char", "size_t", "NULL", "goto",
+	"err", "out", "len", "buf", "page", "inode", "0x", "(", ")", "{", "}",
+	";", "->", "&&", "||", "=", "==", "+", "-", "1", "0", "i", "ret",
+};
+
+/* mostly repetitive with some noise, roughly like source code */
+static void zstd_bench_fill(u8 *buf, unsigned int len)
+{
+	unsigned int i = 0;
+
+	while (i < len) {
+		const char *w;
+		size_t n;
+
+		if (prandom_u32_max(16)) {
+			w = zstd_bench_words[prandom_u32_max(ARRAY_SIZE(zstd_bench_words))];
+			n = min_t(size_t, strlen(w), len - i);
+			memcpy(buf + i, w, n);
+			i += n;
+		} else {
+			buf[i++] = prandom_u32();
+		}
+		if (i < len)
+			buf[i++] = prandom_u32_max(8) ? ' ' : '\n';
+	}
+}
+
+static int __init zstd_benchmark_init(void)
+{
+	struct crypto_comp *tfm;
+	unsigned int clen, dlen, i;
+	u8 *src, *comp, *dst;
+	u64 t;
+	int ret;
+
+	if (!size || !iterations)
+		return -EINVAL;
+
+	tfm = crypto_alloc_comp("zstd", 0, 0);
+	if (IS_ERR(tfm)) {
+		pr_err("cannot allocate zstd: %ld\n", PTR_ERR(tfm));
+		return PTR_ERR(tfm);
+	}
+
+	ret = -ENOMEM;
+	src = vmalloc(size);
+	comp = vmalloc(2 * size);
+	dst = vmalloc(size);
+	if (!src || !comp || !dst)
+		goto out;
+
+	zstd_bench_fill(src, size);
+
+	clen = 2 * size;
+	ret = crypto_comp_compress(tfm, src, size, comp, &clen);
+	if (ret) {
+		pr_err("compression failed: %d\n", ret);
+		goto out;
+	}
+
+	/* check the result and warm up the caches */
+	dlen = size;
+	ret = crypto_comp_decompress(tfm, comp, clen, dst, &dlen);
+	if (ret || dlen != size || memcmp(src, dst, size)) {
+		pr_err("decompression does not round-trip: %d\n", ret);
+		ret = ret ?: -EINVAL;
+		goto out;
+	}
+
+	t = ktime_get_ns();
+	for (i = 0; i < iterations; i++) {
+		dlen = size;
+		ret = crypto_comp_decompress(tfm, comp, clen, dst, &dlen);
+		if (ret) {
+			pr_err("decompression failed: %d\n", ret);
+			goto out;
+		}
+		cond_resched();
+	}
+	t = ktime_get_ns() - t;
+
+	pr_info("%u bytes compressed to %u, decompressed %u times in %llu ns: %llu MB/s\n",
+		size, clen, iterations, t,
+		div64_u64((u64)size * iterations * 1000, t ?: 1));
+
+	/* keeping the module loaded would be pointless */
+	ret = -EAGAIN;
+out:
+	vfree(dst);
+	vfree(comp);
+	vfree(src);
+	crypto_free_comp(tfm);
+	return ret;
+}
+module_init(zstd_benchmark_init);
+
+MODULE_DESCRIPTION("Benchmark for zstd decompression");
+MODULE_LICENSE("GPL");
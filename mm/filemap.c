@@ -1003,6 +1003,122 @@ int add_to_page_cache_lru(struct page *page, struct address_space *mapping,
 }
 EXPORT_SYMBOL_GPL(add_to_page_cache_lru);
 
+/**
+ * add_to_page_cache_batch_lru - add new pages at consecutive indices
+ * @mapping:	the address_space to add the pages to
+ * @index:	index of the first page
+ * @pvec:	newly allocated, unlocked pages
+ * @gfp_mask:	page allocation mode
+ *
+ * Like add_to_page_cache_lru() for each page in @pvec in turn, the first
+ * at @index and the others after it, but the pages go into the XArray in
+ * a single walk under one acquisition of the i_pages lock.  A page whose
+ * index has a large shadow entry is added by itself.
+ *
+ * Return: The number of pages added from the start of @pvec, which are
+ * locked.  Adding stops at the first page that could not be added, the
+ * caller still owns that one and the ones after it.
+ */
+unsigned int add_to_page_cache_batch_lru(struct address_space *mapping,
+		pgoff_t index, struct pagevec *pvec, gfp_t gfp_mask)
+{
+	XA_STATE(xas, &mapping->i_pages, index);
+	unsigned long indices[PAGEVEC_SIZE];
+	void *shadows[PAGEVEC_SIZE];
+	unsigned int nr = pagevec_count(pvec);
+	unsigned int i, added = 0, failed = 0;
+	gfp_t gfp = gfp_mask & GFP_RECLAIM_MASK;
+
+	mapping_set_update(&xas, mapping);
+
+	for (i = 0; i < nr; i++) {
+		struct page *page = pvec->pages[i];
+
+		VM_BUG_ON_PAGE(PageSwapBacked(page), page);
+		VM_BUG_ON_PAGE(PageHuge(page), page);
+
+		__SetPageLocked(page);
+		get_page(page);
+		page->mapping = mapping;
+		page->index = index + i;
+		if (mem_cgroup_charge(page, NULL, gfp_mask)) {
+			page->mapping = NULL;
+			put_page(page);
+			__ClearPageLocked(page);
+			nr = i;
+			break;
+		}
+		indices[i] = index + i;
+		shadows[i] = NULL;
+	}
+
+	while (added < nr) {
+		unsigned int n;
+		struct page *page;
+
+		do {
+			xas_lock_irq(&xas);
+			n = xas_insert_batch(&xas, indices + added,
+					     (void **)pvec->pages + added,
+					     shadows + added, nr - added);
+			for (i = added; i < added + n; i++) {
+				mapping->nrpages++;
+				__inc_lruvec_page_state(pvec->pages[i],
+							NR_FILE_PAGES);
+			}
+			xas_unlock_irq(&xas);
+
+			for (i = added; i < added + n; i++)
+				trace_mm_filemap_add_to_page_cache(pvec->pages[i]);
+			added += n;
+		} while (xas_nomem(&xas, gfp));
+
+		if (added == nr || xas_error(&xas))
+			break;
+
+		/*
+		 * Something is in the way.  A large shadow entry needs to be
+		 * split, which the single page path knows how to do, and any
+		 * other entry makes that fail with -EEXIST.
+		 */
+		page = pvec->pages[added];
+		mem_cgroup_uncharge(page);
+		page->mapping = NULL;
+		put_page(page);
+		if (__add_to_page_cache_locked(page, mapping, index + added,
+					       gfp_mask, &shadows[added])) {
+			__ClearPageLocked(page);
+			failed = 1;
+			break;
+		}
+		added++;
+		xas_set(&xas, index + added);
+	}
+
+	/* Undo the preparation of the pages that were not added */
+	for (i = added + failed; i < nr; i++) {
+		struct page *page = pvec->pages[i];
+
+		mem_cgroup_uncharge(page);
+		page->mapping = NULL;
+		put_page(page);
+		__ClearPageLocked(page);
+	}
+
+	for (i = 0; i < added; i++) {
+		struct page *page = pvec->pages[i];
+
+		/* See add_to_page_cache_lru() */
+		WARN_ON_ONCE(PageActive(page));
+		if (!(gfp_mask & __GFP_WRITE) && shadows[i])
+			workingset_refault(page, shadows[i]);
+		lru_cache_add(page);
+	}
+
+	return added;
+}
+EXPORT_SYMBOL_GPL(add_to_page_cache_batch_lru);
+
 #ifdef CONFIG_NUMA
 struct page *__page_cache_alloc(gfp_t gfp)
 {
@@ -2587,6 +2703,13 @@ static int filemap_get_pages(struct kiocb *iocb, struct iov_iter *iter,
 	return err;
 }
 
+/*
+ * Reads of at least this much from a file opened with POSIX_FADV_NOREUSE
+ * are copied out with non-temporal stores.  Smaller buffers are likely to
+ * be consumed while they are still in the cache.
+ */
+#define FILEMAP_NOCACHE_READ_MIN	(256 * 1024)
+
 /**
  * filemap_read - Read data from the page cache.
  * @iocb: The iocb to read.
@@ -2609,7 +2732,7 @@ ssize_t filemap_read(struct kiocb *iocb, struct iov_iter *iter,
 	struct inode *inode = mapping->host;
 	struct pagevec pvec;
 	int i, error = 0;
-	bool writably_mapped;
+	bool writably_mapped, nocache;
 	loff_t isize, end_offset;
 
 	if (unlikely(iocb->ki_pos >= inode->i_sb->s_maxbytes))
@@ -2619,6 +2742,8 @@ ssize_t filemap_read(struct kiocb *iocb, struct iov_iter *iter,
 
 	iov_iter_truncate(iter, inode->i_sb->s_maxbytes);
 	pagevec_init(&pvec);
+	nocache = (filp->f_mode & FMODE_NOREUSE) &&
+		  iov_iter_count(iter) >= FILEMAP_NOCACHE_READ_MIN;
 
 	do {
 		cond_resched();
@@ -2695,7 +2820,12 @@ ssize_t filemap_read(struct kiocb *iocb, struct iov_iter *iter,
 					flush_dcache_page(page + j);
 			}
 
-			copied = copy_page_to_iter(page, offset, bytes, iter);
+			if (nocache)
+				copied = copy_page_to_iter_nocache(page, offset,
+								   bytes, iter);
+			else
+				copied = copy_page_to_iter(page, offset, bytes,
+							   iter);
 
 			already_read += copied;
 			iocb->ki_pos += copied;
@@ -157,6 +157,31 @@ static void read_pages(struct readahead_control *rac, struct list_head *pages,
 		rac->_index++;
 }
 
+/*
+ * Add the pages page_cache_ra_unbounded() has batched up to the page cache,
+ * after those already in @ractl.  Returns false if not all of them could be
+ * added, the ones that were not are freed.
+ */
+static bool ra_add_pages(struct readahead_control *ractl,
+		struct pagevec *pvec, gfp_t gfp_mask)
+{
+	unsigned int i, nr = pagevec_count(pvec), added;
+
+	if (!nr)
+		return true;
+
+	added = add_to_page_cache_batch_lru(ractl->mapping,
+			ractl->_index + ractl->_nr_pages, pvec, gfp_mask);
+	ractl->_nr_pages += added;
+	for (i = added; i < nr; i++) {
+		ClearPageReadahead(pvec->pages[i]);
+		put_page(pvec->pages[i]);
+	}
+	pagevec_reinit(pvec);
+
+	return added == nr;
+}
+
 /**
  * page_cache_ra_unbounded - Start unchecked readahead.
  * @ractl: Readahead control.
@@ -178,6 +203,7 @@ void page_cache_ra_unbounded(struct readahead_control *ractl,
 	unsigned long index = readahead_index(ractl);
 	LIST_HEAD(page_pool);
 	gfp_t gfp_mask = readahead_gfp_mask(mapping);
+	struct pagevec pvec;
 	unsigned long i;
 
 	/*
@@ -193,8 +219,11 @@ void page_cache_ra_unbounded(struct readahead_control *ractl,
 	unsigned int nofs = memalloc_nofs_save();
 
 	filemap_invalidate_lock_shared(mapping);
+	pagevec_init(&pvec);
 	/*
-	 * Preallocate as many pages as we will need.
+	 * Preallocate as many pages as we will need.  Unless the filesystem
+	 * uses ->readpages, they are added to the page cache a pagevec at a
+	 * time, with a single walk of i_pages for each.
 	 */
 	for (i = 0; i < nr_to_read; i++) {
 		struct page *page = xa_load(&mapping->i_pages, index + i);
@@ -206,8 +235,12 @@ void page_cache_ra_unbounded(struct readahead_control *ractl,
 			 * next batch.  This page may be the one we would
 			 * have intended to mark as Readahead, but we don't
 			 * have a stable reference to this page, and it's
-			 * not worth getting one just for that.
+			 * not worth getting one just for that.  If not all
+			 * of the pending pages could be added, this skips
+			 * the first that wasn't instead, and we come back
+			 * here later.
 			 */
+			ra_add_pages(ractl, &pvec, gfp_mask);
 			read_pages(ractl, &page_pool, true);
 			i = ractl->_index + ractl->_nr_pages - index - 1;
 			continue;
@@ -216,20 +249,19 @@ void page_cache_ra_unbounded(struct readahead_control *ractl,
 		page = __page_cache_alloc(gfp_mask);
 		if (!page)
 			break;
+		if (i == nr_to_read - lookahead_size)
+			SetPageReadahead(page);
 		if (mapping->a_ops->readpages) {
 			page->index = index + i;
 			list_add(&page->lru, &page_pool);
-		} else if (add_to_page_cache_lru(page, mapping, index + i,
-					gfp_mask) < 0) {
-			put_page(page);
+			ractl->_nr_pages++;
+		} else if (!pagevec_add(&pvec, page) &&
+			   !ra_add_pages(ractl, &pvec, gfp_mask)) {
 			read_pages(ractl, &page_pool, true);
 			i = ractl->_index + ractl->_nr_pages - index - 1;
-			continue;
 		}
-		if (i == nr_to_read - lookahead_size)
-			SetPageReadahead(page);
-		ractl->_nr_pages++;
 	}
+	ra_add_pages(ractl, &pvec, gfp_mask);
 
 	/*
 	 * Now start the IO.  We ignore I/O errors - if the page is not
@@ -2542,7 +2542,7 @@ static ssize_t shmem_file_read_iter(struct kiocb *iocb, struct iov_iter *to)
 	 * holes of a sparse file, we actually need to allocate those pages,
 	 * and even mark them dirty, so it cannot exceed the max_blocks limit.
 	 */
-	if (!iter_is_iovec(to))
+	if (!user_backed_iter(to))
 		sgp = SGP_CACHE;
 
 	index = *ppos >> PAGE_SHIFT;
@@ -20,6 +20,7 @@
 #include <net/netfilter/nf_conntrack_expect.h>
 #include <net/netfilter/nf_conntrack_helper.h>
 #include <net/netfilter/nf_conntrack_acct.h>
+#include <net/netfilter/nf_conntrack_bpf.h>
 #include <net/netfilter/nf_conntrack_zones.h>
 #include <net/netfilter/nf_conntrack_timestamp.h>
 #ifdef CONFIG_LWTUNNEL
@@ -1236,8 +1237,14 @@ static int __init nf_conntrack_standalone_init(void)
 	if (ret < 0)
 		goto out_pernet;
 
+	ret = register_nf_conntrack_bpf();
+	if (ret < 0)
+		goto out_kfunc;
+
 	return 0;
 
+out_kfunc:
+	unregister_pernet_subsys(&nf_conntrack_net_ops);
 out_pernet:
 #ifdef CONFIG_SYSCTL
 	unregister_net_sysctl_table(nf_ct_netfilter_header);
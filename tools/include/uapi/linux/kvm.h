@@ -110,6 +110,7 @@ struct kvm_userspace_memory_region {
  */
 #define KVM_MEM_LOG_DIRTY_PAGES	(1UL << 0)
 #define KVM_MEM_READONLY	(1UL << 1)
+#define KVM_MEM_EXIT_ON_MISSING	(1UL << 2)
 
 /* for KVM_IRQ_LINE */
 struct kvm_irq_level {
@@ -269,6 +270,7 @@ struct kvm_xen_exit {
 #define KVM_EXIT_AP_RESET_HOLD    32
 #define KVM_EXIT_X86_BUS_LOCK     33
 #define KVM_EXIT_XEN              34
+#define KVM_EXIT_MEMORY_FAULT     35
 
 /* For KVM_EXIT_INTERNAL_ERROR */
 /* Emulate instruction failed. */
@@ -469,6 +471,13 @@ struct kvm_run {
 		} msr;
 		/* KVM_EXIT_XEN */
 		struct kvm_xen_exit xen;
+		/* KVM_EXIT_MEMORY_FAULT */
+		struct {
+#define KVM_MEMORY_EXIT_FLAG_WRITE	(1ULL << 0)
+			__u64 flags;
+			__u64 gpa;
+			__u64 size;
+		} memory_fault;
 		/* Fix the size of the union. */
 		char padding[256];
 	};
@@ -1112,6 +1121,9 @@ struct kvm_ppc_resize_hpt {
 #define KVM_CAP_BINARY_STATS_FD 203
 #define KVM_CAP_EXIT_ON_EMULATION_FAILURE 204
 #define KVM_CAP_ARM_MTE 205
+#define KVM_CAP_DIRTY_LOG_RING_VCPU_RESET 222
+#define KVM_CAP_EXIT_ON_MISSING 223
+#define KVM_CAP_HALT_POLL_PERCENTILE 224
 
 #ifdef KVM_CAP_IRQ_ROUTING
 
@@ -1624,6 +1636,22 @@ struct kvm_pv_cmd {
 
 /* Available with KVM_CAP_DIRTY_LOG_RING */
 #define KVM_RESET_DIRTY_RINGS		_IO(KVMIO, 0xc7)
+/* Available with KVM_CAP_DIRTY_LOG_RING_VCPU_RESET, on a vcpu fd */
+#define KVM_RESET_DIRTY_RING		_IO(KVMIO, 0xd2)
+
+/* Available with KVM_CAP_EXIT_ON_MISSING */
+struct kvm_populate_range {
+	__u64 gpa;
+	__u64 size;
+};
+
+struct kvm_populate_memory {
+	__u32 nr_ranges;
+	__u32 flags;	/* must be 0 */
+	__u64 ranges;	/* userspace pointer to struct kvm_populate_range[] */
+};
+
+#define KVM_POPULATE_MEMORY		_IOW(KVMIO, 0xd3, struct kvm_populate_memory)
 
 /* Per-VM Xen attributes */
 #define KVM_XEN_HVM_GET_ATTR	_IOWR(KVMIO, 0xc8, struct kvm_xen_hvm_attr)
@@ -1881,6 +1909,9 @@ struct kvm_hyperv_eventfd {
 #define KVM_DIRTY_LOG_MANUAL_PROTECT_ENABLE    (1 << 0)
 #define KVM_DIRTY_LOG_INITIALLY_SET            (1 << 1)
 
+/* KVM_ENABLE_CAP flags for KVM_CAP_HALT_POLL, see KVM_CAP_HALT_POLL_PERCENTILE */
+#define KVM_HALT_POLL_PERCENTILE               (1 << 0)
+
 /*
  * Arch needs to define the macro after implementing the dirty ring
  * feature.  KVM_DIRTY_LOG_PAGE_OFFSET should be defined as the
@@ -22,9 +22,15 @@ int bench_numa(int argc, const char **argv);
 int bench_sched_messaging(int argc, const char **argv);
 int bench_sched_pipe(int argc, const char **argv);
 int bench_syscall_basic(int argc, const char **argv);
+int bench_syscall_fork(int argc, const char **argv);
+int bench_syscall_execve(int argc, const char **argv);
+int bench_syscall_clone(int argc, const char **argv);
+int bench_syscall_open(int argc, const char **argv);
+int bench_syscall_stat(int argc, const char **argv);
 int bench_mem_memcpy(int argc, const char **argv);
 int bench_mem_memset(int argc, const char **argv);
 int bench_mem_find_bit(int argc, const char **argv);
+int bench_mem_copy_user(int argc, const char **argv);
 int bench_futex_hash(int argc, const char **argv);
 int bench_futex_wake(int argc, const char **argv);
 int bench_futex_wake_parallel(int argc, const char **argv);
@@ -37,17 +43,35 @@ int bench_synthesize(int argc, const char **argv);
 int bench_kallsyms_parse(int argc, const char **argv);
 int bench_inject_build_id(int argc, const char **argv);
 int bench_evlist_open_close(int argc, const char **argv);
+int bench_process_events(int argc, const char **argv);
+int bench_vm_page_fault(int argc, const char **argv);
+int bench_vm_mmap(int argc, const char **argv);
+int bench_vm_read(int argc, const char **argv);
 
 #define BENCH_FORMAT_DEFAULT_STR	"default"
 #define BENCH_FORMAT_DEFAULT		0
 #define BENCH_FORMAT_SIMPLE_STR		"simple"
 #define BENCH_FORMAT_SIMPLE		1
+#define BENCH_FORMAT_JSON_STR		"json"
+#define BENCH_FORMAT_JSON		2
 
 #define BENCH_FORMAT_UNKNOWN		-1
 
 extern int bench_format;
 extern unsigned int bench_repeat;
 
+/*
+ * Result of @nr_ops operations of @what done by @nr_threads in @runtime,
+ * as one JSON object per line with only integer values so that it does
+ * not depend on the locale: meant to be collected and compared between
+ * kernel builds.
+ */
+void bench__print_json(const char *name, const char *what, unsigned int nr_threads,
+		       unsigned long long nr_ops, const struct timeval *runtime);
+/* same in any bench_format, the default one being for humans */
+void bench__print_ops(const char *name, const char *what, unsigned int nr_threads,
+		      unsigned long long nr_ops, const struct timeval *runtime);
+
 #ifndef HAVE_PTHREAD_ATTR_SETAFFINITY_NP
 #include <pthread.h>
 #include <linux/compiler.h>
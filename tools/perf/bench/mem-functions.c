@@ -2,7 +2,7 @@
 /*
  * mem-memcpy.c
  *
- * Simple memcpy() and memset() benchmarks
+ * Simple memcpy(), memset() and copy to/from user benchmarks
  *
  * Written by Hitoshi Mitake <mitake@dcl.info.waseda.ac.jp>
  */
@@ -23,15 +23,26 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <errno.h>
+#include <limits.h>
+#include <linux/kernel.h>
 #include <linux/time64.h>
 #include <linux/zalloc.h>
 
 #define K 1024
 
+/* a single call of the small sizes is too short to time, -l counts this many */
+#define SMALL_LOOPS	100000
+#define SMALL_MAX	256
+
+static const size_t small_sizes[] = {
+	1, 2, 4, 7, 8, 15, 16, 31, 32, 63, 64, 100, 127, 128, 192, 255, SMALL_MAX,
+};
+
 static const char	*size_str	= "1MB";
 static const char	*function_str	= "all";
 static int		nr_loops	= 1;
 static bool		use_cycles;
+static bool		small;
 static int		cycles_fd;
 
 static const struct option options[] = {
@@ -48,6 +59,9 @@ static const struct option options[] = {
 	OPT_BOOLEAN('c', "cycles", &use_cycles,
 		    "Use a cycles event instead of gettimeofday() to measure performance"),
 
+	OPT_BOOLEAN('S', "small", &small,
+		    "Run sizes from 1 to 256 bytes instead of --size, -l is in units of 100000 calls"),
+
 	OPT_END()
 };
 
@@ -108,13 +122,63 @@ static double timeval2double(struct timeval *ts)
 	} while (0)
 
 struct bench_mem_info {
+	const char *name;
 	const struct function *functions;
 	u64 (*do_cycles)(const struct function *r, size_t size, void *src, void *dst);
 	double (*do_gettimeofday)(const struct function *r, size_t size, void *src, void *dst);
 	const char *const *usage;
+	int (*init)(size_t size);
 	bool alloc_src;
 };
 
+static void __bench_mem_small(struct bench_mem_info *info, const struct function *r,
+			      void *src, void *dst)
+{
+	int loops = nr_loops;
+	unsigned int i;
+
+	nr_loops *= SMALL_LOOPS;
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf("# Copying 1 to %d bytes, %d times each ...\n\n", SMALL_MAX, nr_loops);
+
+	for (i = 0; i < ARRAY_SIZE(small_sizes); i++) {
+		size_t size = small_sizes[i];
+		double per_call;
+
+		if (use_cycles)
+			per_call = (double)info->do_cycles(r, size, src, dst) / nr_loops;
+		else
+			per_call = (double)size * NSEC_PER_SEC / info->do_gettimeofday(r, size, src, dst);
+
+		switch (bench_format) {
+		case BENCH_FORMAT_DEFAULT:
+			printf(" %5zu bytes: %14lf %s/call\n", size, per_call,
+			       use_cycles ? "cycles" : "nsecs");
+			break;
+
+		case BENCH_FORMAT_SIMPLE:
+			printf("%zu %lf\n", size, per_call);
+			break;
+
+		case BENCH_FORMAT_JSON:
+			/* integers only: the total over all the calls */
+			printf("{\"benchmark\": \"%s\", \"function\": \"%s\", "
+			       "\"bytes\": %zu, \"calls\": %d, \"%s\": %llu}\n",
+			       info->name, r->name, size, nr_loops,
+			       use_cycles ? "cycles" : "nsecs",
+			       (unsigned long long)(per_call * nr_loops));
+			break;
+
+		default:
+			BUG_ON(1);
+			break;
+		}
+	}
+
+	nr_loops = loops;
+}
+
 static void __bench_mem_function(struct bench_mem_info *info, int r_idx, size_t size, double size_total)
 {
 	const struct function *r = &info->functions[r_idx];
@@ -122,7 +186,8 @@ static void __bench_mem_function(struct bench_mem_info *info, int r_idx, size_t
 	u64 result_cycles = 0;
 	void *src = NULL, *dst = zalloc(size);
 
-	printf("# function '%s' (%s)\n", r->name, r->desc);
+	if (bench_format != BENCH_FORMAT_JSON)
+		printf("# function '%s' (%s)\n", r->name, r->desc);
 
 	if (dst == NULL)
 		goto out_alloc_failed;
@@ -133,6 +198,11 @@ static void __bench_mem_function(struct bench_mem_info *info, int r_idx, size_t
 			goto out_alloc_failed;
 	}
 
+	if (small) {
+		__bench_mem_small(info, r, src, dst);
+		goto out_free;
+	}
+
 	if (bench_format == BENCH_FORMAT_DEFAULT)
 		printf("# Copying %s bytes ...\n\n", size_str);
 
@@ -159,6 +229,16 @@ static void __bench_mem_function(struct bench_mem_info *info, int r_idx, size_t
 		}
 		break;
 
+	case BENCH_FORMAT_JSON:
+		/* integers only, like bench__print_json() */
+		printf("{\"benchmark\": \"%s\", \"function\": \"%s\", "
+		       "\"bytes\": %llu, \"%s\": %llu}\n",
+		       info->name, r->name, (unsigned long long)size_total,
+		       use_cycles ? "cycles" : "bytes_per_sec",
+		       use_cycles ? (unsigned long long)result_cycles :
+				    (unsigned long long)result_bps);
+		break;
+
 	default:
 		BUG_ON(1);
 		break;
@@ -189,7 +269,7 @@ static int bench_mem_common(int argc, const char **argv, struct bench_mem_info *
 		}
 	}
 
-	size = (size_t)perf_atoll((char *)size_str);
+	size = small ? SMALL_MAX : (size_t)perf_atoll((char *)size_str);
 	size_total = (double)size * nr_loops;
 
 	if ((s64)size <= 0) {
@@ -197,6 +277,14 @@ static int bench_mem_common(int argc, const char **argv, struct bench_mem_info *
 		return 1;
 	}
 
+	if (small && nr_loops > INT_MAX / SMALL_LOOPS) {
+		fprintf(stderr, "Too many loops:%d\n", nr_loops);
+		return 1;
+	}
+
+	if (info->init && info->init(size))
+		return 1;
+
 	if (!strncmp(function_str, "all", 3)) {
 		for (i = 0; info->functions[i].name; i++)
 			__bench_mem_function(info, i, size, size_total);
@@ -291,6 +379,7 @@ static const char * const bench_mem_memcpy_usage[] = {
 int bench_mem_memcpy(int argc, const char **argv)
 {
 	struct bench_mem_info info = {
+		.name			= "mem/memcpy",
 		.functions		= memcpy_functions,
 		.do_cycles		= do_memcpy_cycles,
 		.do_gettimeofday	= do_memcpy_gettimeofday,
@@ -365,6 +454,7 @@ static const struct function memset_functions[] = {
 int bench_mem_memset(int argc, const char **argv)
 {
 	struct bench_mem_info info = {
+		.name			= "mem/memset",
 		.functions		= memset_functions,
 		.do_cycles		= do_memset_cycles,
 		.do_gettimeofday	= do_memset_gettimeofday,
@@ -373,3 +463,94 @@ int bench_mem_memset(int argc, const char **argv)
 
 	return bench_mem_common(argc, argv, &info);
 }
+
+/*
+ * The kernel copies to and from user space for read() and write() on a
+ * file in the page cache, the offset is always 0 so the same pages are
+ * copied.  The system call costs about as much as a small copy.
+ */
+static int copy_user_fd = -1;
+
+static int copy_user_init(size_t size)
+{
+	const char *dir = getenv("TMPDIR") ?: "/tmp";
+	char path[PATH_MAX];
+	void *buf;
+	int ret = -1;
+
+	buf = zalloc(size);
+	if (buf == NULL) {
+		printf("# Memory allocation failed - maybe size (%s) is too large?\n", size_str);
+		return -1;
+	}
+
+	scnprintf(path, sizeof(path), "%s/perf-bench-copy_user-XXXXXX", dir);
+	copy_user_fd = mkstemp(path);
+	if (copy_user_fd < 0) {
+		fprintf(stderr, "Failed to create %s: %s\n", path, strerror(errno));
+		goto out;
+	}
+	unlink(path);
+
+	if (pwrite(copy_user_fd, buf, size, 0) != (ssize_t)size) {
+		fprintf(stderr, "Failed to write %s: %s\n", path, strerror(errno));
+		close(copy_user_fd);
+		goto out;
+	}
+	ret = 0;
+out:
+	free(buf);
+	return ret;
+}
+
+static void *copy_user_read(void *dst, const void *src __maybe_unused, size_t size)
+{
+	ssize_t ret = pread(copy_user_fd, dst, size, 0);
+
+	BUG_ON(ret != (ssize_t)size);
+	return dst;
+}
+
+static void *copy_user_write(void *dst, const void *src, size_t size)
+{
+	ssize_t ret = pwrite(copy_user_fd, src, size, 0);
+
+	BUG_ON(ret != (ssize_t)size);
+	return dst;
+}
+
+static const char * const bench_mem_copy_user_usage[] = {
+	"perf bench mem copy_user <options>",
+	NULL
+};
+
+static const struct function copy_user_functions[] = {
+	{ .name		= "read",
+	  .desc		= "copy_to_user() by pread() from the page cache",
+	  .fn.memcpy	= copy_user_read },
+
+	{ .name		= "write",
+	  .desc		= "copy_from_user() by pwrite() to the page cache",
+	  .fn.memcpy	= copy_user_write },
+
+	{ .name = NULL, }
+};
+
+int bench_mem_copy_user(int argc, const char **argv)
+{
+	struct bench_mem_info info = {
+		.name			= "mem/copy_user",
+		.functions		= copy_user_functions,
+		.do_cycles		= do_memcpy_cycles,
+		.do_gettimeofday	= do_memcpy_gettimeofday,
+		.usage			= bench_mem_copy_user_usage,
+		.init			= copy_user_init,
+		.alloc_src		= true,
+	};
+	int ret;
+
+	ret = bench_mem_common(argc, argv, &info);
+	if (copy_user_fd >= 0)
+		close(copy_user_fd);
+	return ret;
+}
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Benchmark of perf.data event processing: how many events per second
+ * perf_session__process_events() delivers, resolving the samples to
+ * their thread, map and symbol as perf report and perf script do.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <linux/err.h>
+#include <linux/time64.h>
+#include <subcmd/parse-options.h>
+
+#include "bench.h"
+#include "../util/data.h"
+#include "../util/debug.h"
+#include "../util/event.h"
+#include "../util/evlist.h"
+#include "../util/header.h"
+#include "../util/machine.h"
+#include "../util/session.h"
+#include "../util/stat.h"
+#include "../util/symbol.h"
+#include "../util/tool.h"
+
+static const char *input_name = "perf.data";
+static unsigned int iterations = 5;
+static unsigned int load_threads;
+
+static const struct option options[] = {
+	OPT_STRING('i', "input", &input_name, "file", "input file name (default: perf.data)"),
+	OPT_UINTEGER('n', "iterations", &iterations,
+		     "Number of iterations used to compute average (default: 5)"),
+	OPT_UINTEGER('j', "load-threads", &load_threads,
+		     "Load the DSOs symbols upfront using <n> threads (default: 0, on demand)"),
+	OPT_END()
+};
+
+static const char *const bench_usage[] = {
+	"perf bench internals process-events <options>",
+	NULL
+};
+
+static u64 nr_samples;
+
+static int process_sample_event(struct perf_tool *tool __maybe_unused,
+				union perf_event *event __maybe_unused,
+				struct perf_sample *sample,
+				struct evsel *evsel __maybe_unused,
+				struct machine *machine)
+{
+	struct addr_location al;
+
+	if (machine__resolve(machine, &al, sample) < 0)
+		return -1;
+
+	nr_samples++;
+	addr_location__put(&al);
+	return 0;
+}
+
+static struct perf_tool tool = {
+	.sample		= process_sample_event,
+	.mmap		= perf_event__process_mmap,
+	.mmap2		= perf_event__process_mmap2,
+	.comm		= perf_event__process_comm,
+	.namespaces	= perf_event__process_namespaces,
+	.cgroup		= perf_event__process_cgroup,
+	.exit		= perf_event__process_exit,
+	.fork		= perf_event__process_fork,
+	.lost		= perf_event__process_lost,
+	.ksymbol	= perf_event__process_ksymbol,
+	.attr		= perf_event__process_attr,
+	.build_id	= perf_event__process_build_id,
+	.ordered_events	= true,
+	.ordering_requires_timestamps = true,
+};
+
+static int do_process_events(struct stats *time_stats, struct stats *rate_stats,
+			     struct stats *load_stats)
+{
+	struct perf_data data = {
+		.path  = input_name,
+		.mode  = PERF_DATA_MODE_READ,
+		.force = true,
+	};
+	struct timeval start, end, diff;
+	struct perf_session *session;
+	u64 runtime_us, nr_events;
+	int err;
+
+	session = perf_session__new(&data, &tool);
+	if (IS_ERR(session))
+		return PTR_ERR(session);
+
+	if (load_threads) {
+		gettimeofday(&start, NULL);
+		err = machines__load_dsos(&session->machines, load_threads);
+		gettimeofday(&end, NULL);
+		if (err)
+			goto out_delete;
+
+		timersub(&end, &start, &diff);
+		update_stats(load_stats, diff.tv_sec * USEC_PER_SEC + diff.tv_usec);
+	}
+
+	nr_samples = 0;
+
+	gettimeofday(&start, NULL);
+	err = perf_session__process_events(session);
+	gettimeofday(&end, NULL);
+	if (err)
+		goto out_delete;
+
+	timersub(&end, &start, &diff);
+	runtime_us = diff.tv_sec * USEC_PER_SEC + diff.tv_usec;
+	nr_events = session->evlist->stats.nr_events[0];
+
+	update_stats(time_stats, runtime_us);
+	if (runtime_us)
+		update_stats(rate_stats, (double)nr_events * USEC_PER_SEC / runtime_us);
+
+	pr_debug("processed %" PRIu64 " events, %" PRIu64 " samples in %" PRIu64 " usec\n",
+		 nr_events, nr_samples, runtime_us);
+
+out_delete:
+	perf_session__delete(session);
+	return err;
+}
+
+int bench_process_events(int argc, const char **argv)
+{
+	struct stats time_stats, rate_stats, load_stats;
+	unsigned int i;
+	int err = 0;
+
+	argc = parse_options(argc, argv, options, bench_usage, 0);
+	if (argc) {
+		usage_with_options(bench_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	if (symbol__init(NULL) < 0) {
+		pr_err("Symbol init failed\n");
+		return -1;
+	}
+
+	init_stats(&time_stats);
+	init_stats(&rate_stats);
+	init_stats(&load_stats);
+
+	for (i = 0; i < iterations; i++) {
+		err = do_process_events(&time_stats, &rate_stats, &load_stats);
+		if (err) {
+			pr_err("Failed to process %s: %d\n", input_name, err);
+			goto out;
+		}
+	}
+
+	printf("  Processing %s (%u iterations):\n", input_name, iterations);
+	if (load_threads)
+		printf("  Average DSO symbols loading took: %.3f ms (+- %.3f ms) with %u threads\n",
+		       avg_stats(&load_stats) / USEC_PER_MSEC,
+		       stddev_stats(&load_stats) / USEC_PER_MSEC, load_threads);
+	printf("  Average event processing took: %.3f ms (+- %.3f ms)\n",
+	       avg_stats(&time_stats) / USEC_PER_MSEC,
+	       stddev_stats(&time_stats) / USEC_PER_MSEC);
+	printf("  Average event processing rate: %.0f events/sec (+- %.0f)\n",
+	       avg_stats(&rate_stats), stddev_stats(&rate_stats));
+out:
+	symbol__exit();
+	return err;
+}
@@ -316,6 +316,13 @@ int bench_sched_messaging(int argc, const char **argv)
 		printf("%lu.%03lu\n", (unsigned long) diff.tv_sec,
 		       (unsigned long) (diff.tv_usec / USEC_PER_MSEC));
 		break;
+	case BENCH_FORMAT_JSON:
+		/* every sender sends nr_loops messages to each receiver */
+		bench__print_json("sched/messaging", "messages",
+				  num_groups * 2 * num_fds,
+				  (unsigned long long)num_groups * num_fds *
+				  num_fds * nr_loops, &diff);
+		break;
 	default:
 		/* reaching here is something disaster */
 		fprintf(stderr, "Unknown format:%d\n", bench_format);
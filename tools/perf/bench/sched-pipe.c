@@ -3,7 +3,7 @@
  *
  * sched-pipe.c
  *
- * pipe: Benchmark for pipe()
+ * pipe: Benchmark for pipe(), or for a unix socketpair() with --unix
  *
  * Based on pipe-test-1m.c by Ingo Molnar <mingo@redhat.com>
  *  http://people.redhat.com/mingo/cfs-scheduler/tools/pipe-test-1m.c
@@ -22,6 +22,7 @@
 #include <assert.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/socket.h>
 #include <sys/syscall.h>
 #include <linux/time64.h>
 
@@ -40,9 +41,13 @@ static	int			loops = LOOPS_DEFAULT;
 /* Use processes by default: */
 static bool			threaded;
 
+/* Ping-pong over AF_UNIX sockets instead of pipes: */
+static bool			use_unix;
+
 static const struct option options[] = {
 	OPT_INTEGER('l', "loop",	&loops,		"Specify number of loops"),
 	OPT_BOOLEAN('T', "threaded",	&threaded,	"Specify threads/process based task setup"),
+	OPT_BOOLEAN('U', "unix",	&use_unix,	"Use unix stream sockets instead of pipes"),
 	OPT_END()
 };
 
@@ -93,8 +98,14 @@ int bench_sched_pipe(int argc, const char **argv)
 
 	argc = parse_options(argc, argv, options, bench_sched_pipe_usage, 0);
 
-	BUG_ON(pipe(pipe_1));
-	BUG_ON(pipe(pipe_2));
+	if (use_unix) {
+		/* only one direction of each socket pair is used, as for pipes */
+		BUG_ON(socketpair(AF_UNIX, SOCK_STREAM, 0, pipe_1));
+		BUG_ON(socketpair(AF_UNIX, SOCK_STREAM, 0, pipe_2));
+	} else {
+		BUG_ON(pipe(pipe_1));
+		BUG_ON(pipe(pipe_2));
+	}
 
 	gettimeofday(&start, NULL);
 
@@ -149,8 +160,9 @@ int bench_sched_pipe(int argc, const char **argv)
 
 	switch (bench_format) {
 	case BENCH_FORMAT_DEFAULT:
-		printf("# Executed %d pipe operations between two %s\n\n",
-			loops, threaded ? "threads" : "processes");
+		printf("# Executed %d %s operations between two %s\n\n",
+			loops, use_unix ? "unix socket" : "pipe",
+			threaded ? "threads" : "processes");
 
 		result_usec = diff.tv_sec * USEC_PER_SEC;
 		result_usec += diff.tv_usec;
@@ -172,6 +184,11 @@ int bench_sched_pipe(int argc, const char **argv)
 		       (unsigned long) (diff.tv_usec / USEC_PER_MSEC));
 		break;
 
+	case BENCH_FORMAT_JSON:
+		bench__print_json("sched/pipe", use_unix ? "unix-pingpong" : "pipe-pingpong",
+				  nr_threads, loops, &diff);
+		break;
+
 	default:
 		/* reaching here is something disaster */
 		fprintf(stderr, "Unknown format:%d\n", bench_format);
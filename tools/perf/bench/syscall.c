@@ -10,45 +10,236 @@
 #include "../builtin.h"
 #include "bench.h"
 
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/time.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <stdlib.h>
 
 #define LOOPS_DEFAULT 10000000
 static	int loops = LOOPS_DEFAULT;
 
+/* the process and file benchmarks are much heavier than getppid() */
+#define LOOPS_DEFAULT_HEAVY 10000
+
+static const char *exec_path = "/bin/true";
+static const char *file_path;
+
 static const struct option options[] = {
 	OPT_INTEGER('l', "loop",	&loops,		"Specify number of loops"),
 	OPT_END()
 };
 
+static const struct option exec_options[] = {
+	OPT_STRING('e', "exec",		&exec_path,	"path",
+		   "Program to execute (default: /bin/true)"),
+	OPT_PARENT(options)
+};
+
+static const struct option file_options[] = {
+	OPT_STRING('p', "path",		&file_path,	"path",
+		   "File to use (default: a new file in $TMPDIR or /tmp)"),
+	OPT_PARENT(options)
+};
+
 static const char * const bench_syscall_usage[] = {
 	"perf bench syscall <options>",
 	NULL
 };
 
-int bench_syscall_basic(int argc, const char **argv)
+enum bench_syscall {
+	BENCH_SYSCALL_GETPPID,
+	BENCH_SYSCALL_FORK,
+	BENCH_SYSCALL_EXECVE,
+	BENCH_SYSCALL_CLONE,
+	BENCH_SYSCALL_OPEN,
+	BENCH_SYSCALL_STAT,
+};
+
+static const char * const bench_syscall_names[] = {
+	[BENCH_SYSCALL_GETPPID]	= "getppid()",
+	[BENCH_SYSCALL_FORK]	= "fork()+waitpid()",
+	[BENCH_SYSCALL_EXECVE]	= "fork()+execve()+waitpid()",
+	[BENCH_SYSCALL_CLONE]	= "pthread_create()+pthread_join()",
+	[BENCH_SYSCALL_OPEN]	= "open()+close()",
+	[BENCH_SYSCALL_STAT]	= "stat()",
+};
+
+static const char * const bench_syscall_json_names[] = {
+	[BENCH_SYSCALL_GETPPID]	= "syscall/basic",
+	[BENCH_SYSCALL_FORK]	= "syscall/fork",
+	[BENCH_SYSCALL_EXECVE]	= "syscall/execve",
+	[BENCH_SYSCALL_CLONE]	= "syscall/clone",
+	[BENCH_SYSCALL_OPEN]	= "syscall/open",
+	[BENCH_SYSCALL_STAT]	= "syscall/stat",
+};
+
+static void test_fork(void)
+{
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		fprintf(stderr, "fork failed\n");
+		exit(1);
+	} else if (pid == 0) {
+		exit(0);
+	} else {
+		if (waitpid(pid, NULL, 0) < 0) {
+			fprintf(stderr, "waitpid failed\n");
+			exit(1);
+		}
+	}
+}
+
+static void test_execve(void)
+{
+	const char *pathname = exec_path;
+	char *argv[] = { (char *)exec_path, NULL };
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		fprintf(stderr, "fork failed\n");
+		exit(1);
+	} else if (pid == 0) {
+		execve(pathname, argv, NULL);
+		fprintf(stderr, "execve %s failed\n", pathname);
+		exit(1);
+	} else {
+		if (waitpid(pid, NULL, 0) < 0) {
+			fprintf(stderr, "waitpid failed\n");
+			exit(1);
+		}
+	}
+}
+
+static void *clone_worker(void *arg)
+{
+	return arg;
+}
+
+static void test_clone(void)
+{
+	pthread_t thread;
+
+	if (pthread_create(&thread, NULL, clone_worker, NULL) ||
+	    pthread_join(thread, NULL)) {
+		fprintf(stderr, "pthread_create failed\n");
+		exit(1);
+	}
+}
+
+static void test_open(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		fprintf(stderr, "open %s failed\n", path);
+		exit(1);
+	}
+	close(fd);
+}
+
+static void test_stat(const char *path)
 {
+	struct stat st;
+
+	if (stat(path, &st) < 0) {
+		fprintf(stderr, "stat %s failed\n", path);
+		exit(1);
+	}
+}
+
+/* create a file to open or stat when no --path was given */
+static char *bench_syscall_tmpfile(void)
+{
+	const char *tmpdir = getenv("TMPDIR");
+	char *path;
+	int fd;
+
+	if (asprintf(&path, "%s/perf-bench-syscall-XXXXXX", tmpdir ?: "/tmp") < 0)
+		return NULL;
+
+	fd = mkstemp(path);
+	if (fd < 0) {
+		free(path);
+		return NULL;
+	}
+	close(fd);
+	return path;
+}
+
+static int bench_syscall_common(int argc, const char **argv, int syscall)
+{
+	const struct option *opts = options;
 	struct timeval start, stop, diff;
 	unsigned long long result_usec = 0;
+	char *tmp_path = NULL;
+	const char *path;
 	int i;
 
-	argc = parse_options(argc, argv, options, bench_syscall_usage, 0);
+	if (syscall == BENCH_SYSCALL_EXECVE)
+		opts = exec_options;
+	else if (syscall == BENCH_SYSCALL_OPEN || syscall == BENCH_SYSCALL_STAT)
+		opts = file_options;
+
+	/* reset default loops count, lower for the heavy syscalls */
+	loops = syscall == BENCH_SYSCALL_GETPPID ? LOOPS_DEFAULT : LOOPS_DEFAULT_HEAVY;
+
+	argc = parse_options(argc, argv, opts, bench_syscall_usage, 0);
+
+	path = file_path;
+	if ((syscall == BENCH_SYSCALL_OPEN || syscall == BENCH_SYSCALL_STAT) && !path) {
+		path = tmp_path = bench_syscall_tmpfile();
+		if (!path) {
+			fprintf(stderr, "Failed to create a temporary file\n");
+			return -1;
+		}
+	}
 
 	gettimeofday(&start, NULL);
 
-	for (i = 0; i < loops; i++)
-		getppid();
+	for (i = 0; i < loops; i++) {
+		switch (syscall) {
+		case BENCH_SYSCALL_GETPPID:
+			getppid();
+			break;
+		case BENCH_SYSCALL_FORK:
+			test_fork();
+			break;
+		case BENCH_SYSCALL_EXECVE:
+			test_execve();
+			break;
+		case BENCH_SYSCALL_CLONE:
+			test_clone();
+			break;
+		case BENCH_SYSCALL_OPEN:
+			test_open(path);
+			break;
+		case BENCH_SYSCALL_STAT:
+			test_stat(path);
+			break;
+		default:
+			break;
+		}
+	}
 
 	gettimeofday(&stop, NULL);
 	timersub(&stop, &start, &diff);
 
+	if (tmp_path) {
+		unlink(tmp_path);
+		free(tmp_path);
+	}
+
 	switch (bench_format) {
 	case BENCH_FORMAT_DEFAULT:
-		printf("# Executed %'d getppid() calls\n", loops);
+		printf("# Executed %'d %s calls\n", loops, bench_syscall_names[syscall]);
 
 		result_usec = diff.tv_sec * 1000000;
 		result_usec += diff.tv_usec;
@@ -70,6 +261,11 @@ int bench_syscall_basic(int argc, const char **argv)
 		       (unsigned long) (diff.tv_usec / 1000));
 		break;
 
+	case BENCH_FORMAT_JSON:
+		bench__print_json(bench_syscall_json_names[syscall],
+				  bench_syscall_names[syscall], 1, loops, &diff);
+		break;
+
 	default:
 		/* reaching here is something disaster */
 		fprintf(stderr, "Unknown format:%d\n", bench_format);
@@ -79,3 +275,33 @@ int bench_syscall_basic(int argc, const char **argv)
 
 	return 0;
 }
+
+int bench_syscall_basic(int argc, const char **argv)
+{
+	return bench_syscall_common(argc, argv, BENCH_SYSCALL_GETPPID);
+}
+
+int bench_syscall_fork(int argc, const char **argv)
+{
+	return bench_syscall_common(argc, argv, BENCH_SYSCALL_FORK);
+}
+
+int bench_syscall_execve(int argc, const char **argv)
+{
+	return bench_syscall_common(argc, argv, BENCH_SYSCALL_EXECVE);
+}
+
+int bench_syscall_clone(int argc, const char **argv)
+{
+	return bench_syscall_common(argc, argv, BENCH_SYSCALL_CLONE);
+}
+
+int bench_syscall_open(int argc, const char **argv)
+{
+	return bench_syscall_common(argc, argv, BENCH_SYSCALL_OPEN);
+}
+
+int bench_syscall_stat(int argc, const char **argv)
+{
+	return bench_syscall_common(argc, argv, BENCH_SYSCALL_STAT);
+}
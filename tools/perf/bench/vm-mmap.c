@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * vm-mmap: Benchmark for mmap()/munmap() and mprotect().
+ *
+ * In "map" mode every thread maps and unmaps an anonymous region in a
+ * loop, in "protect" mode it flips the protection of a region of its own
+ * back and forth.  Both take the mmap_lock for write, so the threads
+ * contend on it.
+ */
+#include <pthread.h>
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+
+#include "../util/string2.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+enum mmap_mode {
+	MMAP_MODE_MAP,
+	MMAP_MODE_PROTECT,
+};
+
+static const char * const mmap_modes[] = {
+	[MMAP_MODE_MAP]		= "map",
+	[MMAP_MODE_PROTECT]	= "protect",
+};
+
+static unsigned int	nthreads = 1;
+static unsigned int	nloops = 100000;
+static const char	*size_str = "64KB";
+static const char	*mode_str = "map";
+
+static const struct option options[] = {
+	OPT_UINTEGER('t', "threads", &nthreads, "Specify amount of threads sharing the mm (default: 1)"),
+	OPT_UINTEGER('l', "loops", &nloops, "Specify number of operations per thread (default: 100000)"),
+	OPT_STRING('s', "size", &size_str, "64KB", "Specify size of the mapping"),
+	OPT_STRING('m', "mode", &mode_str, "map", "Specify operation: map (mmap+munmap) or protect (mprotect)"),
+	OPT_END()
+};
+
+static const char * const bench_vm_mmap_usage[] = {
+	"perf bench vm mmap <options>",
+	NULL
+};
+
+static enum mmap_mode mode;
+static size_t		map_size;
+
+static pthread_mutex_t	thread_lock;
+static unsigned int	threads_starting;
+static pthread_cond_t	thread_parent, thread_worker;
+
+static void *workerfn(void *arg __maybe_unused)
+{
+	char *p = NULL;
+	unsigned int i;
+
+	if (mode == MMAP_MODE_PROTECT) {
+		p = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap");
+	}
+
+	pthread_mutex_lock(&thread_lock);
+	threads_starting--;
+	if (!threads_starting)
+		pthread_cond_signal(&thread_parent);
+	pthread_cond_wait(&thread_worker, &thread_lock);
+	pthread_mutex_unlock(&thread_lock);
+
+	for (i = 0; i < nloops; i++) {
+		if (mode == MMAP_MODE_PROTECT) {
+			int prot = (i & 1) ? PROT_READ | PROT_WRITE : PROT_READ;
+
+			if (mprotect(p, map_size, prot))
+				err(EXIT_FAILURE, "mprotect");
+			continue;
+		}
+
+		p = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap");
+		if (munmap(p, map_size))
+			err(EXIT_FAILURE, "munmap");
+	}
+
+	if (mode == MMAP_MODE_PROTECT)
+		munmap(p, map_size);
+	return NULL;
+}
+
+int bench_vm_mmap(int argc, const char **argv)
+{
+	struct timeval start, end, runtime;
+	pthread_t *threads;
+	const char *what;
+	s64 size;
+	unsigned int i;
+	int ret;
+
+	argc = parse_options(argc, argv, options, bench_vm_mmap_usage, 0);
+	if (argc) {
+		usage_with_options(bench_vm_mmap_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(mmap_modes); i++) {
+		if (!strcmp(mode_str, mmap_modes[i]))
+			break;
+	}
+	if (i == ARRAY_SIZE(mmap_modes)) {
+		fprintf(stderr, "Invalid mode: %s\n", mode_str);
+		return 1;
+	}
+	mode = i;
+
+	size = perf_atoll((char *)size_str);
+	if (size <= 0 || !nthreads || !nloops) {
+		usage_with_options(bench_vm_mmap_usage, options);
+		exit(EXIT_FAILURE);
+	}
+	map_size = roundup((size_t)size, (size_t)sysconf(_SC_PAGESIZE));
+
+	threads = calloc(nthreads, sizeof(*threads));
+	if (!threads)
+		err(EXIT_FAILURE, "calloc");
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf("# %u threads, %u %s operations of %s each\n\n",
+		       nthreads, nloops, mode_str, size_str);
+
+	pthread_mutex_init(&thread_lock, NULL);
+	pthread_cond_init(&thread_parent, NULL);
+	pthread_cond_init(&thread_worker, NULL);
+
+	threads_starting = nthreads;
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_create(&threads[i], NULL, workerfn, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+
+	pthread_mutex_lock(&thread_lock);
+	while (threads_starting)
+		pthread_cond_wait(&thread_parent, &thread_lock);
+	gettimeofday(&start, NULL);
+	pthread_cond_broadcast(&thread_worker);
+	pthread_mutex_unlock(&thread_lock);
+
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_join(threads[i], NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	gettimeofday(&end, NULL);
+	timersub(&end, &start, &runtime);
+
+	pthread_cond_destroy(&thread_parent);
+	pthread_cond_destroy(&thread_worker);
+	pthread_mutex_destroy(&thread_lock);
+
+	what = mode == MMAP_MODE_MAP ? "mmap()+munmap()" : "mprotect()";
+	bench__print_ops("vm/mmap", what, nthreads,
+			 (unsigned long long)nthreads * nloops, &runtime);
+
+	free(threads);
+	return 0;
+}
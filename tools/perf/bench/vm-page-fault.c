@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * vm-page-fault: Benchmark for the page fault path.
+ *
+ * Each thread repeatedly maps its own region, touches every page and
+ * unmaps it again.  All the threads share the same mm, so running more
+ * of them than one also stresses the mmap_lock and the page table locks.
+ * The regions are either anonymous memory, THP-backed anonymous memory
+ * or a MAP_SHARED view of a file which is kept in the page cache.
+ */
+#include <pthread.h>
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <linux/time64.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "../util/string2.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+#define HPAGE_SIZE	(2UL << 20)
+
+enum page_fault_mode {
+	PAGE_FAULT_ANON,
+	PAGE_FAULT_FILE,
+	PAGE_FAULT_THP,
+};
+
+static const char * const page_fault_modes[] = {
+	[PAGE_FAULT_ANON]	= "anon",
+	[PAGE_FAULT_FILE]	= "file",
+	[PAGE_FAULT_THP]	= "thp",
+};
+
+static unsigned int	nthreads = 1;
+static unsigned int	nloops = 10;
+static const char	*size_str = "64MB";
+static const char	*mode_str = "anon";
+static const char	*dir_str;
+
+static const struct option options[] = {
+	OPT_UINTEGER('t', "threads", &nthreads, "Specify amount of threads sharing the mm (default: 1)"),
+	OPT_UINTEGER('l', "loops", &nloops, "Specify map/fault/unmap rounds per thread (default: 10)"),
+	OPT_STRING('s', "size", &size_str, "64MB", "Specify size of the region of each thread"),
+	OPT_STRING('m', "mode", &mode_str, "anon", "Specify memory type: anon, file or thp"),
+	OPT_STRING('d', "dir", &dir_str, "dir", "Directory of the file for -m file (default: $TMPDIR or /tmp)"),
+	OPT_END()
+};
+
+static const char * const bench_vm_page_fault_usage[] = {
+	"perf bench vm page-fault <options>",
+	NULL
+};
+
+struct worker {
+	pthread_t	thread;
+	unsigned int	tid;
+	unsigned long	pages;
+};
+
+static enum page_fault_mode mode;
+static size_t		region_size;
+static long		pagesize;
+static int		file_fd = -1;
+
+static pthread_mutex_t	thread_lock;
+static unsigned int	threads_starting;
+static pthread_cond_t	thread_parent, thread_worker;
+
+static char *map_region(struct worker *w, size_t *len)
+{
+	char *p;
+
+	switch (mode) {
+	case PAGE_FAULT_FILE:
+		*len = region_size;
+		p = mmap(NULL, *len, PROT_READ, MAP_SHARED, file_fd,
+			 (off_t)w->tid * region_size);
+		if (p == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap");
+		return p;
+
+	case PAGE_FAULT_THP:
+		/* over-allocate to hand out a huge page aligned region */
+		*len = region_size + HPAGE_SIZE;
+		p = mmap(NULL, *len, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap");
+		if (madvise(p, *len, MADV_HUGEPAGE))
+			err(EXIT_FAILURE, "madvise");
+		return p;
+
+	case PAGE_FAULT_ANON:
+	default:
+		*len = region_size;
+		p = mmap(NULL, *len, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap");
+		return p;
+	}
+}
+
+static void *workerfn(void *arg)
+{
+	struct worker *w = arg;
+	unsigned long pages = 0;
+	unsigned int i;
+
+	pthread_mutex_lock(&thread_lock);
+	threads_starting--;
+	if (!threads_starting)
+		pthread_cond_signal(&thread_parent);
+	pthread_cond_wait(&thread_worker, &thread_lock);
+	pthread_mutex_unlock(&thread_lock);
+
+	for (i = 0; i < nloops; i++) {
+		size_t len, off;
+		char *map, *p;
+
+		map = map_region(w, &len);
+		p = map;
+		if (mode == PAGE_FAULT_THP)
+			p = (char *)(((unsigned long)map + HPAGE_SIZE - 1) & ~(HPAGE_SIZE - 1));
+
+		for (off = 0; off < region_size; off += pagesize, pages++) {
+			if (mode == PAGE_FAULT_FILE)
+				(void)*(volatile char *)(p + off);
+			else
+				*(volatile char *)(p + off) = 1;
+		}
+
+		if (munmap(map, len))
+			err(EXIT_FAILURE, "munmap");
+	}
+
+	w->pages = pages;
+	return NULL;
+}
+
+/* one file with a region per thread, fully in the page cache */
+static int setup_file(void)
+{
+	const char *dir = dir_str ?: getenv("TMPDIR") ?: "/tmp";
+	size_t size = region_size * nthreads, done;
+	char path[PATH_MAX];
+	char *buf;
+
+	scnprintf(path, sizeof(path), "%s/perf-bench-page-fault-XXXXXX", dir);
+	file_fd = mkstemp(path);
+	if (file_fd < 0)
+		return -1;
+	unlink(path);
+
+	buf = calloc(1, 1 << 20);
+	if (!buf)
+		return -1;
+
+	for (done = 0; done < size; done += 1 << 20) {
+		size_t n = min(size - done, (size_t)1 << 20);
+
+		if (pwrite(file_fd, buf, n, done) != (ssize_t)n) {
+			free(buf);
+			return -1;
+		}
+	}
+	free(buf);
+	return 0;
+}
+
+int bench_vm_page_fault(int argc, const char **argv)
+{
+	struct timeval start, end, runtime;
+	struct rusage ru_start, ru_end;
+	unsigned long long pages = 0, faults;
+	struct worker *worker;
+	char what[64];
+	s64 size;
+	unsigned int i;
+	int ret;
+
+	argc = parse_options(argc, argv, options, bench_vm_page_fault_usage, 0);
+	if (argc) {
+		usage_with_options(bench_vm_page_fault_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(page_fault_modes); i++) {
+		if (!strcmp(mode_str, page_fault_modes[i]))
+			break;
+	}
+	if (i == ARRAY_SIZE(page_fault_modes)) {
+		fprintf(stderr, "Invalid mode: %s\n", mode_str);
+		return 1;
+	}
+	mode = i;
+
+	size = perf_atoll((char *)size_str);
+	pagesize = sysconf(_SC_PAGESIZE);
+	if (size <= 0 || !nthreads || !nloops) {
+		usage_with_options(bench_vm_page_fault_usage, options);
+		exit(EXIT_FAILURE);
+	}
+	region_size = roundup((size_t)size, mode == PAGE_FAULT_THP ? HPAGE_SIZE : (size_t)pagesize);
+
+	if (mode == PAGE_FAULT_FILE && setup_file() < 0)
+		err(EXIT_FAILURE, "failed to set up the file");
+
+	worker = calloc(nthreads, sizeof(*worker));
+	if (!worker)
+		err(EXIT_FAILURE, "calloc");
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf("# %u threads, each faulting %s of %s memory %u times\n\n",
+		       nthreads, size_str, mode_str, nloops);
+
+	pthread_mutex_init(&thread_lock, NULL);
+	pthread_cond_init(&thread_parent, NULL);
+	pthread_cond_init(&thread_worker, NULL);
+
+	threads_starting = nthreads;
+	for (i = 0; i < nthreads; i++) {
+		worker[i].tid = i;
+		ret = pthread_create(&worker[i].thread, NULL, workerfn, &worker[i]);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+
+	pthread_mutex_lock(&thread_lock);
+	while (threads_starting)
+		pthread_cond_wait(&thread_parent, &thread_lock);
+	getrusage(RUSAGE_SELF, &ru_start);
+	gettimeofday(&start, NULL);
+	pthread_cond_broadcast(&thread_worker);
+	pthread_mutex_unlock(&thread_lock);
+
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_join(worker[i].thread, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+		pages += worker[i].pages;
+	}
+
+	gettimeofday(&end, NULL);
+	getrusage(RUSAGE_SELF, &ru_end);
+	timersub(&end, &start, &runtime);
+
+	pthread_cond_destroy(&thread_parent);
+	pthread_cond_destroy(&thread_worker);
+	pthread_mutex_destroy(&thread_lock);
+
+	/* fault-around and THP make a fault cover more than one page */
+	faults = ru_end.ru_minflt - ru_start.ru_minflt;
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf(" %'14llu pages touched\n", pages);
+
+	scnprintf(what, sizeof(what), "%s page faults", mode_str);
+	bench__print_ops("vm/page-fault", what, nthreads, faults, &runtime);
+
+	if (file_fd >= 0)
+		close(file_fd);
+	free(worker);
+	return 0;
+}
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * vm-read: Benchmark for read() from the page cache.
+ *
+ * A file is brought into the page cache and then read start to end with
+ * read() over and over.  Besides the throughput, this measures how much
+ * the reads evict from the CPU caches: a working set is walked once to
+ * bring it in, the file is read, and the time to walk the working set
+ * again is compared to a walk with nothing in between.  Large streaming
+ * reads done with POSIX_FADV_NOREUSE (-n) should leave the working set
+ * where it was.
+ */
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <linux/time64.h>
+#include <sys/time.h>
+
+#include "../util/string2.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+#define CACHELINE_SIZE	64
+
+static unsigned int	nloops = 10;
+static const char	*size_str = "256MB";
+static const char	*bufsize_str = "1MB";
+static const char	*wss_str = "4MB";
+static const char	*dir_str;
+static bool		noreuse;
+
+static const struct option options[] = {
+	OPT_UINTEGER('l', "loops", &nloops, "Specify passes over the file (default: 10)"),
+	OPT_STRING('s', "size", &size_str, "256MB", "Specify size of the file"),
+	OPT_STRING('b', "bufsize", &bufsize_str, "1MB", "Specify size of each read()"),
+	OPT_STRING('w', "wss", &wss_str, "4MB", "Specify size of the working set probed for cache pollution"),
+	OPT_BOOLEAN('n', "noreuse", &noreuse, "Read with POSIX_FADV_NOREUSE"),
+	OPT_STRING('d', "dir", &dir_str, "dir", "Directory of the file (default: $TMPDIR or /tmp)"),
+	OPT_END()
+};
+
+static const char * const bench_vm_read_usage[] = {
+	"perf bench vm read <options>",
+	NULL
+};
+
+/* one access per cache line, returns the time it took */
+static void walk(const char *p, size_t len, struct timeval *t)
+{
+	struct timeval start, end, diff;
+	unsigned long sum = 0;
+	size_t off;
+
+	gettimeofday(&start, NULL);
+	for (off = 0; off < len; off += CACHELINE_SIZE)
+		sum += *(volatile const char *)(p + off);
+	gettimeofday(&end, NULL);
+
+	timersub(&end, &start, &diff);
+	timeradd(t, &diff, t);
+	/* keep the loads */
+	if (sum == ULONG_MAX)
+		printf("\n");
+}
+
+static int setup_file(size_t size, char *buf, size_t bufsize)
+{
+	const char *dir = dir_str ?: getenv("TMPDIR") ?: "/tmp";
+	char path[PATH_MAX];
+	size_t done;
+	int fd;
+
+	scnprintf(path, sizeof(path), "%s/perf-bench-read-XXXXXX", dir);
+	fd = mkstemp(path);
+	if (fd < 0)
+		return -1;
+	unlink(path);
+
+	memset(buf, 0x5a, bufsize);
+	for (done = 0; done < size; done += bufsize) {
+		size_t n = min(size - done, bufsize);
+
+		if (pwrite(fd, buf, n, done) != (ssize_t)n) {
+			close(fd);
+			return -1;
+		}
+	}
+	return fd;
+}
+
+static unsigned long long usecs(const struct timeval *t)
+{
+	return t->tv_sec * USEC_PER_SEC + t->tv_usec;
+}
+
+int bench_vm_read(int argc, const char **argv)
+{
+	struct timeval start, end, diff, runtime = { 0, 0 };
+	struct timeval hot = { 0, 0 }, polluted = { 0, 0 };
+	unsigned long long nr_reads = 0, bytes = 0, lines;
+	s64 size, bufsize, wss;
+	char *buf, *ws;
+	unsigned int i;
+	int fd;
+
+	argc = parse_options(argc, argv, options, bench_vm_read_usage, 0);
+	if (argc) {
+		usage_with_options(bench_vm_read_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	size = perf_atoll((char *)size_str);
+	bufsize = perf_atoll((char *)bufsize_str);
+	wss = perf_atoll((char *)wss_str);
+	if (size <= 0 || bufsize <= 0 || wss <= 0 || !nloops) {
+		usage_with_options(bench_vm_read_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	buf = malloc(bufsize);
+	ws = malloc(wss);
+	if (!buf || !ws)
+		err(EXIT_FAILURE, "malloc");
+	memset(ws, 1, wss);
+
+	fd = setup_file(size, buf, bufsize);
+	if (fd < 0)
+		err(EXIT_FAILURE, "failed to set up the file");
+	if (noreuse && posix_fadvise(fd, 0, 0, POSIX_FADV_NOREUSE))
+		err(EXIT_FAILURE, "posix_fadvise");
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf("# Reading %s %u times in %s chunks%s, %s working set\n\n",
+		       size_str, nloops, bufsize_str,
+		       noreuse ? " with POSIX_FADV_NOREUSE" : "", wss_str);
+
+	for (i = 0; i < nloops; i++) {
+		struct timeval discard = { 0, 0 };
+		off_t off = 0;
+		ssize_t ret;
+
+		/* bring the working set in and time a walk over a warm cache */
+		walk(ws, wss, &discard);
+		walk(ws, wss, &hot);
+
+		gettimeofday(&start, NULL);
+		do {
+			ret = pread(fd, buf, bufsize, off);
+			if (ret < 0)
+				err(EXIT_FAILURE, "pread");
+			off += ret;
+			nr_reads++;
+		} while (ret);
+		gettimeofday(&end, NULL);
+		timersub(&end, &start, &diff);
+		timeradd(&runtime, &diff, &runtime);
+		bytes += off;
+
+		walk(ws, wss, &polluted);
+	}
+
+	lines = (unsigned long long)nloops * (wss / CACHELINE_SIZE);
+
+	bench__print_ops("vm/read", "read() calls", 1, nr_reads, &runtime);
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf(" %'14llu MB/sec\n",
+		       usecs(&runtime) ? bytes / usecs(&runtime) : 0);
+		printf("\n # Working set walk, nsecs per cache line:\n");
+		printf(" %14.2lf after nothing\n",
+		       (double)usecs(&hot) * NSEC_PER_USEC / lines);
+		printf(" %14.2lf after the reads\n",
+		       (double)usecs(&polluted) * NSEC_PER_USEC / lines);
+		break;
+	case BENCH_FORMAT_SIMPLE:
+		printf("%llu %llu\n", usecs(&hot), usecs(&polluted));
+		break;
+	case BENCH_FORMAT_JSON:
+		bench__print_json("vm/read", "working set lines, hot", 1, lines, &hot);
+		bench__print_json("vm/read", "working set lines, after reads", 1, lines, &polluted);
+		break;
+	default:
+		break;
+	}
+
+	close(fd);
+	free(ws);
+	free(buf);
+	return 0;
+}
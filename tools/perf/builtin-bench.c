@@ -16,6 +16,7 @@
  *  numa  ... NUMA scheduling and MM performance
  *  futex ... Futex performance
  *  epoll ... Event poll performance
+ *  vm    ... Page fault, mmap and page cache read performance
  */
 #include <subcmd/parse-options.h>
 #include "builtin.h"
@@ -26,6 +27,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/prctl.h>
+#include <linux/time64.h>
 #include <linux/zalloc.h>
 
 typedef int (*bench_fn_t)(int argc, const char **argv);
@@ -34,6 +36,8 @@ struct bench {
 	const char	*name;
 	const char	*summary;
 	bench_fn_t	fn;
+	/* prints its results with -f json */
+	bool		json;
 };
 
 #ifdef HAVE_LIBNUMA_SUPPORT
@@ -45,22 +49,28 @@ static struct bench numa_benchmarks[] = {
 #endif
 
 static struct bench sched_benchmarks[] = {
-	{ "messaging",	"Benchmark for scheduling and IPC",		bench_sched_messaging	},
-	{ "pipe",	"Benchmark for pipe() between two processes",	bench_sched_pipe	},
+	{ "messaging",	"Benchmark for scheduling and IPC",		bench_sched_messaging, true	},
+	{ "pipe",	"Benchmark for pipe() between two processes",	bench_sched_pipe, true	},
 	{ "all",	"Run all scheduler benchmarks",		NULL			},
 	{ NULL,		NULL,						NULL			}
 };
 
 static struct bench syscall_benchmarks[] = {
-	{ "basic",	"Benchmark for basic getppid(2) calls",		bench_syscall_basic	},
+	{ "basic",	"Benchmark for basic getppid(2) calls",		bench_syscall_basic, true	},
+	{ "fork",	"Benchmark for fork(2) calls",			bench_syscall_fork, true	},
+	{ "execve",	"Benchmark for execve(2) calls",		bench_syscall_execve, true	},
+	{ "clone",	"Benchmark for thread clone(2) calls",		bench_syscall_clone, true	},
+	{ "open",	"Benchmark for open(2)+close(2) calls",		bench_syscall_open, true	},
+	{ "stat",	"Benchmark for stat(2) calls",			bench_syscall_stat, true	},
 	{ "all",	"Run all syscall benchmarks",			NULL			},
 	{ NULL,		NULL,						NULL			},
 };
 
 static struct bench mem_benchmarks[] = {
-	{ "memcpy",	"Benchmark for memcpy() functions",		bench_mem_memcpy	},
-	{ "memset",	"Benchmark for memset() functions",		bench_mem_memset	},
+	{ "memcpy",	"Benchmark for memcpy() functions",		bench_mem_memcpy, true	},
+	{ "memset",	"Benchmark for memset() functions",		bench_mem_memset, true	},
 	{ "find_bit",	"Benchmark for find_bit() functions",		bench_mem_find_bit	},
+	{ "copy_user",	"Benchmark for copying to and from user space",	bench_mem_copy_user, true	},
 	{ "all",	"Run all memory access benchmarks",		NULL			},
 	{ NULL,		NULL,						NULL			}
 };
@@ -90,9 +100,18 @@ static struct bench internals_benchmarks[] = {
 	{ "kallsyms-parse", "Benchmark kallsyms parsing",	bench_kallsyms_parse	},
 	{ "inject-build-id", "Benchmark build-id injection",	bench_inject_build_id	},
 	{ "evlist-open-close", "Benchmark evlist open and close",	bench_evlist_open_close	},
+	{ "process-events", "Benchmark perf.data event processing",	bench_process_events	},
 	{ NULL,		NULL,					NULL			}
 };
 
+static struct bench vm_benchmarks[] = {
+	{ "page-fault",	"Benchmark for anon, file and THP page faults",	bench_vm_page_fault, true	},
+	{ "mmap",	"Benchmark for mmap/munmap/mprotect scalability", bench_vm_mmap, true	},
+	{ "read",	"Benchmark for read() throughput and cache pollution", bench_vm_read, true	},
+	{ "all",	"Run all vm benchmarks",			NULL			},
+	{ NULL,		NULL,						NULL			}
+};
+
 struct collection {
 	const char	*name;
 	const char	*summary;
@@ -110,6 +129,7 @@ static struct collection collections[] = {
 #ifdef HAVE_EVENTFD_SUPPORT
 	{"epoll",       "Epoll stressing benchmarks",                   epoll_benchmarks        },
 #endif
+	{ "vm",		"Page fault, mmap and read benchmarks",		vm_benchmarks		},
 	{ "internals",	"Perf-internals benchmarks",			internals_benchmarks	},
 	{ "all",	"All benchmarks",				NULL			},
 	{ NULL,		NULL,						NULL			}
@@ -142,7 +162,7 @@ int bench_format = BENCH_FORMAT_DEFAULT;
 unsigned int bench_repeat = 10; /* default number of times to repeat the run */
 
 static const struct option bench_options[] = {
-	OPT_STRING('f', "format", &bench_format_str, "default|simple", "Specify the output formatting style"),
+	OPT_STRING('f', "format", &bench_format_str, "default|simple|json", "Specify the output formatting style"),
 	OPT_UINTEGER('r', "repeat",  &bench_repeat,   "Specify amount of times to repeat the run"),
 	OPT_END()
 };
@@ -178,10 +198,63 @@ static int bench_str2int(const char *str)
 		return BENCH_FORMAT_DEFAULT;
 	else if (!strcmp(str, BENCH_FORMAT_SIMPLE_STR))
 		return BENCH_FORMAT_SIMPLE;
+	else if (!strcmp(str, BENCH_FORMAT_JSON_STR))
+		return BENCH_FORMAT_JSON;
 
 	return BENCH_FORMAT_UNKNOWN;
 }
 
+void bench__print_json(const char *name, const char *what, unsigned int nr_threads,
+		       unsigned long long nr_ops, const struct timeval *runtime)
+{
+	unsigned long long runtime_usec = runtime->tv_sec * USEC_PER_SEC + runtime->tv_usec;
+
+	printf("{\"benchmark\": \"%s\", \"op\": \"%s\", \"threads\": %u, "
+	       "\"ops\": %llu, \"usecs\": %llu, "
+	       "\"nsecs_per_op\": %llu, \"ops_per_sec\": %llu}\n",
+	       name, what, nr_threads, nr_ops, runtime_usec,
+	       nr_ops ? runtime_usec * NSEC_PER_USEC / nr_ops : 0,
+	       runtime_usec ? nr_ops * USEC_PER_SEC / runtime_usec : 0);
+}
+
+void bench__print_ops(const char *name, const char *what, unsigned int nr_threads,
+		      unsigned long long nr_ops, const struct timeval *runtime)
+{
+	unsigned long long runtime_usec = runtime->tv_sec * USEC_PER_SEC + runtime->tv_usec;
+
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf("# Executed %'llu %s with %u thread%s\n\n", nr_ops, what,
+		       nr_threads, nr_threads > 1 ? "s" : "");
+
+		printf(" %14s: %lu.%03lu [sec]\n\n", "Total time",
+		       (unsigned long) runtime->tv_sec,
+		       (unsigned long) (runtime->tv_usec / USEC_PER_MSEC));
+
+		printf(" %14lf usecs/op\n",
+		       nr_ops ? (double)runtime_usec / nr_ops : 0);
+		printf(" %'14llu ops/sec\n",
+		       runtime_usec ? nr_ops * USEC_PER_SEC / runtime_usec : 0);
+		break;
+
+	case BENCH_FORMAT_SIMPLE:
+		printf("%lu.%03lu\n",
+		       (unsigned long) runtime->tv_sec,
+		       (unsigned long) (runtime->tv_usec / USEC_PER_MSEC));
+		break;
+
+	case BENCH_FORMAT_JSON:
+		bench__print_json(name, what, nr_threads, nr_ops, runtime);
+		break;
+
+	default:
+		/* reaching here is something disaster */
+		fprintf(stderr, "Unknown format:%d\n", bench_format);
+		exit(1);
+		break;
+	}
+}
+
 /*
  * Run a specific benchmark but first rename the running task's ->comm[]
  * to something meaningful:
@@ -226,11 +299,16 @@ static void run_collection(struct collection *coll)
 	for_each_bench(coll, bench) {
 		if (!bench->fn)
 			break;
-		printf("# Running %s/%s benchmark...\n", coll->name, bench->name);
+		if (bench_format == BENCH_FORMAT_JSON && !bench->json)
+			continue;
+		/* keep the json output to one object per line */
+		if (bench_format != BENCH_FORMAT_JSON)
+			printf("# Running %s/%s benchmark...\n", coll->name, bench->name);
 
 		argv[1] = bench->name;
 		run_bench(coll->name, bench->name, bench->fn, 1, argv);
-		printf("\n");
+		if (bench_format != BENCH_FORMAT_JSON)
+			printf("\n");
 	}
 }
 
@@ -302,6 +380,12 @@ int cmd_bench(int argc, const char **argv)
 			if (strcmp(bench->name, argv[1]))
 				continue;
 
+			if (bench_format == BENCH_FORMAT_JSON && !bench->json) {
+				fprintf(stderr, "No json output for the '%s/%s' benchmark\n",
+					coll->name, bench->name);
+				ret = 1;
+				goto end;
+			}
 			if (bench_format == BENCH_FORMAT_DEFAULT)
 				printf("# Running '%s/%s' benchmark:\n", coll->name, bench->name);
 			ret = run_bench(coll->name, bench->name, bench->fn, argc-1, argv+1);
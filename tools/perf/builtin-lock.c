@@ -18,9 +18,14 @@
 #include "util/session.h"
 #include "util/tool.h"
 #include "util/data.h"
+#include "util/lock-contention.h"
+#include "util/log2-hist.h"
+#include "util/machine.h"
+#include "util/target.h"
 
 #include <sys/types.h>
 #include <sys/prctl.h>
+#include <signal.h>
 #include <semaphore.h>
 #include <pthread.h>
 #include <math.h>
@@ -31,6 +36,8 @@
 #include <linux/kernel.h>
 #include <linux/zalloc.h>
 #include <linux/err.h>
+#include <linux/string.h>
+#include <linux/time64.h>
 
 static struct perf_session *session;
 
@@ -947,6 +954,233 @@ static int __cmd_record(int argc, const char **argv)
 	return ret;
 }
 
+/*
+ * perf lock contention: the waits are timed and aggregated in the kernel
+ * by a BPF program on the lock:contention_{begin,end} tracepoints, only
+ * the final table and histogram are read at the end of the run.
+ */
+static bool contention_threads;
+static bool contention_cgroups;
+static const char *contention_key = "wait_total";
+static int contention_nr_entries = INT_MAX;
+static int contention_map_entries = 10240;
+
+static volatile sig_atomic_t contention_done;
+
+static void contention_sighandler(int sig __maybe_unused)
+{
+	contention_done = 1;
+}
+
+typedef int (*contention_cmp_fn)(const void *, const void *);
+
+#define DEF_CMP_CONTENTION(name, expr)						\
+static int contention_cmp_ ## name(const void *a, const void *b)		\
+{										\
+	const struct lock_contention_entry *one = a, *two = b;			\
+	u64 v1 = expr(one), v2 = expr(two);					\
+										\
+	return v1 < v2 ? 1 : v1 > v2 ? -1 : 0;					\
+}
+
+#define CONTENTION_COUNT(e)	((e)->count)
+#define CONTENTION_TOTAL(e)	((e)->total_time)
+#define CONTENTION_MAX(e)	((e)->max_time)
+#define CONTENTION_AVG(e)	((e)->count ? (e)->total_time / (e)->count : 0)
+
+DEF_CMP_CONTENTION(contended, CONTENTION_COUNT)
+DEF_CMP_CONTENTION(wait_total, CONTENTION_TOTAL)
+DEF_CMP_CONTENTION(wait_max, CONTENTION_MAX)
+DEF_CMP_CONTENTION(avg_wait, CONTENTION_AVG)
+
+static const struct {
+	const char		*name;
+	contention_cmp_fn	cmp;
+} contention_keys[] = {
+	{ "contended",	contention_cmp_contended },
+	{ "wait_total",	contention_cmp_wait_total },
+	{ "wait_max",	contention_cmp_wait_max },
+	{ "avg_wait",	contention_cmp_avg_wait },
+};
+
+static contention_cmp_fn select_contention_key(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(contention_keys); i++) {
+		if (!strcmp(contention_keys[i].name, contention_key))
+			return contention_keys[i].cmp;
+	}
+
+	pr_err("Unknown compare key: %s\n", contention_key);
+	return NULL;
+}
+
+static const char *contention_type(u32 flags)
+{
+	switch (flags) {
+	case LCB_F_SPIN:
+		return "spinlock";
+	case LCB_F_SPIN | LCB_F_READ:
+		return "rwlock:R";
+	case LCB_F_SPIN | LCB_F_WRITE:
+		return "rwlock:W";
+	case LCB_F_READ:
+		return "rwsem:R";
+	case LCB_F_WRITE:
+		return "rwsem:W";
+	case LCB_F_MUTEX:
+	case LCB_F_MUTEX | LCB_F_SPIN:
+		return "mutex";
+	default:
+		return "unknown";
+	}
+}
+
+static void print_contention_time(u64 ns)
+{
+	if (ns < NSEC_PER_USEC)
+		printf("%10" PRIu64 " ns ", ns);
+	else if (ns < NSEC_PER_MSEC)
+		printf("%10.2f us ", (double)ns / NSEC_PER_USEC);
+	else if (ns < NSEC_PER_SEC)
+		printf("%10.2f ms ", (double)ns / NSEC_PER_MSEC);
+	else
+		printf("%10.2f s  ", (double)ns / NSEC_PER_SEC);
+}
+
+static void print_contention_result(struct lock_contention *con,
+				    contention_cmp_fn cmp)
+{
+	const char *what = "caller";
+	int i;
+
+	if (con->aggr_mode == LOCK_AGGR_TASK)
+		what = "pid:comm";
+	else if (con->aggr_mode == LOCK_AGGR_CGROUP)
+		what = "cgroup";
+
+	qsort(con->entries, con->nr_entries, sizeof(*con->entries), cmp);
+
+	printf("%10s %14s %14s %14s %10s   %s\n\n", "contended", "total wait",
+	       "max wait", "avg wait", "type", what);
+
+	for (i = 0; i < con->nr_entries && i < contention_nr_entries; i++) {
+		struct lock_contention_entry *e = &con->entries[i];
+
+		printf("%10u ", e->count);
+		print_contention_time(e->total_time);
+		print_contention_time(e->max_time);
+		print_contention_time(CONTENTION_AVG(e));
+		printf("%10s   ", contention_type(e->flags));
+
+		if (e->name)
+			printf("%s\n", e->name);
+		else
+			printf("%#" PRIx64 "\n", e->key);
+	}
+
+	if (con->lost)
+		printf("\n=== %d contentions could not be recorded, "
+		       "try a bigger --map-nr-entries ===\n", con->lost);
+
+	printf("\n wait time distribution:\n\n");
+	log2_hist__fprintf(stdout, con->hist, LOCK_HIST_SLOTS, "usecs");
+}
+
+static int __cmd_contention(int argc, const char **argv)
+{
+	struct target target = {
+		.system_wide	= true,
+		.uid		= UINT_MAX,
+	};
+	struct lock_contention con = {
+		.aggr_mode	= LOCK_AGGR_CALLER,
+		.map_nr_entries	= contention_map_entries,
+	};
+	struct evlist *evlist = NULL;
+	contention_cmp_fn cmp;
+	int err = -EINVAL;
+
+	cmp = select_contention_key();
+	if (cmp == NULL)
+		return -EINVAL;
+
+	if (contention_threads && contention_cgroups) {
+		pr_err("--threads and --per-cgroup are mutually exclusive\n");
+		return -EINVAL;
+	}
+
+	if (contention_threads)
+		con.aggr_mode = LOCK_AGGR_TASK;
+	else if (contention_cgroups)
+		con.aggr_mode = LOCK_AGGR_CGROUP;
+
+	signal(SIGINT, contention_sighandler);
+	signal(SIGCHLD, contention_sighandler);
+	signal(SIGTERM, contention_sighandler);
+
+	if (con.aggr_mode == LOCK_AGGR_CALLER) {
+		if (symbol__init(NULL) < 0) {
+			pr_err("Symbol init failed\n");
+			return -1;
+		}
+
+		con.machine = machine__new_kallsyms();
+		if (con.machine == NULL) {
+			pr_err("Failed to load the kernel symbols\n");
+			goto out;
+		}
+	}
+
+	if (argc) {
+		evlist = evlist__new();
+		if (evlist == NULL) {
+			err = -ENOMEM;
+			goto out;
+		}
+
+		err = evlist__prepare_workload(evlist, &target, argv, false, NULL);
+		if (err) {
+			pr_err("Couldn't run the workload!\n");
+			goto out;
+		}
+	}
+
+	err = lock_contention_prepare(&con);
+	if (err) {
+		pr_err("lock contention BPF setup failed, "
+		       "was perf built with BUILD_BPF_SKEL=1?\n");
+		goto out;
+	}
+
+	lock_contention_start();
+	if (argc)
+		evlist__start_workload(evlist);
+
+	/* wait for the workload to finish or for a signal */
+	while (!contention_done)
+		pause();
+
+	lock_contention_stop();
+
+	err = lock_contention_read(&con);
+	if (err) {
+		pr_err("Failed to read the lock contention data\n");
+		goto out;
+	}
+
+	setup_pager();
+	print_contention_result(&con, cmp);
+
+out:
+	lock_contention_finish(&con);
+	if (con.machine)
+		machine__delete(con.machine);
+	evlist__delete(evlist);
+	return err;
+}
+
 int cmd_lock(int argc, const char **argv)
 {
 	const struct option lock_options[] = {
@@ -972,12 +1206,26 @@ int cmd_lock(int argc, const char **argv)
 	OPT_PARENT(lock_options)
 	};
 
+	const struct option contention_options[] = {
+	OPT_STRING('k', "key", &contention_key, "wait_total",
+		    "key for sorting (contended / wait_total / wait_max / avg_wait)"),
+	OPT_BOOLEAN('t', "threads", &contention_threads,
+		    "show per-thread lock stats"),
+	OPT_BOOLEAN(0, "per-cgroup", &contention_cgroups,
+		    "show per-cgroup lock stats"),
+	OPT_INTEGER('E', "entries", &contention_nr_entries,
+		    "display this many entries"),
+	OPT_INTEGER(0, "map-nr-entries", &contention_map_entries,
+		    "max number of BPF map entries"),
+	OPT_PARENT(lock_options)
+	};
+
 	const char * const info_usage[] = {
 		"perf lock info [<options>]",
 		NULL
 	};
 	const char *const lock_subcommands[] = { "record", "report", "script",
-						 "info", NULL };
+						 "info", "contention", NULL };
 	const char *lock_usage[] = {
 		NULL,
 		NULL
@@ -986,6 +1234,10 @@ int cmd_lock(int argc, const char **argv)
 		"perf lock report [<options>]",
 		NULL
 	};
+	const char * const contention_usage[] = {
+		"perf lock contention [<options>] [<command>]",
+		NULL
+	};
 	unsigned int i;
 	int rc = 0;
 
@@ -1021,6 +1273,12 @@ int cmd_lock(int argc, const char **argv)
 		/* recycling report_lock_ops */
 		trace_handler = &report_lock_ops;
 		rc = __cmd_report(true);
+	} else if (strlen(argv[0]) > 2 && strstarts("contention", argv[0])) {
+		argc = parse_options(argc, argv, contention_options,
+				     contention_usage, PARSE_OPT_STOP_AT_NON_OPTION);
+		if (contention_map_entries <= 0)
+			usage_with_options(contention_usage, contention_options);
+		rc = __cmd_contention(argc, argv);
 	} else {
 		usage_with_options(lock_usage, lock_options);
 	}
@@ -49,6 +49,7 @@
 #include "util/clockid.h"
 #include "util/pmu-hybrid.h"
 #include "util/evlist-hybrid.h"
+#include "util/off_cpu.h"
 #include "asm/bug.h"
 #include "perf.h"
 
@@ -74,6 +75,7 @@
 #include <linux/zalloc.h>
 #include <linux/bitmap.h>
 #include <sys/time.h>
+#include <api/fd/array.h>
 
 struct switch_output {
 	bool		 enabled;
@@ -87,6 +89,15 @@ struct switch_output {
 	int		 cur_file;
 };
 
+enum thread_spec {
+	THREAD_SPEC__UNDEFINED = 0,
+	THREAD_SPEC__CPU,
+	THREAD_SPEC__NUMA,
+	THREAD_SPEC__USER,
+};
+
+struct record_thread;
+
 struct record {
 	struct perf_tool	tool;
 	struct record_opts	opts;
@@ -111,8 +122,49 @@ struct record {
 	unsigned long long	samples;
 	struct mmap_cpu_mask	affinity_mask;
 	unsigned long		output_max_size;	/* = 0: unlimited */
+	enum thread_spec	threads_spec;
+	int			threads_user_nr;
+	int			nr_threads;
+	int			nr_threads_started;
+	struct record_thread	*thread_data;
+	bool			off_cpu;
+};
+
+/*
+ * With --threads the regular mmaps are split among reader threads, each
+ * one streaming its mmaps into its own data.N file of the perf.data
+ * directory. The main thread keeps the control and wakeup fds, writes
+ * the synthesized events into the main file and polls the ack pipes of
+ * the readers to find out when they all ran out of mmaps.
+ */
+struct record_thread {
+	pthread_t		tid;
+	struct record		*rec;
+	struct mmap		**maps;
+	int			nr_mmaps;
+	cpu_set_t		mask;
+	struct fdarray		pollfd;
+	int			msg_pos;
+	int			msg[2];
+	int			ack[2];
+	struct perf_data_file	*file;
+	struct zstd_data	zstd_data;
+	int			err;
+	unsigned long		waking;
+	unsigned long long	samples;
+	u64			bytes_written;
+	u64			bytes_transferred;
+	u64			bytes_compressed;
 };
 
+/* The reader thread we run in, NULL for the main thread. */
+static __thread struct record_thread *thread;
+
+static bool record__threads_enabled(struct record *rec)
+{
+	return rec->threads_spec != THREAD_SPEC__UNDEFINED;
+}
+
 static volatile int done;
 
 static volatile int auxtrace_record__snapshot_started;
@@ -153,11 +205,19 @@ static int record__write(struct record *rec, struct mmap *map __maybe_unused,
 {
 	struct perf_data_file *file = &rec->session->data->file;
 
+	if (thread)
+		file = thread->file;
+
 	if (perf_data_file__write(file, bf, size) < 0) {
 		pr_err("failed to write perf data, error: %m\n");
 		return -1;
 	}
 
+	if (thread) {
+		thread->bytes_written += size;
+		return 0;
+	}
+
 	rec->bytes_written += size;
 
 	if (record__output_max_size_exceeded(rec) && !done) {
@@ -541,7 +601,10 @@ static int record__pushfn(struct mmap *map, void *to, void *bf, size_t size)
 		bf   = map->data;
 	}
 
-	rec->samples++;
+	if (thread)
+		thread->samples++;
+	else
+		rec->samples++;
 	return record__write(rec, map, bf, size);
 }
 
@@ -809,6 +872,11 @@ static int record__config_text_poke(struct evlist *evlist)
 	return 0;
 }
 
+static int record__config_off_cpu(struct record *rec)
+{
+	return off_cpu_prepare(rec->evlist, &rec->opts.target);
+}
+
 static bool record__kcore_readable(struct machine *machine)
 {
 	char kcore[PATH_MAX];
@@ -1098,6 +1166,15 @@ static size_t zstd_compress(struct perf_session *session, void *dst, size_t dst_
 	size_t compressed;
 	size_t max_record_size = PERF_SAMPLE_MAX_SIZE - sizeof(struct perf_record_compressed) - 1;
 
+	if (thread) {
+		compressed = zstd_compress_stream_to_records(&thread->zstd_data, dst, dst_size,
+							     src, src_size, max_record_size,
+							     process_comp_header);
+		thread->bytes_transferred += src_size;
+		thread->bytes_compressed  += compressed;
+		return compressed;
+	}
+
 	compressed = zstd_compress_stream_to_records(&session->zstd_data, dst, dst_size, src, src_size,
 						     max_record_size, process_comp_header);
 
@@ -1188,13 +1265,361 @@ static int record__mmap_read_all(struct record *rec, bool synch)
 {
 	int err;
 
-	err = record__mmap_read_evlist(rec, rec->evlist, false, synch);
-	if (err)
-		return err;
+	/* The regular mmaps are drained by the reader threads. */
+	if (!record__threads_enabled(rec)) {
+		err = record__mmap_read_evlist(rec, rec->evlist, false, synch);
+		if (err)
+			return err;
+	}
 
 	return record__mmap_read_evlist(rec, rec->evlist, true, synch);
 }
 
+static int record__thread_mmap_read(struct record_thread *t, bool synch)
+{
+	int i;
+
+	for (i = 0; i < t->nr_mmaps; i++) {
+		struct mmap *map = t->maps[i];
+		u64 flush = 0;
+		int rc;
+
+		if (!map->core.base)
+			continue;
+
+		if (synch) {
+			flush = map->core.flush;
+			map->core.flush = 1;
+		}
+		rc = perf_mmap__push(map, t->rec, record__pushfn);
+		if (synch)
+			map->core.flush = flush;
+		if (rc < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static void record__thread_munmap_filtered(struct fdarray *fda, int fd,
+					   void *arg __maybe_unused)
+{
+	struct perf_mmap *map = fda->priv[fd].ptr;
+
+	if (map)
+		perf_mmap__put(map);
+}
+
+static void *record__thread(void *arg)
+{
+	struct record_thread *t = arg;
+	bool terminate = false;
+	int err = 0;
+
+	thread = t;
+
+	if (CPU_COUNT(&t->mask) &&
+	    sched_setaffinity(0, sizeof(t->mask), &t->mask))
+		pr_debug("failed to set reader thread affinity: %m\n");
+
+	for (;;) {
+		unsigned long long hits = t->samples;
+
+		err = record__thread_mmap_read(t, false);
+		if (err < 0)
+			break;
+
+		if (hits == t->samples) {
+			if (terminate)
+				break;
+
+			err = fdarray__poll(&t->pollfd, -1);
+			if (err > 0 || (err < 0 && errno == EINTR))
+				err = 0;
+			t->waking++;
+
+			/* The main thread closed its end, drain and exit. */
+			if (t->pollfd.entries[t->msg_pos].revents)
+				terminate = true;
+
+			if (fdarray__filter(&t->pollfd, POLLERR | POLLHUP,
+					    record__thread_munmap_filtered, NULL) == 0)
+				terminate = true;
+		}
+	}
+
+	if (!err)
+		err = record__thread_mmap_read(t, true);
+
+	t->err = err;
+	close(t->ack[1]);
+	t->ack[1] = -1;
+
+	return NULL;
+}
+
+static int record__threads_nr_map(struct record *rec, int *map_thread)
+{
+	struct evlist *evlist = rec->evlist;
+	int nr_mmaps = evlist->core.nr_mmaps;
+	int i, nr_threads = 0;
+	int *node_thread;
+
+	switch (rec->threads_spec) {
+	case THREAD_SPEC__CPU:
+		for (i = 0; i < nr_mmaps; i++)
+			map_thread[i] = i;
+		nr_threads = nr_mmaps;
+		break;
+	case THREAD_SPEC__NUMA:
+		cpu__setup_cpunode_map();
+
+		node_thread = malloc(cpu__max_node() * sizeof(int));
+		if (!node_thread)
+			return -ENOMEM;
+		for (i = 0; i < cpu__max_node(); i++)
+			node_thread[i] = -1;
+
+		for (i = 0; i < nr_mmaps; i++) {
+			int cpu = evlist->mmap[i].core.cpu;
+			int node = cpu >= 0 ? cpu__get_node(cpu) : 0;
+
+			if (node < 0 || node >= cpu__max_node())
+				node = 0;
+			if (node_thread[node] < 0)
+				node_thread[node] = nr_threads++;
+			map_thread[i] = node_thread[node];
+		}
+		free(node_thread);
+		break;
+	case THREAD_SPEC__USER:
+		nr_threads = min(rec->threads_user_nr, nr_mmaps);
+		for (i = 0; i < nr_mmaps; i++)
+			map_thread[i] = i * nr_threads / nr_mmaps;
+		break;
+	case THREAD_SPEC__UNDEFINED:
+	default:
+		break;
+	}
+
+	return nr_threads;
+}
+
+static void record__free_threads(struct record *rec)
+{
+	int t;
+
+	for (t = 0; t < rec->nr_threads; t++) {
+		struct record_thread *thread_data = &rec->thread_data[t];
+		int i;
+
+		for (i = 0; i < 2; i++) {
+			if (thread_data->msg[i] >= 0)
+				close(thread_data->msg[i]);
+			if (thread_data->ack[i] >= 0)
+				close(thread_data->ack[i]);
+		}
+		fdarray__exit(&thread_data->pollfd);
+		zstd_fini(&thread_data->zstd_data);
+		zfree(&thread_data->maps);
+	}
+
+	zfree(&rec->thread_data);
+	rec->nr_threads = 0;
+}
+
+/*
+ * Spread the regular mmaps over the reader threads according to the
+ * --threads spec and hand each thread the poll entries of its mmaps.
+ * The entries are disabled in the evlist pollfd so that the main thread
+ * only polls the control, wakeup and ack fds.
+ */
+static int record__alloc_threads(struct record *rec)
+{
+	struct evlist *evlist = rec->evlist;
+	struct fdarray *fda = &evlist->core.pollfd;
+	int nr_mmaps = evlist->core.nr_mmaps;
+	int *map_thread, i, t, nr_threads;
+	int err = -ENOMEM;
+
+	if (!nr_mmaps || !evlist->mmap) {
+		pr_err("No mmaps to hand over to the reader threads\n");
+		return -EINVAL;
+	}
+
+	map_thread = calloc(nr_mmaps, sizeof(int));
+	if (!map_thread)
+		return -ENOMEM;
+
+	nr_threads = record__threads_nr_map(rec, map_thread);
+	if (nr_threads <= 0) {
+		err = nr_threads ?: -EINVAL;
+		goto out_free;
+	}
+
+	rec->thread_data = zalloc(nr_threads * sizeof(*rec->thread_data));
+	if (!rec->thread_data)
+		goto out_free;
+	rec->nr_threads = nr_threads;
+
+	for (t = 0; t < nr_threads; t++) {
+		struct record_thread *thread_data = &rec->thread_data[t];
+
+		thread_data->rec = rec;
+		thread_data->msg[0] = thread_data->msg[1] = -1;
+		thread_data->ack[0] = thread_data->ack[1] = -1;
+		fdarray__init(&thread_data->pollfd, 64);
+		CPU_ZERO(&thread_data->mask);
+
+		thread_data->maps = calloc(nr_mmaps, sizeof(struct mmap *));
+		if (!thread_data->maps)
+			goto out_free_threads;
+
+		if (zstd_init(&thread_data->zstd_data, rec->opts.comp_level) < 0) {
+			pr_err("Compression initialization failed.\n");
+			err = -1;
+			goto out_free_threads;
+		}
+
+		if (pipe(thread_data->msg) || pipe(thread_data->ack)) {
+			pr_err("Failed to create reader thread pipes: %m\n");
+			err = -errno;
+			goto out_free_threads;
+		}
+
+		thread_data->msg_pos = fdarray__add(&thread_data->pollfd, thread_data->msg[0],
+						    POLLIN | POLLERR | POLLHUP,
+						    fdarray_flag__nonfilterable);
+		if (thread_data->msg_pos < 0)
+			goto out_free_threads;
+
+		if (evlist__add_pollfd(evlist, thread_data->ack[0]) < 0)
+			goto out_free_threads;
+	}
+
+	for (i = 0; i < nr_mmaps; i++) {
+		struct record_thread *thread_data = &rec->thread_data[map_thread[i]];
+		struct mmap *map = &evlist->mmap[i];
+
+		thread_data->maps[thread_data->nr_mmaps++] = map;
+		if (map->core.cpu >= 0)
+			CPU_SET(map->core.cpu, &thread_data->mask);
+	}
+
+	for (i = 0; i < fda->nr; i++) {
+		struct mmap *map = fda->priv[i].ptr;
+		struct record_thread *thread_data;
+		int pos;
+
+		if (!map || map < evlist->mmap || map >= evlist->mmap + nr_mmaps ||
+		    !fda->entries[i].events)
+			continue;
+
+		thread_data = &rec->thread_data[map_thread[map - evlist->mmap]];
+		pos = fdarray__add(&thread_data->pollfd, fda->entries[i].fd,
+				   fda->entries[i].events, fdarray_flag__default);
+		if (pos < 0)
+			goto out_free_threads;
+		thread_data->pollfd.priv[pos].ptr = map;
+
+		fda->entries[i].fd = -1;
+		fda->entries[i].events = 0;
+		fda->entries[i].revents = 0;
+	}
+
+	err = perf_data__create_dir(&rec->data, nr_threads);
+	if (err) {
+		pr_err("Failed to create data directory: %m\n");
+		goto out_free_threads;
+	}
+
+	for (t = 0; t < nr_threads; t++)
+		rec->thread_data[t].file = &rec->data.dir.files[t];
+
+	free(map_thread);
+	return 0;
+
+out_free_threads:
+	record__free_threads(rec);
+out_free:
+	free(map_thread);
+	return err;
+}
+
+static int record__stop_threads(struct record *rec, unsigned long *waking)
+{
+	int t, err = 0;
+
+	for (t = 0; t < rec->nr_threads_started; t++) {
+		struct record_thread *thread_data = &rec->thread_data[t];
+
+		close(thread_data->msg[1]);
+		thread_data->msg[1] = -1;
+	}
+
+	for (t = 0; t < rec->nr_threads_started; t++) {
+		struct record_thread *thread_data = &rec->thread_data[t];
+
+		pthread_join(thread_data->tid, NULL);
+
+		pr_debug("threads[%d]: samples=%lld, wakes=%ld, ",
+			 t, thread_data->samples, thread_data->waking);
+		if (thread_data->bytes_transferred && thread_data->bytes_compressed)
+			pr_debug("transferred=%" PRIu64 ", compressed=%" PRIu64 "\n",
+				 thread_data->bytes_transferred,
+				 thread_data->bytes_compressed);
+		else
+			pr_debug("written=%" PRIu64 "\n", thread_data->bytes_written);
+
+		rec->samples += thread_data->samples;
+		rec->session->bytes_transferred += thread_data->bytes_transferred;
+		rec->session->bytes_compressed += thread_data->bytes_compressed;
+		if (waking)
+			*waking += thread_data->waking;
+		if (thread_data->err)
+			err = thread_data->err;
+	}
+
+	rec->nr_threads_started = 0;
+
+	return err;
+}
+
+static int record__start_threads(struct record *rec)
+{
+	sigset_t full, mask;
+	int t, err = 0;
+
+	/* Signals are for the main thread to handle. */
+	sigfillset(&full);
+	if (pthread_sigmask(SIG_SETMASK, &full, &mask)) {
+		pr_err("Failed to block signals on reader threads start: %m\n");
+		return -1;
+	}
+
+	for (t = 0; t < rec->nr_threads; t++) {
+		struct record_thread *thread_data = &rec->thread_data[t];
+
+		err = pthread_create(&thread_data->tid, NULL, record__thread, thread_data);
+		if (err) {
+			pr_err("Failed to start reader thread %d: %s\n", t, strerror(err));
+			err = -err;
+			break;
+		}
+		rec->nr_threads_started++;
+	}
+
+	if (pthread_sigmask(SIG_SETMASK, &mask, NULL))
+		pr_err("Failed to unblock signals on reader threads start: %m\n");
+
+	if (err)
+		record__stop_threads(rec, NULL);
+
+	pr_debug("Started %d reader threads\n", rec->nr_threads_started);
+
+	return err;
+}
+
 static void record__init_features(struct record *rec)
 {
 	struct perf_session *session = rec->session;
@@ -1221,7 +1646,8 @@ static void record__init_features(struct record *rec)
 	if (!rec->opts.use_clockid)
 		perf_header__clear_feat(&session->header, HEADER_CLOCK_DATA);
 
-	perf_header__clear_feat(&session->header, HEADER_DIR_FORMAT);
+	if (!record__threads_enabled(rec))
+		perf_header__clear_feat(&session->header, HEADER_DIR_FORMAT);
 	if (!record__comp_enabled(rec))
 		perf_header__clear_feat(&session->header, HEADER_COMPRESSED);
 
@@ -1239,6 +1665,8 @@ record__finish_output(struct record *rec)
 
 	rec->session->header.data_size += rec->bytes_written;
 	data->file.size = lseek(perf_data__fd(data), 0, SEEK_CUR);
+	if (record__threads_enabled(rec))
+		perf_data__update_dir(data);
 
 	if (!rec->no_buildid) {
 		process_buildids(rec);
@@ -1661,6 +2089,13 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 	fd = perf_data__fd(data);
 	rec->session = session;
 
+	if (record__threads_enabled(rec) &&
+	    (perf_data__is_pipe(data) || rec->opts.full_auxtrace)) {
+		pr_err("Parallel streaming mode (--threads) can't be used with %s.\n",
+		       perf_data__is_pipe(data) ? "pipe output" : "AUX area tracing");
+		return -1;
+	}
+
 	if (zstd_init(&session->zstd_data, rec->opts.comp_level) < 0) {
 		pr_err("Compression initialization failed.\n");
 		return -1;
@@ -1721,6 +2156,12 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 	}
 	session->header.env.comp_mmap_len = session->evlist->core.mmap_len;
 
+	if (record__threads_enabled(rec)) {
+		err = record__alloc_threads(rec);
+		if (err)
+			goto out_child;
+	}
+
 	if (rec->opts.kcore) {
 		err = record__kcore_copy(&session->machines.host, data);
 		if (err) {
@@ -1857,6 +2298,12 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 		}
 	}
 
+	if (record__threads_enabled(rec)) {
+		err = record__start_threads(rec);
+		if (err)
+			goto out_child;
+	}
+
 	trigger_ready(&auxtrace_snapshot_trigger);
 	trigger_ready(&switch_output_trigger);
 	perf_hooks__invoke_record_start();
@@ -1981,6 +2428,12 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 	trigger_off(&auxtrace_snapshot_trigger);
 	trigger_off(&switch_output_trigger);
 
+	if (record__stop_threads(rec, &waking)) {
+		pr_err("Reader threads failed to stream the data\n");
+		err = -1;
+		goto out_child;
+	}
+
 	if (opts->auxtrace_snapshot_on_exit)
 		record__auxtrace_snapshot_exit(rec);
 
@@ -2003,6 +2456,8 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 		record__synthesize_workload(rec, true);
 
 out_child:
+	if (record__stop_threads(rec, NULL) && !err)
+		err = -1;
 	evlist__finalize_ctlfd(rec->evlist);
 	record__mmap_read_all(rec, true);
 	record__aio_mmap_read_sync(rec);
@@ -2029,6 +2484,9 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 	} else
 		status = err;
 
+	if (rec->off_cpu)
+		rec->bytes_written += off_cpu_write(rec->session);
+
 	record__synthesize(rec, true);
 	/* this will be recalculated during process_buildids() */
 	rec->samples = 0;
@@ -2074,6 +2532,7 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 	if (done_fd >= 0)
 		close(done_fd);
 #endif
+	record__free_threads(rec);
 	zstd_fini(&session->zstd_data);
 	perf_session__delete(session);
 
@@ -2173,6 +2632,32 @@ static int perf_record_config(const char *var, const char *value, void *cb)
 }
 
 
+static int record__parse_threads(const struct option *opt, const char *str, int unset)
+{
+	struct record *rec = (struct record *)opt->value;
+	char *endptr;
+
+	if (unset) {
+		rec->threads_spec = THREAD_SPEC__UNDEFINED;
+		return 0;
+	}
+
+	if (!str || !strcasecmp(str, "cpu")) {
+		rec->threads_spec = THREAD_SPEC__CPU;
+	} else if (!strcasecmp(str, "numa")) {
+		rec->threads_spec = THREAD_SPEC__NUMA;
+	} else {
+		rec->threads_user_nr = strtol(str, &endptr, 0);
+		if (*endptr || rec->threads_user_nr <= 0) {
+			pr_err("Invalid --threads spec: %s\n", str);
+			return -1;
+		}
+		rec->threads_spec = THREAD_SPEC__USER;
+	}
+
+	return 0;
+}
+
 static int record__parse_affinity(const struct option *opt, const char *str, int unset)
 {
 	struct record_opts *opts = (struct record_opts *)opt->value;
@@ -2615,6 +3100,9 @@ static struct option __record_options[] = {
 			    "n", "Compressed records using specified level (default: 1 - fastest compression, 22 - greatest compression)",
 			    record__parse_comp_level),
 #endif
+	OPT_CALLBACK_OPTARG(0, "threads", &record, NULL, "cpu|numa|n",
+			    "Stream the mmaps into a perf.data directory with parallel reader threads: one per cpu (default), one per NUMA node or <n> threads",
+			    record__parse_threads),
 	OPT_CALLBACK(0, "max-size", &record.output_max_size,
 		     "size", "Limit the maximum size of the output file", parse_output_max_size),
 	OPT_UINTEGER(0, "num-thread-synthesize",
@@ -2631,6 +3119,8 @@ static struct option __record_options[] = {
 		     "\t\t\t  Optionally send control command completion ('ack\\n') to ack-fd descriptor.\n"
 		     "\t\t\t  Alternatively, ctl-fifo / ack-fifo will be opened and used as ctl-fd / ack-fd.",
 		      parse_control_option),
+	OPT_BOOLEAN(0, "off-cpu", &record.off_cpu,
+		    "Record the blocking stacks and wait times with BPF, as offcpu-time samples"),
 	OPT_END()
 };
 
@@ -2651,6 +3141,10 @@ int cmd_record(int argc, const char **argv)
 # undef set_nobuild
 #endif
 
+#ifndef HAVE_BPF_SKEL
+	set_option_nobuild(record_options, '\0', "off-cpu", "no BUILD_BPF_SKEL=1", true);
+#endif
+
 #ifndef HAVE_BPF_PROLOGUE
 # if !defined (HAVE_DWARF_SUPPORT)
 #  define REASON  "NO_DWARF=1"
@@ -2714,6 +3208,33 @@ int cmd_record(int argc, const char **argv)
 	if (rec->opts.kcore)
 		rec->data.is_dir = true;
 
+	if (record__threads_enabled(rec)) {
+		const char *conflict = NULL;
+
+		if (rec->opts.affinity != PERF_AFFINITY_SYS)
+			conflict = "--affinity";
+		else if (rec->opts.nr_cblocks)
+			conflict = "--aio";
+		else if (rec->switch_output.str)
+			conflict = "--switch-output";
+		else if (rec->output_max_size)
+			conflict = "--max-size";
+		else if (rec->timestamp_filename)
+			conflict = "--timestamp-filename";
+		else if (rec->opts.overwrite)
+			conflict = "--overwrite";
+		else if (rec->opts.auxtrace_snapshot_opts || rec->opts.auxtrace_sample_opts)
+			conflict = "AUX area tracing";
+
+		if (conflict) {
+			pr_err("%s is mutually exclusive to parallel streaming mode (--threads).\n",
+			       conflict);
+			err = -EINVAL;
+			goto out_opts;
+		}
+		rec->data.is_dir = true;
+	}
+
 	if (rec->opts.comp_level != 0) {
 		pr_debug("Compression enabled, disabling build id collection at the end of the session.\n");
 		rec->no_buildid = true;
@@ -2878,6 +3399,14 @@ int cmd_record(int argc, const char **argv)
 	if (rec->opts.full_auxtrace)
 		rec->buildid_all = true;
 
+	if (rec->off_cpu) {
+		err = record__config_off_cpu(rec);
+		if (err) {
+			pr_err("record__config_off_cpu failed, error %d\n", err);
+			goto out;
+		}
+	}
+
 	if (rec->opts.text_poke) {
 		err = record__config_text_poke(rec->evlist);
 		if (err) {
@@ -1218,6 +1218,8 @@ int cmd_report(int argc, const char **argv)
 		    "Show a column with the number of samples"),
 	OPT_BOOLEAN('T', "threads", &report.show_threads,
 		    "Show per-thread event counters"),
+	OPT_UINTEGER(0, "load-threads", &symbol_conf.nr_load_threads,
+		     "Preload the user space DSO symbols using <n> threads, samples are still processed serially"),
 	OPT_STRING(0, "pretty", &report.pretty_printing_style, "key",
 		   "pretty printing style key: normal raw"),
 	OPT_BOOLEAN(0, "tui", &report.use_tui, "Use the TUI interface"),
@@ -19,6 +19,9 @@
 #include "util/string2.h"
 #include "util/callchain.h"
 #include "util/time-utils.h"
+#include "util/log2-hist.h"
+#include "util/sched-latency.h"
+#include "util/target.h"
 
 #include <subcmd/pager.h>
 #include <subcmd/parse-options.h>
@@ -38,6 +41,7 @@
 #include <semaphore.h>
 #include <pthread.h>
 #include <math.h>
+#include <signal.h>
 #include <api/fs/fs.h>
 #include <perf/cpumap.h>
 #include <linux/time64.h>
@@ -230,6 +234,12 @@ struct perf_sched {
 	bool skip_merge;
 	struct perf_sched_map map;
 
+	/* options for latency command with BPF */
+	bool		use_bpf;
+	bool		bpf_per_cgroup;
+	bool		bpf_hist_only;
+	int		bpf_map_entries;
+
 	/* options for timehist command */
 	bool		summary;
 	bool		summary_only;
@@ -3205,6 +3215,189 @@ static int perf_sched__lat(struct perf_sched *sched)
 	return 0;
 }
 
+/*
+ * perf sched latency --use-bpf: the delays are computed and aggregated in
+ * the kernel by a BPF program on the sched_wakeup{,_new} and sched_switch
+ * tracepoints, nothing is recorded and only the summary is read back.
+ */
+static volatile sig_atomic_t sched_lat_done;
+
+static void sched_lat_sighandler(int sig __maybe_unused)
+{
+	sched_lat_done = 1;
+}
+
+static int sched_lat_entry_cmp_comm(const void *a, const void *b)
+{
+	const struct sched_latency_entry *one = a, *two = b;
+
+	return strcmp(one->data.comm, two->data.comm);
+}
+
+static int sched_lat_entry_cmp_max(const void *a, const void *b)
+{
+	const struct sched_latency_entry *one = a, *two = b;
+	u64 v1 = one->data.runq_max, v2 = two->data.runq_max;
+
+	return v1 < v2 ? 1 : v1 > v2 ? -1 : 0;
+}
+
+/* fold the per-thread entries with the same comm, as done without -p */
+static void sched_lat_merge_comm(struct sched_latency *lat)
+{
+	struct sched_latency_entry *dst = NULL;
+	int i, nr = 0;
+
+	qsort(lat->entries, lat->nr_entries, sizeof(*lat->entries),
+	      sched_lat_entry_cmp_comm);
+
+	for (i = 0; i < lat->nr_entries; i++) {
+		struct sched_latency_entry *src = &lat->entries[i];
+
+		if (dst && !strcmp(dst->data.comm, src->data.comm)) {
+			dst->data.wakeup_total += src->data.wakeup_total;
+			dst->data.wakeup_count += src->data.wakeup_count;
+			dst->data.wakeup_max = max(dst->data.wakeup_max, src->data.wakeup_max);
+			dst->data.runq_total += src->data.runq_total;
+			dst->data.runq_count += src->data.runq_count;
+			dst->data.runq_max = max(dst->data.runq_max, src->data.runq_max);
+			zfree(&src->name);
+			continue;
+		}
+
+		dst = &lat->entries[nr++];
+		if (dst != src) {
+			*dst = *src;
+			src->name = NULL;
+		}
+		free(dst->name);
+		dst->name = strdup(dst->data.comm);
+	}
+	lat->nr_entries = nr;
+}
+
+static double sched_lat_avg_ms(u64 total, u32 count)
+{
+	return count ? (double)total / count / NSEC_PER_MSEC : 0;
+}
+
+static void sched_lat_print_bpf(struct perf_sched *sched, struct sched_latency *lat)
+{
+	int i;
+
+	if (lat->aggr_mode != SCHED_AGGR_NONE) {
+		if (lat->aggr_mode == SCHED_AGGR_TASK && !sched->skip_merge)
+			sched_lat_merge_comm(lat);
+
+		qsort(lat->entries, lat->nr_entries, sizeof(*lat->entries),
+		      sched_lat_entry_cmp_max);
+
+		printf("\n -----------------------------------------------------------------------------------------------------------------------\n");
+		printf("  %-22s|  Wakeups | Avg wakeup ms | Max wakeup ms |  Runq waits | Avg runq ms | Max runq ms |\n",
+		       lat->aggr_mode == SCHED_AGGR_CGROUP ? "Cgroup" : "Task");
+		printf(" -----------------------------------------------------------------------------------------------------------------------\n");
+
+		for (i = 0; i < lat->nr_entries; i++) {
+			struct sched_latency_entry *e = &lat->entries[i];
+
+			if (e->name)
+				printf("  %-22s|", e->name);
+			else
+				printf("  %#-22" PRIx64 "|", e->key);
+
+			printf("%9u |%14.3f |%14.3f |%12u |%12.3f |%12.3f |\n",
+			       e->data.wakeup_count,
+			       sched_lat_avg_ms(e->data.wakeup_total, e->data.wakeup_count),
+			       (double)e->data.wakeup_max / NSEC_PER_MSEC,
+			       e->data.runq_count,
+			       sched_lat_avg_ms(e->data.runq_total, e->data.runq_count),
+			       (double)e->data.runq_max / NSEC_PER_MSEC);
+		}
+		printf(" -----------------------------------------------------------------------------------------------------------------------\n");
+	}
+
+	if (lat->lost)
+		printf("\n  WARNING: %d events could not be recorded, try a bigger --map-nr-entries\n",
+		       lat->lost);
+
+	printf("\n wakeup latency:\n\n");
+	log2_hist__fprintf(stdout, lat->wakeup_hist, SCHED_HIST_SLOTS, "usecs");
+	printf("\n runqueue delay:\n\n");
+	log2_hist__fprintf(stdout, lat->runq_hist, SCHED_HIST_SLOTS, "usecs");
+	printf("\n");
+}
+
+static int perf_sched__lat_bpf(struct perf_sched *sched, int argc, const char **argv)
+{
+	struct target target = {
+		.system_wide	= true,
+		.uid		= UINT_MAX,
+	};
+	struct sched_latency lat = {
+		.aggr_mode	= SCHED_AGGR_TASK,
+		.map_nr_entries	= sched->bpf_map_entries,
+	};
+	struct evlist *evlist = NULL;
+	int err = -EINVAL;
+
+	if (sched->profile_cpu != -1) {
+		pr_err("-C/--CPU is not supported with --use-bpf\n");
+		return -EINVAL;
+	}
+
+	if (sched->bpf_hist_only)
+		lat.aggr_mode = SCHED_AGGR_NONE;
+	else if (sched->bpf_per_cgroup)
+		lat.aggr_mode = SCHED_AGGR_CGROUP;
+
+	signal(SIGINT, sched_lat_sighandler);
+	signal(SIGCHLD, sched_lat_sighandler);
+	signal(SIGTERM, sched_lat_sighandler);
+
+	if (argc) {
+		evlist = evlist__new();
+		if (evlist == NULL)
+			return -ENOMEM;
+
+		err = evlist__prepare_workload(evlist, &target, argv, false, NULL);
+		if (err) {
+			pr_err("Couldn't run the workload!\n");
+			goto out;
+		}
+	}
+
+	err = sched_latency_prepare(&lat);
+	if (err) {
+		pr_err("sched latency BPF setup failed, "
+		       "was perf built with BUILD_BPF_SKEL=1?\n");
+		goto out;
+	}
+
+	sched_latency_start();
+	if (argc)
+		evlist__start_workload(evlist);
+
+	/* wait for the workload to finish or for a signal */
+	while (!sched_lat_done)
+		pause();
+
+	sched_latency_stop();
+
+	err = sched_latency_read(&lat);
+	if (err) {
+		pr_err("Failed to read the sched latency data\n");
+		goto out;
+	}
+
+	setup_pager();
+	sched_lat_print_bpf(sched, &lat);
+
+out:
+	sched_latency_finish(&lat);
+	evlist__delete(evlist);
+	return err;
+}
+
 static int setup_map_cpus(struct perf_sched *sched)
 {
 	struct perf_cpu_map *map;
@@ -3433,6 +3626,7 @@ int cmd_sched(int argc, const char **argv)
 		.skip_merge           = 0,
 		.show_callchain	      = 1,
 		.max_stack            = 5,
+		.bpf_map_entries      = 10240,
 	};
 	const struct option sched_options[] = {
 	OPT_STRING('i', "input", &input_name, "file",
@@ -3451,6 +3645,14 @@ int cmd_sched(int argc, const char **argv)
 		    "CPU to profile on"),
 	OPT_BOOLEAN('p', "pids", &sched.skip_merge,
 		    "latency stats per pid instead of per comm"),
+	OPT_BOOLEAN('b', "use-bpf", &sched.use_bpf,
+		    "measure system-wide in the kernel with BPF, no recording"),
+	OPT_BOOLEAN(0, "per-cgroup", &sched.bpf_per_cgroup,
+		    "latency stats per cgroup (with --use-bpf)"),
+	OPT_BOOLEAN(0, "hist-only", &sched.bpf_hist_only,
+		    "only show the latency histograms (with --use-bpf)"),
+	OPT_INTEGER(0, "map-nr-entries", &sched.bpf_map_entries,
+		    "max number of BPF map entries (with --use-bpf)"),
 	OPT_PARENT(sched_options)
 	};
 	const struct option replay_options[] = {
@@ -3502,6 +3704,7 @@ int cmd_sched(int argc, const char **argv)
 
 	const char * const latency_usage[] = {
 		"perf sched latency [<options>]",
+		"perf sched latency --use-bpf [<options>] [<command>]",
 		NULL
 	};
 	const char * const replay_usage[] = {
@@ -3558,9 +3761,15 @@ int cmd_sched(int argc, const char **argv)
 	} else if (!strncmp(argv[0], "lat", 3)) {
 		sched.tp_handler = &lat_ops;
 		if (argc > 1) {
-			argc = parse_options(argc, argv, latency_options, latency_usage, 0);
-			if (argc)
+			argc = parse_options(argc, argv, latency_options, latency_usage,
+					     PARSE_OPT_STOP_AT_NON_OPTION);
+			if (argc && !sched.use_bpf)
+				usage_with_options(latency_usage, latency_options);
+		}
+		if (sched.use_bpf) {
+			if (sched.bpf_map_entries <= 0)
 				usage_with_options(latency_usage, latency_options);
+			return perf_sched__lat_bpf(&sched, argc, argv);
 		}
 		setup_sorting(&sched, latency_options, latency_usage);
 		return perf_sched__lat(&sched);
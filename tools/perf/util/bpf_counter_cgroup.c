@@ -4,6 +4,7 @@
 /* Copyright (c) 2021 Google */
 
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <unistd.h>
 #include <sys/file.h>
@@ -241,6 +242,49 @@ static int bperf_cgrp__disable(struct evsel *evsel)
 	return 0;
 }
 
+/*
+ * Read the per-cpu readings of all the events of all the cgroups at once:
+ * looking them up one by one costs a syscall per event per cgroup at every
+ * interval, which adds up quickly with thousands of cgroups. The readings
+ * map is an array so the batch comes back in index order. Fall back to
+ * single lookups on kernels without batch ops for array maps.
+ */
+static int bperf_cgrp__lookup_readings(int map_fd, __u32 nr_entries,
+				       struct bpf_perf_event_value *values)
+{
+	static bool no_batch;
+	int total_cpus = cpu__max_cpu();
+	__u32 idx, out_batch, count;
+	__u32 *keys;
+	int err;
+
+	if (!no_batch) {
+		keys = calloc(nr_entries, sizeof(*keys));
+		if (keys == NULL)
+			return -ENOMEM;
+
+		count = nr_entries;
+		err = bpf_map_lookup_batch(map_fd, NULL, &out_batch, keys, values,
+					   &count, NULL);
+		free(keys);
+
+		/* ENOENT tells the whole map was read */
+		if ((!err || errno == ENOENT) && count == nr_entries)
+			return 0;
+
+		pr_debug("bpf map batch lookup failed, falling back to single lookups\n");
+		no_batch = true;
+	}
+
+	for (idx = 0; idx < nr_entries; idx++) {
+		err = bpf_map_lookup_elem(map_fd, &idx, values + idx * total_cpus);
+		if (err)
+			return err;
+	}
+
+	return 0;
+}
+
 static int bperf_cgrp__read(struct evsel *evsel)
 {
 	struct evlist *evlist = evsel->evlist;
@@ -249,35 +293,36 @@ static int bperf_cgrp__read(struct evsel *evsel)
 	struct perf_counts_values *counts;
 	struct bpf_perf_event_value *values;
 	int reading_map_fd, err = 0;
-	__u32 idx;
 
 	if (evsel->core.idx)
 		return 0;
 
 	bperf_cgrp__sync_counters(evsel->evlist);
 
-	values = calloc(total_cpus, sizeof(*values));
+	values = calloc((size_t)total_cpus * evlist->core.nr_entries, sizeof(*values));
 	if (values == NULL)
 		return -ENOMEM;
 
 	reading_map_fd = bpf_map__fd(skel->maps.cgrp_readings);
 
+	err = bperf_cgrp__lookup_readings(reading_map_fd, evlist->core.nr_entries, values);
+	if (err) {
+		pr_err("bpf map lookup failed: %d\n", err);
+		goto out;
+	}
+
 	evlist__for_each_entry(evlist, evsel) {
-		idx = evsel->core.idx;
-		err = bpf_map_lookup_elem(reading_map_fd, &idx, values);
-		if (err) {
-			pr_err("bpf map lookup falied: idx=%u, event=%s, cgrp=%s\n",
-			       idx, evsel__name(evsel), evsel->cgrp->name);
-			goto out;
-		}
+		struct bpf_perf_event_value *evsel_values;
+
+		evsel_values = values + evsel->core.idx * total_cpus;
 
 		for (i = 0; i < nr_cpus; i++) {
 			cpu = evlist->core.all_cpus->map[i];
 
 			counts = perf_counts(evsel->counts, i, 0);
-			counts->val = values[cpu].counter;
-			counts->ena = values[cpu].enabled;
-			counts->run = values[cpu].running;
+			counts->val = evsel_values[cpu].counter;
+			counts->ena = evsel_values[cpu].enabled;
+			counts->run = evsel_values[cpu].running;
 		}
 	}
 
@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <linux/err.h>
+#include <linux/rbtree.h>
+#include <linux/zalloc.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+
+#include "bpf_counter.h"
+#include "cgroup.h"
+#include "debug.h"
+#include "lock-contention.h"
+#include "machine.h"
+#include "map.h"
+#include "symbol.h"
+
+#include "bpf_skel/lock_contention.skel.h"
+
+/*
+ * Frames of the BPF program and the tracepoint itself, found on top of
+ * every stack saved in contention_begin.
+ */
+#define CONTENTION_STACK_SKIP	3
+
+static struct lock_contention_bpf *skel;
+
+/* text sections holding the lock functions, to find the real caller */
+static u64 sched_text_start, sched_text_end;
+static u64 lock_text_start, lock_text_end;
+
+static u64 kernel_symbol_addr(struct machine *machine, const char *name)
+{
+	struct map *kmap;
+	struct symbol *sym;
+
+	sym = machine__find_kernel_symbol_by_name(machine, name, &kmap);
+	if (sym == NULL)
+		return 0;
+
+	return kmap->unmap_ip(kmap, sym->start);
+}
+
+static bool is_lock_function(u64 addr)
+{
+	return (addr >= sched_text_start && addr < sched_text_end) ||
+	       (addr >= lock_text_start && addr < lock_text_end);
+}
+
+int lock_contention_prepare(struct lock_contention *con)
+{
+	skel = lock_contention_bpf__open();
+	if (!skel) {
+		pr_err("Failed to open lock-contention BPF skeleton\n");
+		return -1;
+	}
+
+	skel->rodata->aggr_mode = con->aggr_mode;
+	skel->rodata->stack_skip = CONTENTION_STACK_SKIP;
+
+	bpf_map__resize(skel->maps.tstamp, con->map_nr_entries);
+	bpf_map__resize(skel->maps.lock_stat, con->map_nr_entries);
+
+	if (con->aggr_mode == LOCK_AGGR_CALLER)
+		bpf_map__resize(skel->maps.stacks, con->map_nr_entries);
+	else
+		bpf_map__resize(skel->maps.stacks, 1);
+
+	if (con->aggr_mode == LOCK_AGGR_TASK)
+		bpf_map__resize(skel->maps.task_data, con->map_nr_entries);
+
+	set_max_rlimit();
+
+	if (lock_contention_bpf__load(skel) < 0) {
+		pr_err("Failed to load lock-contention BPF skeleton\n");
+		goto out_destroy;
+	}
+
+	if (lock_contention_bpf__attach(skel) < 0) {
+		pr_err("Failed to attach lock-contention BPF program, "
+		       "are the lock:contention_{begin,end} tracepoints available?\n");
+		goto out_destroy;
+	}
+
+	if (con->machine) {
+		sched_text_start = kernel_symbol_addr(con->machine, "__sched_text_start");
+		sched_text_end   = kernel_symbol_addr(con->machine, "__sched_text_end");
+		lock_text_start  = kernel_symbol_addr(con->machine, "__lock_text_start");
+		lock_text_end    = kernel_symbol_addr(con->machine, "__lock_text_end");
+	}
+	return 0;
+
+out_destroy:
+	lock_contention_bpf__destroy(skel);
+	skel = NULL;
+	return -1;
+}
+
+int lock_contention_start(void)
+{
+	skel->bss->enabled = 1;
+	return 0;
+}
+
+int lock_contention_stop(void)
+{
+	skel->bss->enabled = 0;
+	return 0;
+}
+
+static char *caller_name(struct lock_contention *con, int stack_fd, s32 stack_id)
+{
+	u64 stack[LOCK_MAX_STACKS] = {};
+	struct map *kmap;
+	struct symbol *sym;
+	char *name = NULL;
+	int i;
+
+	if (bpf_map_lookup_elem(stack_fd, &stack_id, stack) < 0 || !con->machine)
+		return NULL;
+
+	for (i = 0; i < LOCK_MAX_STACKS && stack[i]; i++) {
+		u64 ip = stack[i];
+		u64 offset;
+
+		/* the first frames are in the lock code itself */
+		if (is_lock_function(ip))
+			continue;
+
+		sym = machine__find_kernel_symbol(con->machine, ip, &kmap);
+		if (sym == NULL)
+			break;
+
+		offset = kmap->map_ip(kmap, ip) - sym->start;
+		if (asprintf(&name, "%s+%#" PRIx64, sym->name, offset) < 0)
+			name = NULL;
+		break;
+	}
+	return name;
+}
+
+static char *task_name(int task_fd, u32 pid)
+{
+	struct contention_task_data data;
+	char *name;
+
+	if (bpf_map_lookup_elem(task_fd, &pid, &data) < 0)
+		return NULL;
+
+	data.comm[sizeof(data.comm) - 1] = '\0';
+	if (asprintf(&name, "%u:%s", pid, data.comm) < 0)
+		return NULL;
+	return name;
+}
+
+static char *cgroup_name(struct rb_root *cgroups, u64 id)
+{
+	struct cgroup *cgrp = __cgroup__find(cgroups, id);
+
+	return cgrp ? strdup(cgrp->name) : NULL;
+}
+
+int lock_contention_read(struct lock_contention *con)
+{
+	int fd, stack_fd, task_fd;
+	struct contention_data *data;
+	struct rb_root cgroups = RB_ROOT;
+	u64 *prev_key, key;
+	int nr = 0, max = con->map_nr_entries;
+	int nr_cpus = libbpf_num_possible_cpus();
+	int i;
+
+	fd = bpf_map__fd(skel->maps.lock_stat);
+	stack_fd = bpf_map__fd(skel->maps.stacks);
+	task_fd = bpf_map__fd(skel->maps.task_data);
+
+	con->lost = skel->bss->lost;
+	for (i = 0; i < LOCK_HIST_SLOTS; i++)
+		con->hist[i] = skel->bss->wait_hist[i];
+
+	if (nr_cpus < 0)
+		return nr_cpus;
+
+	/* one value per possible cpu, they are a multiple of 8 bytes */
+	data = calloc(nr_cpus, sizeof(*data));
+	if (data == NULL)
+		return -ENOMEM;
+
+	con->entries = calloc(max, sizeof(*con->entries));
+	if (con->entries == NULL) {
+		free(data);
+		return -ENOMEM;
+	}
+
+	if (con->aggr_mode == LOCK_AGGR_CGROUP && read_all_cgroups(&cgroups) < 0)
+		pr_debug("Failed to read the cgroup names\n");
+
+	prev_key = NULL;
+	while (nr < max && !bpf_map_get_next_key(fd, prev_key, &key)) {
+		struct lock_contention_entry *entry = &con->entries[nr];
+
+		prev_key = &key;
+		if (bpf_map_lookup_elem(fd, &key, data) < 0)
+			continue;
+
+		entry->key = key;
+		for (i = 0; i < nr_cpus; i++) {
+			entry->total_time += data[i].total_time;
+			entry->count += data[i].count;
+			entry->flags |= data[i].flags;
+			if (entry->max_time < data[i].max_time)
+				entry->max_time = data[i].max_time;
+		}
+
+		switch (con->aggr_mode) {
+		case LOCK_AGGR_TASK:
+			entry->name = task_name(task_fd, key);
+			break;
+		case LOCK_AGGR_CGROUP:
+			entry->name = cgroup_name(&cgroups, key);
+			break;
+		case LOCK_AGGR_CALLER:
+		default:
+			entry->name = caller_name(con, stack_fd, key);
+			break;
+		}
+		nr++;
+	}
+	con->nr_entries = nr;
+
+	cgroups__purge(&cgroups);
+	free(data);
+	return 0;
+}
+
+int lock_contention_finish(struct lock_contention *con)
+{
+	int i;
+
+	for (i = 0; i < con->nr_entries; i++)
+		zfree(&con->entries[i].name);
+	zfree(&con->entries);
+	con->nr_entries = 0;
+
+	if (skel) {
+		skel->bss->enabled = 0;
+		lock_contention_bpf__destroy(skel);
+		skel = NULL;
+	}
+	return 0;
+}
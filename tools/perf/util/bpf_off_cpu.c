@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <perf/threadmap.h>
+#include <bpf/bpf.h>
+
+#include "bpf_counter.h"
+#include "data.h"
+#include "debug.h"
+#include "evlist.h"
+#include "evsel.h"
+#include "off_cpu.h"
+#include "parse-events.h"
+#include "perf-hooks.h"
+#include "session.h"
+#include "target.h"
+
+#include "bpf_skel/off_cpu.skel.h"
+
+/*
+ * Frames of the BPF program and the tracepoint itself, found on top of
+ * every kernel stack saved in sched_switch.
+ */
+#define OFF_CPU_STACK_SKIP	3
+
+/* make the synthesized samples sort after all the real ones */
+#define OFF_CPU_TIMESTAMP	(~0ull << 32)
+
+static struct off_cpu_bpf *skel;
+
+/* sample header, fixed fields and both callchains */
+union off_cpu_data {
+	struct perf_event_header hdr;
+	u64 array[2 * OFF_CPU_MAX_STACKS + 16];
+};
+
+static int off_cpu_config(struct evlist *evlist)
+{
+	struct evsel *evsel;
+	int err;
+
+	err = parse_events(evlist, "bpf-output/no-inherit=1,name=" OFFCPU_EVENT "/", NULL);
+	if (err) {
+		pr_err("Failed to create the " OFFCPU_EVENT " event\n");
+		return -1;
+	}
+
+	/* never sampled by itself, it only owns the samples written later */
+	evsel = evlist__last(evlist);
+	evsel->core.attr.freq = 0;
+	evsel->core.attr.sample_period = 1;
+	return 0;
+}
+
+static void off_cpu_start(void *arg)
+{
+	struct evlist *evlist = arg;
+	u8 val = 1;
+	int pid;
+
+	/* the workload is forked by now, filter its process */
+	if (!skel->bss->has_task &&
+	    perf_thread_map__pid(evlist->core.threads, 0) != -1) {
+		pid = perf_thread_map__pid(evlist->core.threads, 0);
+		bpf_map_update_elem(bpf_map__fd(skel->maps.task_filter), &pid, &val, BPF_ANY);
+		skel->bss->has_task = 1;
+	}
+
+	skel->bss->enabled = 1;
+}
+
+static void off_cpu_finish(void *arg __maybe_unused)
+{
+	off_cpu_bpf__destroy(skel);
+	skel = NULL;
+}
+
+int off_cpu_prepare(struct evlist *evlist, struct target *target)
+{
+	int ntasks = 1;
+	int i, fd;
+	u8 val = 1;
+
+	if (off_cpu_config(evlist) < 0)
+		return -1;
+
+	skel = off_cpu_bpf__open();
+	if (!skel) {
+		pr_err("Failed to open off-cpu BPF skeleton\n");
+		return -1;
+	}
+
+	skel->rodata->stack_skip = OFF_CPU_STACK_SKIP;
+
+	if (target__has_task(target))
+		ntasks = perf_thread_map__nr(evlist->core.threads);
+	bpf_map__resize(skel->maps.task_filter, ntasks);
+
+	set_max_rlimit();
+
+	if (off_cpu_bpf__load(skel) < 0) {
+		pr_err("Failed to load off-cpu BPF skeleton\n");
+		goto out_destroy;
+	}
+
+	if (target__has_task(target)) {
+		fd = bpf_map__fd(skel->maps.task_filter);
+		for (i = 0; i < ntasks; i++) {
+			int pid = perf_thread_map__pid(evlist->core.threads, i);
+
+			bpf_map_update_elem(fd, &pid, &val, BPF_ANY);
+		}
+		skel->bss->has_task = 1;
+	}
+
+	if (off_cpu_bpf__attach(skel) < 0) {
+		pr_err("Failed to attach off-cpu BPF program\n");
+		goto out_destroy;
+	}
+
+	if (perf_hooks__set_hook("record_start", off_cpu_start, evlist) ||
+	    perf_hooks__set_hook("record_end", off_cpu_finish, evlist)) {
+		pr_err("Failed to set the off-cpu hooks\n");
+		goto out_destroy;
+	}
+	return 0;
+
+out_destroy:
+	off_cpu_bpf__destroy(skel);
+	skel = NULL;
+	return -1;
+}
+
+static int off_cpu_callchain(int stack_fd, s32 stack_id, u64 context, u64 *array)
+{
+	int len = 0;
+
+	if (stack_id < 0)
+		return 0;
+
+	memset(&array[1], 0, OFF_CPU_MAX_STACKS * sizeof(u64));
+	if (bpf_map_lookup_elem(stack_fd, &stack_id, &array[1]) < 0)
+		return 0;
+
+	array[0] = context;
+	while (len < OFF_CPU_MAX_STACKS && array[len + 1])
+		len++;
+
+	return len ? len + 1 : 0;
+}
+
+/*
+ * Write one sample per (task, stacks, state, cgroup) with the total wait
+ * time as the period, so the usual 'perf report' machinery, -g folded
+ * included, works on them.  Returns the number of bytes written.
+ */
+int off_cpu_write(struct perf_session *session)
+{
+	struct perf_data_file *file = &session->data->file;
+	struct off_cpu_key prev, key;
+	union off_cpu_data data = {
+		.hdr = {
+			.type = PERF_RECORD_SAMPLE,
+			.misc = PERF_RECORD_MISC_KERNEL,
+		},
+	};
+	u64 tstamp = OFF_CPU_TIMESTAMP;
+	u64 sample_type, val, sid = 0;
+	struct evsel *evsel;
+	int fd, stack_fd, bytes = 0, size;
+	bool first = true;
+
+	if (skel == NULL)
+		return 0;
+
+	skel->bss->enabled = 0;
+
+	evsel = evlist__find_evsel_by_str(session->evlist, OFFCPU_EVENT);
+	if (evsel == NULL) {
+		pr_err("%s evsel not found\n", OFFCPU_EVENT);
+		return 0;
+	}
+
+	sample_type = evsel->core.attr.sample_type;
+	if (sample_type & ~OFFCPU_SAMPLE_TYPES) {
+		pr_err("not supported sample type: %llx\n",
+		       (unsigned long long)sample_type);
+		return 0;
+	}
+
+	if (sample_type & (PERF_SAMPLE_ID | PERF_SAMPLE_IDENTIFIER)) {
+		if (evsel->core.id)
+			sid = evsel->core.id[0];
+	}
+
+	if (skel->bss->lost)
+		pr_warning("off-cpu: %d wait times were lost, the maps are full\n",
+			   skel->bss->lost);
+
+	fd = bpf_map__fd(skel->maps.off_cpu);
+	stack_fd = bpf_map__fd(skel->maps.stacks);
+
+	while (!bpf_map_get_next_key(fd, first ? NULL : &prev, &key)) {
+		int n = 1;  /* start from perf_event_header */
+		int ip_pos = -1;
+
+		first = false;
+		prev = key;
+
+		if (bpf_map_lookup_elem(fd, &key, &val) < 0)
+			continue;
+
+		if (sample_type & PERF_SAMPLE_IDENTIFIER)
+			data.array[n++] = sid;
+		if (sample_type & PERF_SAMPLE_IP) {
+			ip_pos = n;
+			data.array[n++] = 0;  /* will be updated */
+		}
+		if (sample_type & PERF_SAMPLE_TID)
+			data.array[n++] = (u64)key.pid << 32 | key.tgid;
+		if (sample_type & PERF_SAMPLE_TIME)
+			data.array[n++] = tstamp;
+		if (sample_type & PERF_SAMPLE_ID)
+			data.array[n++] = sid;
+		if (sample_type & PERF_SAMPLE_CPU)
+			data.array[n++] = 0;
+		if (sample_type & PERF_SAMPLE_PERIOD)
+			data.array[n++] = val;
+		if (sample_type & PERF_SAMPLE_CALLCHAIN) {
+			int nr_pos = n++;
+			int len;
+
+			len = off_cpu_callchain(stack_fd, key.kernel_stack_id,
+						PERF_CONTEXT_KERNEL, &data.array[n]);
+			/* the sample ip is where the task went to sleep */
+			if (ip_pos >= 0 && len)
+				data.array[ip_pos] = data.array[n + 1];
+			n += len;
+
+			n += off_cpu_callchain(stack_fd, key.user_stack_id,
+					       PERF_CONTEXT_USER, &data.array[n]);
+			data.array[nr_pos] = n - nr_pos - 1;
+		}
+		if (sample_type & PERF_SAMPLE_CGROUP)
+			data.array[n++] = key.cgroup_id;
+
+		size = n * sizeof(u64);
+		data.hdr.size = size;
+		bytes += size;
+
+		if (perf_data_file__write(file, &data, size) < 0) {
+			pr_err("failed to write perf data, error: %m\n");
+			return bytes;
+		}
+
+		/* increase dummy timestamp to sort later samples */
+		tstamp++;
+	}
+	return bytes;
+}
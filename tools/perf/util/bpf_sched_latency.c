@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <linux/rbtree.h>
+#include <linux/zalloc.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+
+#include "bpf_counter.h"
+#include "cgroup.h"
+#include "debug.h"
+#include "sched-latency.h"
+
+#include "bpf_skel/sched_latency.skel.h"
+
+static struct sched_latency_bpf *skel;
+
+int sched_latency_prepare(struct sched_latency *lat)
+{
+	skel = sched_latency_bpf__open();
+	if (!skel) {
+		pr_err("Failed to open sched-latency BPF skeleton\n");
+		return -1;
+	}
+
+	skel->rodata->aggr_mode = lat->aggr_mode;
+
+	bpf_map__resize(skel->maps.enqueue, lat->map_nr_entries);
+	if (lat->aggr_mode != SCHED_AGGR_NONE)
+		bpf_map__resize(skel->maps.sched_stat, lat->map_nr_entries);
+	else
+		bpf_map__resize(skel->maps.sched_stat, 1);
+
+	set_max_rlimit();
+
+	if (sched_latency_bpf__load(skel) < 0) {
+		pr_err("Failed to load sched-latency BPF skeleton\n");
+		goto out_destroy;
+	}
+
+	if (sched_latency_bpf__attach(skel) < 0) {
+		pr_err("Failed to attach sched-latency BPF program\n");
+		goto out_destroy;
+	}
+	return 0;
+
+out_destroy:
+	sched_latency_bpf__destroy(skel);
+	skel = NULL;
+	return -1;
+}
+
+int sched_latency_start(void)
+{
+	skel->bss->enabled = 1;
+	return 0;
+}
+
+int sched_latency_stop(void)
+{
+	skel->bss->enabled = 0;
+	return 0;
+}
+
+/* the comm is only in the copy of the cpu which added the entry */
+static void merge_sched_lat_data(struct sched_lat_data *sum,
+				 const struct sched_lat_data *data, int nr_cpus)
+{
+	int i;
+
+	for (i = 0; i < nr_cpus; i++) {
+		sum->wakeup_total += data[i].wakeup_total;
+		sum->wakeup_count += data[i].wakeup_count;
+		sum->runq_total += data[i].runq_total;
+		sum->runq_count += data[i].runq_count;
+		if (sum->wakeup_max < data[i].wakeup_max)
+			sum->wakeup_max = data[i].wakeup_max;
+		if (sum->runq_max < data[i].runq_max)
+			sum->runq_max = data[i].runq_max;
+		if (!sum->comm[0])
+			memcpy(sum->comm, data[i].comm, sizeof(sum->comm));
+	}
+}
+
+int sched_latency_read(struct sched_latency *lat)
+{
+	struct rb_root cgroups = RB_ROOT;
+	int fd, nr = 0, max = lat->map_nr_entries;
+	int nr_cpus = libbpf_num_possible_cpus();
+	struct sched_lat_data *data;
+	u64 *prev_key, key;
+	int i;
+
+	lat->lost = skel->bss->lost;
+	for (i = 0; i < SCHED_HIST_SLOTS; i++) {
+		lat->wakeup_hist[i] = skel->bss->wakeup_hist[i];
+		lat->runq_hist[i] = skel->bss->runq_hist[i];
+	}
+
+	if (lat->aggr_mode == SCHED_AGGR_NONE)
+		return 0;
+
+	if (nr_cpus < 0)
+		return nr_cpus;
+
+	/* one value per possible cpu, they are a multiple of 8 bytes */
+	data = calloc(nr_cpus, sizeof(*data));
+	if (data == NULL)
+		return -ENOMEM;
+
+	lat->entries = calloc(max, sizeof(*lat->entries));
+	if (lat->entries == NULL) {
+		free(data);
+		return -ENOMEM;
+	}
+
+	if (lat->aggr_mode == SCHED_AGGR_CGROUP && read_all_cgroups(&cgroups) < 0)
+		pr_debug("Failed to read the cgroup names\n");
+
+	fd = bpf_map__fd(skel->maps.sched_stat);
+	prev_key = NULL;
+	while (nr < max && !bpf_map_get_next_key(fd, prev_key, &key)) {
+		struct sched_latency_entry *entry = &lat->entries[nr];
+
+		prev_key = &key;
+		if (bpf_map_lookup_elem(fd, &key, data) < 0)
+			continue;
+
+		entry->key = key;
+		merge_sched_lat_data(&entry->data, data, nr_cpus);
+		if (lat->aggr_mode == SCHED_AGGR_CGROUP) {
+			struct cgroup *cgrp = __cgroup__find(&cgroups, key);
+
+			if (cgrp)
+				entry->name = strdup(cgrp->name);
+		} else {
+			entry->data.comm[sizeof(entry->data.comm) - 1] = '\0';
+			if (asprintf(&entry->name, "%s:%" PRIu64, entry->data.comm, key) < 0)
+				entry->name = NULL;
+		}
+		nr++;
+	}
+	lat->nr_entries = nr;
+
+	cgroups__purge(&cgroups);
+	free(data);
+	return 0;
+}
+
+int sched_latency_finish(struct sched_latency *lat)
+{
+	int i;
+
+	for (i = 0; i < lat->nr_entries; i++)
+		zfree(&lat->entries[i].name);
+	zfree(&lat->entries);
+	lat->nr_entries = 0;
+
+	if (skel) {
+		skel->bss->enabled = 0;
+		sched_latency_bpf__destroy(skel);
+		skel = NULL;
+	}
+	return 0;
+}
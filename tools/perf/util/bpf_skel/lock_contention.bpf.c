@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause)
+#include "vmlinux.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+#include "lock_data.h"
+#include "log2_hist.h"
+
+/* default buffer size */
+#define MAX_ENTRIES  10240
+
+struct tstamp_data {
+	__u64 timestamp;
+	__u64 lock;
+	__u32 flags;
+	__s32 stack_id;
+};
+
+/* callstack storage  */
+struct {
+	__uint(type, BPF_MAP_TYPE_STACK_TRACE);
+	__uint(key_size, sizeof(__u32));
+	__uint(value_size, LOCK_MAX_STACKS * sizeof(__u64));
+	__uint(max_entries, MAX_ENTRIES);
+} stacks SEC(".maps");
+
+/* maintain timestamp at the beginning of contention */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, __u32);
+	__type(value, struct tstamp_data);
+	__uint(max_entries, MAX_ENTRIES);
+} tstamp SEC(".maps");
+
+/*
+ * actual lock contention statistics, per cpu so that the maximum needs no
+ * atomic update, the user space merges them
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_PERCPU_HASH);
+	__type(key, __u64);
+	__type(value, struct contention_data);
+	__uint(max_entries, MAX_ENTRIES);
+	/* the memory of all the cpus is only taken for the keys used */
+	__uint(map_flags, BPF_F_NO_PREALLOC);
+} lock_stat SEC(".maps");
+
+/* comm of the waiters, only used with LOCK_AGGR_TASK */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, __u32);
+	__type(value, struct contention_task_data);
+	__uint(max_entries, 1);
+} task_data SEC(".maps");
+
+/* set from the user space before loading */
+const volatile int aggr_mode;
+const volatile int stack_skip;
+
+int enabled;
+int lost;
+
+/* distribution of all the wait times, whatever the aggregation */
+__u64 wait_hist[LOCK_HIST_SLOTS];
+
+static inline __u64 aggr_key(struct tstamp_data *pelem, __u32 pid)
+{
+	switch (aggr_mode) {
+	case LOCK_AGGR_TASK:
+		return pid;
+	case LOCK_AGGR_CGROUP:
+		return bpf_get_current_cgroup_id();
+	case LOCK_AGGR_CALLER:
+	default:
+		return pelem->stack_id;
+	}
+}
+
+static inline void update_task_data(__u32 pid)
+{
+	struct contention_task_data data;
+
+	if (bpf_map_lookup_elem(&task_data, &pid))
+		return;
+
+	bpf_get_current_comm(data.comm, sizeof(data.comm));
+	bpf_map_update_elem(&task_data, &pid, &data, BPF_NOEXIST);
+}
+
+SEC("tp_btf/contention_begin")
+int contention_begin(u64 *ctx)
+{
+	struct tstamp_data *pelem, elem;
+	__u32 pid;
+
+	if (!enabled)
+		return 0;
+
+	pid = bpf_get_current_pid_tgid();
+	pelem = bpf_map_lookup_elem(&tstamp, &pid);
+	/*
+	 * Don't count nested contentions, like the wait_lock spinlock taken
+	 * in the mutex slowpath, nor the mutex going from spinning to
+	 * sleeping: the outermost begin/end pair covers the whole wait.
+	 */
+	if (pelem && pelem->lock)
+		return 0;
+
+	elem.timestamp = bpf_ktime_get_ns();
+	elem.lock = (__u64)ctx[0];
+	elem.flags = (__u32)ctx[1];
+	elem.stack_id = -1;
+
+	if (aggr_mode == LOCK_AGGR_CALLER) {
+		elem.stack_id = bpf_get_stackid(ctx, &stacks,
+						BPF_F_FAST_STACK_CMP | stack_skip);
+		if (elem.stack_id < 0) {
+			__sync_fetch_and_add(&lost, 1);
+			return 0;
+		}
+	}
+
+	if (bpf_map_update_elem(&tstamp, &pid, &elem, BPF_ANY))
+		__sync_fetch_and_add(&lost, 1);
+	return 0;
+}
+
+SEC("tp_btf/contention_end")
+int contention_end(u64 *ctx)
+{
+	struct tstamp_data *pelem;
+	struct contention_data *data;
+	__u64 duration, key;
+	__u32 pid, slot;
+
+	if (!enabled)
+		return 0;
+
+	pid = bpf_get_current_pid_tgid();
+	pelem = bpf_map_lookup_elem(&tstamp, &pid);
+	if (!pelem || pelem->lock != ctx[0])
+		return 0;
+
+	duration = bpf_ktime_get_ns() - pelem->timestamp;
+	key = aggr_key(pelem, pid);
+
+	if (aggr_mode == LOCK_AGGR_TASK)
+		update_task_data(pid);
+
+	data = bpf_map_lookup_elem(&lock_stat, &key);
+	if (!data) {
+		struct contention_data first = {
+			.total_time = duration,
+			.max_time = duration,
+			.count = 1,
+			.flags = pelem->flags,
+		};
+
+		/* lost the race with another cpu, update our copy of its entry */
+		if (bpf_map_update_elem(&lock_stat, &key, &first, BPF_NOEXIST))
+			data = bpf_map_lookup_elem(&lock_stat, &key);
+	}
+
+	/* the copy of this cpu, nothing else updates it meanwhile */
+	if (data) {
+		data->total_time += duration;
+		data->count++;
+		data->flags |= pelem->flags;
+		if (data->max_time < duration)
+			data->max_time = duration;
+	}
+
+	slot = log2_hist_slot(duration, LOCK_HIST_SLOTS);
+	__sync_fetch_and_add(&wait_hist[slot], 1);
+
+	bpf_map_delete_elem(&tstamp, &pid);
+	return 0;
+}
+
+char LICENSE[] SEC("license") = "Dual BSD/GPL";
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause) */
+/* Data structures shared between BPF and tools. */
+#ifndef UTIL_BPF_SKEL_LOCK_DATA_H
+#define UTIL_BPF_SKEL_LOCK_DATA_H
+
+/* kernel stack depth saved per contention, used to find the caller */
+#define LOCK_MAX_STACKS		8
+
+/* log2 buckets of the wait time in usec: [0,1), [1,2), [2,4), ... */
+#define LOCK_HIST_SLOTS		32
+
+/* flags of the lock:contention_begin tracepoint */
+#define LCB_F_SPIN		(1U << 0)
+#define LCB_F_READ		(1U << 1)
+#define LCB_F_WRITE		(1U << 2)
+#define LCB_F_MUTEX		(1U << 3)
+
+enum lock_aggr_mode {
+	LOCK_AGGR_CALLER = 0,	/* key is the stack id of the contention */
+	LOCK_AGGR_TASK,		/* key is the tid of the waiter */
+	LOCK_AGGR_CGROUP,	/* key is the cgroup id of the waiter */
+};
+
+struct contention_data {
+	__u64 total_time;
+	__u64 max_time;
+	__u32 count;
+	__u32 flags;
+};
+
+struct contention_task_data {
+	char comm[16];
+};
+
+#endif /* UTIL_BPF_SKEL_LOCK_DATA_H */
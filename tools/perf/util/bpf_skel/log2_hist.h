@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause) */
+/* log2 histogram helpers for the BPF programs, no loops for the verifier */
+#ifndef UTIL_BPF_SKEL_LOG2_HIST_H
+#define UTIL_BPF_SKEL_LOG2_HIST_H
+
+static __always_inline __u32 log2_u32(__u32 v)
+{
+	__u32 shift, r;
+
+	r = (v > 0xFFFF) << 4; v >>= r;
+	shift = (v > 0xFF) << 3; v >>= shift; r |= shift;
+	shift = (v > 0xF) << 2; v >>= shift; r |= shift;
+	shift = (v > 0x3) << 1; v >>= shift; r |= shift;
+	r |= (v >> 1);
+	return r;
+}
+
+static __always_inline __u32 log2_u64(__u64 v)
+{
+	__u32 hi = v >> 32;
+
+	if (hi)
+		return log2_u32(hi) + 32;
+	return log2_u32(v);
+}
+
+/*
+ * Slot 0 holds [0, 1) usec and slot n holds [2^(n-1), 2^n) usec, the
+ * last slot also takes everything beyond it.
+ */
+static __always_inline __u32 log2_hist_slot(__u64 delta_ns, __u32 nr_slots)
+{
+	__u64 usec = delta_ns / 1000;
+	__u32 slot;
+
+	slot = usec ? log2_u64(usec) + 1 : 0;
+	if (slot >= nr_slots)
+		slot = nr_slots - 1;
+	return slot;
+}
+
+#endif /* UTIL_BPF_SKEL_LOG2_HIST_H */
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause)
+#include "vmlinux.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+#include <bpf/bpf_core_read.h>
+
+#include "off_cpu_data.h"
+
+/* default buffer size */
+#define MAX_ENTRIES  10240
+
+/* task->state was renamed to __state in v5.14, handle both */
+struct task_struct___new {
+	long __state;
+} __attribute__((preserve_access_index));
+
+struct task_struct___old {
+	long state;
+} __attribute__((preserve_access_index));
+
+/* where and since when the task is blocked */
+struct tstamp_data {
+	__u64 timestamp;
+	__s32 kernel_stack_id;
+	__s32 user_stack_id;
+	__u32 state;
+};
+
+/* callstack storage, both the kernel and the user stacks */
+struct {
+	__uint(type, BPF_MAP_TYPE_STACK_TRACE);
+	__uint(key_size, sizeof(__u32));
+	__uint(value_size, OFF_CPU_MAX_STACKS * sizeof(__u64));
+	__uint(max_entries, MAX_ENTRIES);
+} stacks SEC(".maps");
+
+/* the tasks which went to sleep and were not woken up yet */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, __u32);
+	__type(value, struct tstamp_data);
+	__uint(max_entries, MAX_ENTRIES);
+} tstamp SEC(".maps");
+
+/* total off-cpu time per task, stacks, state and cgroup */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, struct off_cpu_key);
+	__type(value, __u64);
+	__uint(max_entries, MAX_ENTRIES);
+} off_cpu SEC(".maps");
+
+/* processes or threads to profile, only used when has_task is set */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, __u32);
+	__type(value, __u8);
+	__uint(max_entries, 1);
+} task_filter SEC(".maps");
+
+/* set from the user space before loading */
+const volatile int stack_skip;
+
+int enabled;
+int has_task;
+int lost;
+
+static inline int get_task_state(struct task_struct *t)
+{
+	/* recast pointer to capture new type for compiler */
+	struct task_struct___new *t_new = (void *)t;
+
+	if (bpf_core_field_exists(t_new->__state)) {
+		return BPF_CORE_READ(t_new, __state);
+	} else {
+		/* recast pointer to capture old type for compiler */
+		struct task_struct___old *t_old = (void *)t;
+
+		return BPF_CORE_READ(t_old, state);
+	}
+}
+
+static inline __u64 get_cgroup_id(struct task_struct *t)
+{
+	return BPF_CORE_READ(t, cgroups, dfl_cgrp, kn, id);
+}
+
+static inline int can_record(struct task_struct *t, int state)
+{
+	/* stopped, traced or exiting tasks don't wait for a wakeup */
+	if (!(state & (OFF_CPU_TASK_INTERRUPTIBLE | OFF_CPU_TASK_UNINTERRUPTIBLE)))
+		return 0;
+
+	if (has_task) {
+		__u32 tgid = t->tgid;
+		__u32 pid = t->pid;
+
+		if (!bpf_map_lookup_elem(&task_filter, &tgid) &&
+		    !bpf_map_lookup_elem(&task_filter, &pid))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * The previous task is still current here, so the stacks taken are the
+ * ones where it blocks.  The time is only accounted at the wakeup, the
+ * runqueue delay after it is what 'perf sched latency' reports.
+ */
+SEC("tp_btf/sched_switch")
+int BPF_PROG(on_switch, bool preempt, struct task_struct *prev,
+	     struct task_struct *next)
+{
+	struct tstamp_data elem;
+	__u32 pid;
+	int state;
+
+	if (!enabled)
+		return 0;
+
+	state = get_task_state(prev);
+	pid = prev->pid;
+	if (!pid || !can_record(prev, state))
+		return 0;
+
+	elem.timestamp = bpf_ktime_get_ns();
+	elem.state = state;
+	elem.kernel_stack_id = bpf_get_stackid(ctx, &stacks,
+					       BPF_F_FAST_STACK_CMP | stack_skip);
+	/* kernel threads have no user stack */
+	elem.user_stack_id = -1;
+	if (prev->mm)
+		elem.user_stack_id = bpf_get_stackid(ctx, &stacks,
+						     BPF_F_FAST_STACK_CMP |
+						     BPF_F_USER_STACK);
+
+	if (elem.kernel_stack_id < 0 ||
+	    bpf_map_update_elem(&tstamp, &pid, &elem, BPF_ANY))
+		__sync_fetch_and_add(&lost, 1);
+	return 0;
+}
+
+SEC("tp_btf/sched_wakeup")
+int BPF_PROG(on_wakeup, struct task_struct *p)
+{
+	struct tstamp_data *pelem;
+	struct off_cpu_key key;
+	__u64 delta, *total;
+	__u32 pid;
+
+	if (!enabled)
+		return 0;
+
+	pid = p->pid;
+	pelem = bpf_map_lookup_elem(&tstamp, &pid);
+	if (!pelem)
+		return 0;
+
+	delta = bpf_ktime_get_ns() - pelem->timestamp;
+
+	key.pid = pid;
+	key.tgid = p->tgid;
+	key.kernel_stack_id = pelem->kernel_stack_id;
+	key.user_stack_id = pelem->user_stack_id;
+	key.state = pelem->state;
+	key.pad = 0;
+	key.cgroup_id = get_cgroup_id(p);
+
+	total = bpf_map_lookup_elem(&off_cpu, &key);
+	if (total)
+		__sync_fetch_and_add(total, delta);
+	else if (bpf_map_update_elem(&off_cpu, &key, &delta, BPF_NOEXIST)) {
+		/* lost the race with another waker, update its entry */
+		total = bpf_map_lookup_elem(&off_cpu, &key);
+		if (total)
+			__sync_fetch_and_add(total, delta);
+		else
+			__sync_fetch_and_add(&lost, 1);
+	}
+
+	bpf_map_delete_elem(&tstamp, &pid);
+	return 0;
+}
+
+char LICENSE[] SEC("license") = "Dual BSD/GPL";
@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause) */
+/* Data structures shared between BPF and tools. */
+#ifndef UTIL_BPF_SKEL_OFF_CPU_DATA_H
+#define UTIL_BPF_SKEL_OFF_CPU_DATA_H
+
+/* depth of the kernel and of the user stack saved when blocking */
+#define OFF_CPU_MAX_STACKS	64
+
+/* task states which are accounted, the rest is not woken up normally */
+#define OFF_CPU_TASK_INTERRUPTIBLE	0x0001
+#define OFF_CPU_TASK_UNINTERRUPTIBLE	0x0002
+
+/* the wait time is accumulated per key, the value is the total in nsec */
+struct off_cpu_key {
+	__u32 pid;
+	__u32 tgid;
+	__s32 kernel_stack_id;
+	__s32 user_stack_id;
+	__u32 state;
+	__u32 pad;
+	__u64 cgroup_id;
+};
+
+#endif /* UTIL_BPF_SKEL_OFF_CPU_DATA_H */
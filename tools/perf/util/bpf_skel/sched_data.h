@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause) */
+/* Data structures shared between BPF and tools. */
+#ifndef UTIL_BPF_SKEL_SCHED_DATA_H
+#define UTIL_BPF_SKEL_SCHED_DATA_H
+
+/* log2 buckets of the delay in usec: [0,1), [1,2), [2,4), ... */
+#define SCHED_HIST_SLOTS	32
+
+enum sched_aggr_mode {
+	SCHED_AGGR_NONE = 0,	/* only the global histograms */
+	SCHED_AGGR_TASK,	/* key is the tid of the delayed task */
+	SCHED_AGGR_CGROUP,	/* key is the cgroup id of the delayed task */
+};
+
+/*
+ * wakeup: from sched_wakeup{,_new} to the task running on a CPU.
+ * runq:   from entering the runqueue, woken up or preempted, to running.
+ */
+struct sched_lat_data {
+	__u64 wakeup_total;
+	__u64 wakeup_max;
+	__u64 runq_total;
+	__u64 runq_max;
+	__u32 wakeup_count;
+	__u32 runq_count;
+	char comm[16];
+};
+
+#endif /* UTIL_BPF_SKEL_SCHED_DATA_H */
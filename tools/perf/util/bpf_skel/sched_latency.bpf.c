@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause)
+#include "vmlinux.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+#include <bpf/bpf_core_read.h>
+
+#include "sched_data.h"
+#include "log2_hist.h"
+
+/* default buffer size */
+#define MAX_ENTRIES  10240
+
+#define TASK_RUNNING  0
+
+/* task->state was renamed to __state in v5.14, handle both */
+struct task_struct___new {
+	long __state;
+} __attribute__((preserve_access_index));
+
+struct task_struct___old {
+	long state;
+} __attribute__((preserve_access_index));
+
+struct enqueue_data {
+	__u64 timestamp;
+	__u32 wakeup;
+};
+
+/* when the tasks entered the runqueue */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, __u32);
+	__type(value, struct enqueue_data);
+	__uint(max_entries, MAX_ENTRIES);
+} enqueue SEC(".maps");
+
+/*
+ * per-task or per-cgroup statistics, unused with SCHED_AGGR_NONE; per cpu
+ * so that the maxima need no atomic update, the user space merges them
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_PERCPU_HASH);
+	__type(key, __u64);
+	__type(value, struct sched_lat_data);
+	__uint(max_entries, MAX_ENTRIES);
+	/* the memory of all the cpus is only taken for the keys used */
+	__uint(map_flags, BPF_F_NO_PREALLOC);
+} sched_stat SEC(".maps");
+
+/* set from the user space before loading */
+const volatile int aggr_mode;
+
+int enabled;
+int lost;
+
+__u64 wakeup_hist[SCHED_HIST_SLOTS];
+__u64 runq_hist[SCHED_HIST_SLOTS];
+
+static inline int get_task_state(struct task_struct *t)
+{
+	/* recast pointer to capture new type for compiler */
+	struct task_struct___new *t_new = (void *)t;
+
+	if (bpf_core_field_exists(t_new->__state)) {
+		return BPF_CORE_READ(t_new, __state);
+	} else {
+		/* recast pointer to capture old type for compiler */
+		struct task_struct___old *t_old = (void *)t;
+
+		return BPF_CORE_READ(t_old, state);
+	}
+}
+
+static inline __u64 get_cgroup_id(struct task_struct *t)
+{
+	return BPF_CORE_READ(t, cgroups, dfl_cgrp, kn, id);
+}
+
+static inline void enqueue_task(struct task_struct *p, __u32 wakeup)
+{
+	struct enqueue_data data;
+	__u32 pid = p->pid;
+
+	/* the idle tasks are never queued */
+	if (!pid)
+		return;
+
+	data.timestamp = bpf_ktime_get_ns();
+	data.wakeup = wakeup;
+
+	if (bpf_map_update_elem(&enqueue, &pid, &data, BPF_ANY))
+		__sync_fetch_and_add(&lost, 1);
+}
+
+static inline void update_stat(struct task_struct *p, __u64 delta, __u32 wakeup)
+{
+	struct sched_lat_data *data;
+	__u64 key;
+
+	if (aggr_mode == SCHED_AGGR_TASK)
+		key = p->pid;
+	else
+		key = get_cgroup_id(p);
+
+	data = bpf_map_lookup_elem(&sched_stat, &key);
+	if (!data) {
+		struct sched_lat_data first = {};
+
+		if (aggr_mode == SCHED_AGGR_TASK)
+			bpf_probe_read_kernel_str(first.comm, sizeof(first.comm), p->comm);
+
+		bpf_map_update_elem(&sched_stat, &key, &first, BPF_NOEXIST);
+		data = bpf_map_lookup_elem(&sched_stat, &key);
+		if (!data) {
+			__sync_fetch_and_add(&lost, 1);
+			return;
+		}
+	}
+
+	/* the copy of this cpu, nothing else updates it meanwhile */
+	data->runq_total += delta;
+	data->runq_count++;
+	if (data->runq_max < delta)
+		data->runq_max = delta;
+
+	if (!wakeup)
+		return;
+
+	data->wakeup_total += delta;
+	data->wakeup_count++;
+	if (data->wakeup_max < delta)
+		data->wakeup_max = delta;
+}
+
+SEC("tp_btf/sched_wakeup")
+int BPF_PROG(on_wakeup, struct task_struct *p)
+{
+	if (enabled)
+		enqueue_task(p, 1);
+	return 0;
+}
+
+SEC("tp_btf/sched_wakeup_new")
+int BPF_PROG(on_wakeup_new, struct task_struct *p)
+{
+	if (enabled)
+		enqueue_task(p, 1);
+	return 0;
+}
+
+SEC("tp_btf/sched_switch")
+int BPF_PROG(on_switch, bool preempt, struct task_struct *prev,
+	     struct task_struct *next)
+{
+	struct enqueue_data *data;
+	__u64 delta;
+	__u32 pid, slot;
+
+	if (!enabled)
+		return 0;
+
+	/* still runnable: preempted, it goes back to the runqueue */
+	if (get_task_state(prev) == TASK_RUNNING)
+		enqueue_task(prev, 0);
+
+	pid = next->pid;
+	data = bpf_map_lookup_elem(&enqueue, &pid);
+	if (!data)
+		return 0;
+
+	delta = bpf_ktime_get_ns() - data->timestamp;
+
+	slot = log2_hist_slot(delta, SCHED_HIST_SLOTS);
+	__sync_fetch_and_add(&runq_hist[slot], 1);
+	if (data->wakeup)
+		__sync_fetch_and_add(&wakeup_hist[slot], 1);
+
+	if (aggr_mode != SCHED_AGGR_NONE)
+		update_stat(next, delta, data->wakeup);
+
+	bpf_map_delete_elem(&enqueue, &pid);
+	return 0;
+}
+
+char LICENSE[] SEC("license") = "Dual BSD/GPL";
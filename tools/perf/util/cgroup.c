@@ -48,28 +48,34 @@ static int open_cgroup(const char *name)
 }
 
 #ifdef HAVE_FILE_HANDLE
-int read_cgroup_id(struct cgroup *cgrp)
+static int __read_cgroup_id(const char *path, u64 *id)
 {
-	char path[PATH_MAX + 1];
-	char mnt[PATH_MAX + 1];
 	struct {
 		struct file_handle fh;
 		uint64_t cgroup_id;
 	} handle;
 	int mount_id;
 
-	if (cgroupfs_find_mountpoint(mnt, PATH_MAX + 1, "perf_event"))
-		return -1;
-
-	scnprintf(path, PATH_MAX, "%s/%s", mnt, cgrp->name);
-
 	handle.fh.handle_bytes = sizeof(handle.cgroup_id);
 	if (name_to_handle_at(AT_FDCWD, path, &handle.fh, &mount_id, 0) < 0)
 		return -1;
 
-	cgrp->id = handle.cgroup_id;
+	*id = handle.cgroup_id;
 	return 0;
 }
+
+int read_cgroup_id(struct cgroup *cgrp)
+{
+	char path[PATH_MAX + 1];
+	char mnt[PATH_MAX + 1];
+
+	if (cgroupfs_find_mountpoint(mnt, PATH_MAX + 1, "perf_event"))
+		return -1;
+
+	scnprintf(path, PATH_MAX, "%s/%s", mnt, cgrp->name);
+
+	return __read_cgroup_id(path, &cgrp->id);
+}
 #endif  /* HAVE_FILE_HANDLE */
 
 #ifndef CGROUP2_SUPER_MAGIC
@@ -573,18 +579,68 @@ struct cgroup *cgroup__find(struct perf_env *env, uint64_t id)
 	return cgrp;
 }
 
-void perf_env__purge_cgroups(struct perf_env *env)
+struct cgroup *__cgroup__find(struct rb_root *root, uint64_t id)
+{
+	return __cgroup__findnew(root, id, false, NULL);
+}
+
+void cgroups__purge(struct rb_root *root)
 {
 	struct rb_node *node;
 	struct cgroup *cgrp;
 
-	down_write(&env->cgroups.lock);
-	while (!RB_EMPTY_ROOT(&env->cgroups.tree)) {
-		node = rb_first(&env->cgroups.tree);
+	while (!RB_EMPTY_ROOT(root)) {
+		node = rb_first(root);
 		cgrp = rb_entry(node, struct cgroup, node);
 
-		rb_erase(node, &env->cgroups.tree);
+		rb_erase(node, root);
 		cgroup__put(cgrp);
 	}
+}
+
+void perf_env__purge_cgroups(struct perf_env *env)
+{
+	down_write(&env->cgroups.lock);
+	cgroups__purge(&env->cgroups.tree);
 	up_write(&env->cgroups.lock);
 }
+
+#ifdef HAVE_FILE_HANDLE
+/*
+ * Build an id -> path tree of all the cgroups, to name the cgroup ids
+ * collected in the kernel, e.g. by BPF programs.
+ */
+int read_all_cgroups(struct rb_root *root)
+{
+	char mnt[PATH_MAX];
+	struct cgroup_name *cn;
+	int prefix_len;
+
+	if (cgroupfs_find_mountpoint(mnt, sizeof(mnt), "perf_event"))
+		return -1;
+
+	/* cgroup_name will have a full path, skip the root directory */
+	prefix_len = strlen(mnt);
+
+	/* collect all cgroups in the cgroup_list */
+	if (nftw(mnt, add_cgroup_name, 20, 0) < 0)
+		return -1;
+
+	list_for_each_entry(cn, &cgroup_list, list) {
+		const char *name;
+		u64 cgrp_id;
+
+		name = cn->name + prefix_len;
+		if (name[0] == '\0')
+			name = "/";
+
+		if (__read_cgroup_id(cn->name, &cgrp_id) < 0)
+			continue;
+
+		__cgroup__findnew(root, cgrp_id, true, name);
+	}
+
+	release_cgroup_list();
+	return 0;
+}
+#endif  /* HAVE_FILE_HANDLE */
@@ -40,13 +40,22 @@ struct cgroup *cgroup__find(struct perf_env *env, uint64_t id);
 
 void perf_env__purge_cgroups(struct perf_env *env);
 
+struct cgroup *__cgroup__find(struct rb_root *root, uint64_t id);
+void cgroups__purge(struct rb_root *root);
+
 #ifdef HAVE_FILE_HANDLE
 int read_cgroup_id(struct cgroup *cgrp);
+int read_all_cgroups(struct rb_root *root);
 #else
 static inline int read_cgroup_id(struct cgroup *cgrp __maybe_unused)
 {
 	return -1;
 }
+
+static inline int read_all_cgroups(struct rb_root *root __maybe_unused)
+{
+	return -1;
+}
 #endif  /* HAVE_FILE_HANDLE */
 
 int cgroup_is_v2(const char *subsys);
@@ -4,9 +4,13 @@
 #include "dso.h"
 #include "vdso.h"
 #include "namespaces.h"
+#include <errno.h>
 #include <libgen.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <symbol.h> // filename__read_build_id
 
 static int __dso_id__cmp(struct dso_id *a, struct dso_id *b)
@@ -94,6 +98,125 @@ bool __dsos__read_build_ids(struct list_head *head, bool with_hits)
 	return have_build_id;
 }
 
+struct dsos__load_args {
+	struct dso	**dsos;
+	int		nr;
+	int		next;
+	pthread_mutex_t	lock;
+};
+
+static void *dsos__load_worker(void *arg)
+{
+	struct dsos__load_args *args = arg;
+
+	for (;;) {
+		struct dso *dso = NULL;
+
+		pthread_mutex_lock(&args->lock);
+		if (args->next < args->nr)
+			dso = args->dsos[args->next++];
+		pthread_mutex_unlock(&args->lock);
+
+		if (!dso)
+			break;
+
+		/* user space DSOs don't need a map to be loaded */
+		dso__load(dso, NULL);
+	}
+
+	return NULL;
+}
+
+/*
+ * Which DSOs dso__load() can load without a map and concurrently with others.
+ *
+ * For a user space DSO it only touches the dso itself, under dso->lock, plus
+ * files it opens and ELF descriptors of its own, symbol_conf and the symfs
+ * and build-id cache paths, which are read only by then, and the reentrant
+ * demanglers. It doesn't look at a map or at the machine's dsos and maps.
+ *
+ * Not so for kernel and module DSOs, which need their kmaps and add maps and
+ * dsos, and for the vdso, whose symbols are relocated with its map. Entering
+ * another mount namespace fails in a process with several threads. All
+ * those are left to be loaded on demand.
+ */
+static bool dso__parallel_loadable(struct dso *dso)
+{
+	return !dso->kernel && !dso__is_vdso(dso) && !dso__loaded(dso) &&
+	       !(dso->nsinfo && dso->nsinfo->need_setns);
+}
+
+/*
+ * Load the symbols of the user space DSOs on the list using up to nr_threads
+ * threads, UINT_MAX meaning one per online CPU. The DSOs are handed out one
+ * by one as their sizes vary a lot. dso__load() serializes on dso->lock and
+ * rechecks dso__loaded(), so the later on demand loads just find them done.
+ *
+ * This preload is the only parallel part: the events are then delivered by a
+ * single thread as before, and the symbol lookups for each sample go through
+ * the usual map and dso rbtrees, with no extra caching.
+ */
+int __dsos__load(struct list_head *head, unsigned int nr_threads)
+{
+	struct dsos__load_args args = {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+	};
+	unsigned int i, nr_started = 0;
+	pthread_t *threads = NULL;
+	struct dso *pos;
+	int nr = 0;
+
+	list_for_each_entry(pos, head, node) {
+		if (dso__parallel_loadable(pos))
+			nr++;
+	}
+
+	if (!nr)
+		return 0;
+
+	args.dsos = calloc(nr, sizeof(struct dso *));
+	if (!args.dsos)
+		return -ENOMEM;
+
+	list_for_each_entry(pos, head, node) {
+		if (dso__parallel_loadable(pos))
+			args.dsos[args.nr++] = dso__get(pos);
+	}
+
+	if (nr_threads == UINT_MAX)
+		nr_threads = sysconf(_SC_NPROCESSORS_ONLN);
+#ifdef HAVE_LIBBFD_SUPPORT
+	/* dso__load_bfd_symbols() is not known to be thread safe */
+	nr_threads = 1;
+#endif
+	if (nr_threads > (unsigned int)args.nr)
+		nr_threads = args.nr;
+
+	/* the calling thread is one of the loaders */
+	if (nr_threads > 1)
+		threads = calloc(nr_threads - 1, sizeof(pthread_t));
+
+	for (i = 0; threads && i < nr_threads - 1; i++) {
+		if (pthread_create(&threads[i], NULL, dsos__load_worker, &args))
+			break;
+		nr_started++;
+	}
+
+	dsos__load_worker(&args);
+
+	for (i = 0; i < nr_started; i++)
+		pthread_join(threads[i], NULL);
+
+	pr_debug("loaded symbols of %d DSOs using %u threads\n", args.nr, nr_started + 1);
+
+	for (i = 0; i < (unsigned int)args.nr; i++)
+		dso__put(args.dsos[i]);
+
+	free(threads);
+	free(args.dsos);
+	return 0;
+}
+
 static int __dso__cmp_long_name(const char *long_name, struct dso_id *id, struct dso *b)
 {
 	int rc = strcmp(long_name, b->long_name);
@@ -33,6 +33,8 @@ struct dso *__dsos__findnew_link_by_longname_id(struct rb_root *root, struct dso
 
 bool __dsos__read_build_ids(struct list_head *head, bool with_hits);
 
+int __dsos__load(struct list_head *head, unsigned int nr_threads);
+
 size_t __dsos__fprintf_buildid(struct list_head *head, FILE *fp,
 			       bool (skip)(struct dso *dso, int parm), int parm);
 size_t __dsos__fprintf(struct list_head *head, FILE *fp);
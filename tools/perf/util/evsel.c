@@ -45,6 +45,7 @@
 #include "stat.h"
 #include "string2.h"
 #include "memswap.h"
+#include "off_cpu.h"
 #include "util.h"
 #include "hashmap.h"
 #include "pmu-hybrid.h"
@@ -236,6 +237,12 @@ bool evsel__is_function_event(struct evsel *evsel)
 #undef FUNCTION_EVENT
 }
 
+bool evsel__is_offcpu_event(struct evsel *evsel)
+{
+	return evsel__is_bpf_output(evsel) && evsel->name &&
+	       !strcmp(evsel->name, OFFCPU_EVENT);
+}
+
 void evsel__init(struct evsel *evsel,
 		 struct perf_event_attr *attr, int idx)
 {
@@ -1322,6 +1329,16 @@ void evsel__config(struct evsel *evsel, struct record_opts *opts,
 	 */
 	if (evsel__is_dummy_event(evsel))
 		evsel__reset_sample_bit(evsel, BRANCH_STACK);
+
+	/*
+	 * The off-cpu samples are synthesized from the BPF maps at the end,
+	 * they always have the wait time as period and the blocking stacks.
+	 */
+	if (evsel__is_offcpu_event(evsel)) {
+		evsel->core.attr.sample_type &= OFFCPU_SAMPLE_TYPES;
+		evsel__set_sample_bit(evsel, PERIOD);
+		evsel__set_sample_bit(evsel, CALLCHAIN);
+	}
 }
 
 int evsel__set_filter(struct evsel *evsel, const char *filter)
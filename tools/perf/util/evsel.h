@@ -413,6 +413,8 @@ static inline bool evsel__is_bpf_output(struct evsel *evsel)
 	return evsel__match(evsel, SOFTWARE, SW_BPF_OUTPUT);
 }
 
+bool evsel__is_offcpu_event(struct evsel *evsel);
+
 static inline bool evsel__is_clock(struct evsel *evsel)
 {
 	return evsel__match(evsel, SOFTWARE, SW_CPU_CLOCK) ||
@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef PERF_LOCK_CONTENTION_H
+#define PERF_LOCK_CONTENTION_H
+
+#include <linux/compiler.h>
+#include <linux/types.h>
+#include "bpf_skel/lock_data.h"
+
+struct machine;
+
+/* one aggregated line: a caller, a task or a cgroup */
+struct lock_contention_entry {
+	u64			key;
+	u64			total_time;
+	u64			max_time;
+	u32			count;
+	u32			flags;
+	char			*name;
+};
+
+struct lock_contention {
+	struct machine		*machine;
+	enum lock_aggr_mode	aggr_mode;
+	int			map_nr_entries;
+	/* filled by lock_contention_read() */
+	struct lock_contention_entry *entries;
+	int			nr_entries;
+	u64			hist[LOCK_HIST_SLOTS];
+	int			lost;
+};
+
+#ifdef HAVE_BPF_SKEL
+
+int lock_contention_prepare(struct lock_contention *con);
+int lock_contention_start(void);
+int lock_contention_stop(void);
+int lock_contention_read(struct lock_contention *con);
+int lock_contention_finish(struct lock_contention *con);
+
+#else /* !HAVE_BPF_SKEL */
+
+static inline int lock_contention_prepare(struct lock_contention *con __maybe_unused)
+{
+	return -1;
+}
+
+static inline int lock_contention_start(void) { return 0; }
+static inline int lock_contention_stop(void) { return 0; }
+static inline int lock_contention_read(struct lock_contention *con __maybe_unused)
+{
+	return 0;
+}
+
+static inline int lock_contention_finish(struct lock_contention *con __maybe_unused)
+{
+	return 0;
+}
+
+#endif /* HAVE_BPF_SKEL */
+
+#endif /* PERF_LOCK_CONTENTION_H */
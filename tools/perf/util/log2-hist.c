@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <string.h>
+#include "log2-hist.h"
+
+#define LOG2_HIST_BAR_WIDTH	40
+
+int log2_hist__fprintf(FILE *fp, const u64 *slots, int nr_slots, const char *unit)
+{
+	char bar[LOG2_HIST_BAR_WIDTH + 1];
+	int i, last = -1, printed;
+	u64 max = 0;
+
+	for (i = 0; i < nr_slots; i++) {
+		if (slots[i] > max)
+			max = slots[i];
+		if (slots[i])
+			last = i;
+	}
+
+	printed = fprintf(fp, "%24s : %-10s %-*s\n", unit, "count",
+			  LOG2_HIST_BAR_WIDTH + 2, "distribution");
+
+	for (i = 0; i <= last; i++) {
+		unsigned long long low = i ? 1ULL << (i - 1) : 0;
+		unsigned long long high = 1ULL << i;
+		int len = slots[i] * LOG2_HIST_BAR_WIDTH / max;
+
+		memset(bar, '*', len);
+		memset(bar + len, ' ', LOG2_HIST_BAR_WIDTH - len);
+		bar[LOG2_HIST_BAR_WIDTH] = '\0';
+
+		if (i == nr_slots - 1) {
+			printed += fprintf(fp, "%10llu -> %-10s : %-10llu |%s|\n",
+					   low, "...", (unsigned long long)slots[i], bar);
+		} else {
+			printed += fprintf(fp, "%10llu -> %-10llu : %-10llu |%s|\n",
+					   low, high, (unsigned long long)slots[i], bar);
+		}
+	}
+	return printed;
+}
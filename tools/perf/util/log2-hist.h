@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef __PERF_LOG2_HIST_H
+#define __PERF_LOG2_HIST_H
+
+#include <stdio.h>
+#include <linux/types.h>
+
+/*
+ * Print a histogram of log2 buckets: slot 0 holds [0, 1) and slot n
+ * holds [2^(n-1), 2^n) in units of @unit, as the BPF programs fill them.
+ */
+int log2_hist__fprintf(FILE *fp, const u64 *slots, int nr_slots, const char *unit);
+
+#endif /* __PERF_LOG2_HIST_H */
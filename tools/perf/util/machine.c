@@ -929,6 +929,20 @@ size_t machines__fprintf_dsos(struct machines *machines, FILE *fp)
 	return ret;
 }
 
+int machines__load_dsos(struct machines *machines, unsigned int nr_threads)
+{
+	struct rb_node *nd;
+	int err = __dsos__load(&machines->host.dsos.head, nr_threads);
+
+	for (nd = rb_first_cached(&machines->guests); nd && !err; nd = rb_next(nd)) {
+		struct machine *pos = rb_entry(nd, struct machine, rb_node);
+
+		err = __dsos__load(&pos->dsos.head, nr_threads);
+	}
+
+	return err;
+}
+
 size_t machine__fprintf_dsos_buildid(struct machine *m, FILE *fp,
 				     bool (skip)(struct dso *dso, int parm), int parm)
 {
@@ -240,6 +240,7 @@ int machine__load_vmlinux_path(struct machine *machine);
 size_t machine__fprintf_dsos_buildid(struct machine *machine, FILE *fp,
 				     bool (skip)(struct dso *dso, int parm), int parm);
 size_t machines__fprintf_dsos(struct machines *machines, FILE *fp);
+int machines__load_dsos(struct machines *machines, unsigned int nr_threads);
 size_t machines__fprintf_dsos_buildid(struct machines *machines, FILE *fp,
 				     bool (skip)(struct dso *dso, int parm), int parm);
 
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef PERF_UTIL_OFF_CPU_H
+#define PERF_UTIL_OFF_CPU_H
+
+#include <linux/compiler.h>
+#include <linux/perf_event.h>
+
+struct evlist;
+struct target;
+struct perf_session;
+
+#define OFFCPU_EVENT  "offcpu-time"
+
+/* the samples synthesized by off_cpu_write() can only have these */
+#define OFFCPU_SAMPLE_TYPES  (PERF_SAMPLE_IDENTIFIER | PERF_SAMPLE_IP | \
+			      PERF_SAMPLE_TID | PERF_SAMPLE_TIME | \
+			      PERF_SAMPLE_ID | PERF_SAMPLE_CPU | \
+			      PERF_SAMPLE_PERIOD | PERF_SAMPLE_CALLCHAIN | \
+			      PERF_SAMPLE_CGROUP)
+
+#ifdef HAVE_BPF_SKEL
+
+int off_cpu_prepare(struct evlist *evlist, struct target *target);
+int off_cpu_write(struct perf_session *session);
+
+#else /* !HAVE_BPF_SKEL */
+
+static inline int off_cpu_prepare(struct evlist *evlist __maybe_unused,
+				  struct target *target __maybe_unused)
+{
+	return -1;
+}
+
+static inline int off_cpu_write(struct perf_session *session __maybe_unused)
+{
+	return -1;
+}
+
+#endif /* HAVE_BPF_SKEL */
+
+#endif /* PERF_UTIL_OFF_CPU_H */
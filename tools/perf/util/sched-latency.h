@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef PERF_SCHED_LATENCY_H
+#define PERF_SCHED_LATENCY_H
+
+#include <linux/compiler.h>
+#include <linux/types.h>
+#include "bpf_skel/sched_data.h"
+
+/* one aggregated line: a task or a cgroup */
+struct sched_latency_entry {
+	u64			key;
+	struct sched_lat_data	data;
+	char			*name;
+};
+
+struct sched_latency {
+	enum sched_aggr_mode	aggr_mode;
+	int			map_nr_entries;
+	/* filled by sched_latency_read() */
+	struct sched_latency_entry *entries;
+	int			nr_entries;
+	u64			wakeup_hist[SCHED_HIST_SLOTS];
+	u64			runq_hist[SCHED_HIST_SLOTS];
+	int			lost;
+};
+
+#ifdef HAVE_BPF_SKEL
+
+int sched_latency_prepare(struct sched_latency *lat);
+int sched_latency_start(void);
+int sched_latency_stop(void);
+int sched_latency_read(struct sched_latency *lat);
+int sched_latency_finish(struct sched_latency *lat);
+
+#else /* !HAVE_BPF_SKEL */
+
+static inline int sched_latency_prepare(struct sched_latency *lat __maybe_unused)
+{
+	return -1;
+}
+
+static inline int sched_latency_start(void) { return 0; }
+static inline int sched_latency_stop(void) { return 0; }
+static inline int sched_latency_read(struct sched_latency *lat __maybe_unused)
+{
+	return 0;
+}
+
+static inline int sched_latency_finish(struct sched_latency *lat __maybe_unused)
+{
+	return 0;
+}
+
+#endif /* HAVE_BPF_SKEL */
+
+#endif /* PERF_SCHED_LATENCY_H */
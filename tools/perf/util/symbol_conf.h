@@ -77,6 +77,7 @@ struct symbol_conf {
 	int		pad_output_len_dso;
 	int		group_sort_idx;
 	int		addr_range;
+	unsigned int	nr_load_threads;
 };
 
 extern struct symbol_conf symbol_conf;
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <test_progs.h>
+#include "kprobe_multi.skel.h"
+
+static const char *kprobe_multi_syms[] = {
+	"bpf_fentry_test1",
+	"bpf_fentry_test2",
+	"bpf_fentry_test3",
+	"bpf_fentry_test4",
+	"bpf_fentry_test5",
+	"bpf_fentry_test6",
+	"bpf_fentry_test7",
+	"bpf_fentry_test8",
+};
+
+static void kprobe_multi_test_run(struct kprobe_multi *skel)
+{
+	__u32 duration = 0, retval;
+	int err, prog_fd, i;
+
+	prog_fd = bpf_program__fd(skel->progs.trigger);
+	err = bpf_prog_test_run(prog_fd, 1, NULL, 0,
+				NULL, NULL, &retval, &duration);
+	ASSERT_OK(err, "test_run");
+	ASSERT_EQ(retval, 0, "test_run");
+
+	for (i = 1; i <= 8; i++) {
+		ASSERT_EQ(skel->bss->hits[i], 1, "hits");
+		ASSERT_EQ(skel->bss->ret_hits[i], 1, "ret_hits");
+	}
+	ASSERT_EQ(skel->bss->bad_cookie, 0, "bad_cookie");
+	ASSERT_EQ(skel->bss->bad_ip, 0, "bad_ip");
+}
+
+static void test_link_api_syms(void)
+{
+	DECLARE_LIBBPF_OPTS(bpf_link_create_opts, opts);
+	struct kprobe_multi *skel = NULL;
+	int prog_fd, link_fd = -1, ret_link_fd = -1, err, i;
+	__u64 cookies[8];
+
+	skel = kprobe_multi__open();
+	if (!ASSERT_OK_PTR(skel, "kprobe_multi__open"))
+		return;
+
+	bpf_program__set_expected_attach_type(skel->progs.test_kprobe,
+					      BPF_TRACE_KPROBE_MULTI);
+	bpf_program__set_expected_attach_type(skel->progs.test_kretprobe,
+					      BPF_TRACE_KPROBE_MULTI);
+
+	err = kprobe_multi__load(skel);
+	if (!ASSERT_OK(err, "kprobe_multi__load"))
+		goto cleanup;
+
+	for (i = 0; i < 8; i++)
+		cookies[i] = i + 1;
+
+	opts.kprobe_multi.syms = kprobe_multi_syms;
+	opts.kprobe_multi.cookies = cookies;
+	opts.kprobe_multi.cnt = ARRAY_SIZE(kprobe_multi_syms);
+
+	prog_fd = bpf_program__fd(skel->progs.test_kprobe);
+	link_fd = bpf_link_create(prog_fd, 0, BPF_TRACE_KPROBE_MULTI, &opts);
+	if (!ASSERT_GE(link_fd, 0, "bpf_link_create"))
+		goto cleanup;
+
+	opts.kprobe_multi.flags = BPF_F_KPROBE_MULTI_RETURN;
+	prog_fd = bpf_program__fd(skel->progs.test_kretprobe);
+	ret_link_fd = bpf_link_create(prog_fd, 0, BPF_TRACE_KPROBE_MULTI, &opts);
+	if (!ASSERT_GE(ret_link_fd, 0, "bpf_link_create_return"))
+		goto cleanup;
+
+	kprobe_multi_test_run(skel);
+
+cleanup:
+	if (ret_link_fd >= 0)
+		close(ret_link_fd);
+	if (link_fd >= 0)
+		close(link_fd);
+	kprobe_multi__destroy(skel);
+}
+
+static void test_link_api_bad_args(void)
+{
+	DECLARE_LIBBPF_OPTS(bpf_link_create_opts, opts);
+	static const char *dup_syms[] = {
+		"bpf_fentry_test1",
+		"bpf_fentry_test1",
+	};
+	struct kprobe_multi *skel = NULL;
+	int prog_fd, link_fd, err;
+
+	skel = kprobe_multi__open();
+	if (!ASSERT_OK_PTR(skel, "kprobe_multi__open"))
+		return;
+
+	bpf_program__set_expected_attach_type(skel->progs.test_kprobe,
+					      BPF_TRACE_KPROBE_MULTI);
+	bpf_program__set_expected_attach_type(skel->progs.test_kretprobe,
+					      BPF_TRACE_KPROBE_MULTI);
+
+	err = kprobe_multi__load(skel);
+	if (!ASSERT_OK(err, "kprobe_multi__load"))
+		goto cleanup;
+
+	prog_fd = bpf_program__fd(skel->progs.test_kprobe);
+
+	/* no functions */
+	link_fd = bpf_link_create(prog_fd, 0, BPF_TRACE_KPROBE_MULTI, &opts);
+	if (!ASSERT_LT(link_fd, 0, "bpf_link_create_empty"))
+		close(link_fd);
+
+	/* same function twice */
+	opts.kprobe_multi.syms = dup_syms;
+	opts.kprobe_multi.cnt = ARRAY_SIZE(dup_syms);
+	link_fd = bpf_link_create(prog_fd, 0, BPF_TRACE_KPROBE_MULTI, &opts);
+	if (!ASSERT_LT(link_fd, 0, "bpf_link_create_dup"))
+		close(link_fd);
+
+	/* unknown flags */
+	opts.kprobe_multi.syms = kprobe_multi_syms;
+	opts.kprobe_multi.cnt = ARRAY_SIZE(kprobe_multi_syms);
+	opts.kprobe_multi.flags = BPF_F_KPROBE_MULTI_RETURN << 1;
+	link_fd = bpf_link_create(prog_fd, 0, BPF_TRACE_KPROBE_MULTI, &opts);
+	if (!ASSERT_LT(link_fd, 0, "bpf_link_create_flags"))
+		close(link_fd);
+
+cleanup:
+	kprobe_multi__destroy(skel);
+}
+
+void test_kprobe_multi_test(void)
+{
+	if (test__start_subtest("link_api_syms"))
+		test_link_api_syms();
+	if (test__start_subtest("link_api_bad_args"))
+		test_link_api_bad_args();
+}
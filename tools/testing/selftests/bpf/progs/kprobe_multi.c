@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <linux/bpf.h>
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+char _license[] SEC("license") = "GPL";
+
+extern const void bpf_fentry_test1 __ksym;
+extern const void bpf_fentry_test2 __ksym;
+extern const void bpf_fentry_test3 __ksym;
+extern const void bpf_fentry_test4 __ksym;
+extern const void bpf_fentry_test5 __ksym;
+extern const void bpf_fentry_test6 __ksym;
+extern const void bpf_fentry_test7 __ksym;
+extern const void bpf_fentry_test8 __ksym;
+
+/* indexed by the cookie passed for each attached function */
+__u64 hits[9] = {};
+__u64 ret_hits[9] = {};
+__u64 bad_cookie = 0;
+__u64 bad_ip = 0;
+
+static __always_inline __u64 fentry_test_addr(__u64 cookie)
+{
+	switch (cookie) {
+	case 1: return (__u64)&bpf_fentry_test1;
+	case 2: return (__u64)&bpf_fentry_test2;
+	case 3: return (__u64)&bpf_fentry_test3;
+	case 4: return (__u64)&bpf_fentry_test4;
+	case 5: return (__u64)&bpf_fentry_test5;
+	case 6: return (__u64)&bpf_fentry_test6;
+	case 7: return (__u64)&bpf_fentry_test7;
+	case 8: return (__u64)&bpf_fentry_test8;
+	}
+	return 0;
+}
+
+static __always_inline void kprobe_multi_check(void *ctx, __u64 *counts)
+{
+	__u64 cookie = bpf_get_attach_cookie(ctx);
+
+	if (cookie < 1 || cookie > 8) {
+		bad_cookie++;
+		return;
+	}
+	if (bpf_get_func_ip(ctx) != fentry_test_addr(cookie))
+		bad_ip++;
+	counts[cookie]++;
+}
+
+SEC("kprobe/bpf_fentry_test1")
+int test_kprobe(struct pt_regs *ctx)
+{
+	kprobe_multi_check(ctx, hits);
+	return 0;
+}
+
+SEC("kretprobe/bpf_fentry_test1")
+int test_kretprobe(struct pt_regs *ctx)
+{
+	kprobe_multi_check(ctx, ret_hits);
+	return 0;
+}
+
+/* bpf_prog_test_run() of this program calls bpf_fentry_test1..8 */
+SEC("fentry/bpf_modify_return_test")
+int BPF_PROG(trigger)
+{
+	return 0;
+}
@@ -42,6 +42,56 @@ static uint64_t guest_percpu_mem_size = DEFAULT_PER_VCPU_MEM_SIZE;
 static size_t demand_paging_size;
 static char *guest_data_prototype;
 
+/* KVM_MEM_EXIT_ON_MISSING mode, see handle_memory_fault() */
+static bool exit_on_missing;
+static int populate_batch = 1;
+static uint64_t nr_memory_faults;
+
+/*
+ * Install the page the vCPU faulted on, plus the ones following it up
+ * to the end of the vCPU's region, as separate ranges of one
+ * KVM_POPULATE_MEMORY.  Their contents were written through the alias
+ * beforehand, like the destination of a post-copy migration receives
+ * them before the guest gets to touch them.
+ */
+static void handle_memory_fault(struct kvm_vm *vm,
+				struct perf_test_vcpu_args *vcpu_args,
+				struct kvm_run *run)
+{
+	struct kvm_populate_range ranges[populate_batch];
+	struct kvm_populate_memory pop = {
+		.ranges = (uint64_t)ranges,
+	};
+	uint64_t end = vcpu_args->gpa +
+		       vcpu_args->pages * perf_test_args.guest_page_size;
+	uint64_t gpa = run->memory_fault.gpa & ~(demand_paging_size - 1);
+	struct timespec start;
+	struct timespec ts_diff;
+	int r;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	while (pop.nr_ranges < populate_batch && gpa < end) {
+		ranges[pop.nr_ranges].gpa = gpa;
+		ranges[pop.nr_ranges].size = demand_paging_size;
+		pop.nr_ranges++;
+		gpa += demand_paging_size;
+	}
+	TEST_ASSERT(pop.nr_ranges, "Memory fault at 0x%llx outside vCPU %d's region",
+		    run->memory_fault.gpa, vcpu_args->vcpu_id);
+
+	r = _vm_ioctl(vm, KVM_POPULATE_MEMORY, &pop);
+	TEST_ASSERT(!r, "KVM_POPULATE_MEMORY failed at 0x%llx, errno: %d",
+		    run->memory_fault.gpa, errno);
+
+	__atomic_add_fetch(&nr_memory_faults, 1, __ATOMIC_RELAXED);
+
+	ts_diff = timespec_elapsed(start);
+	PER_PAGE_DEBUG("Populated %u ranges at 0x%llx in %ld ns\n",
+		       pop.nr_ranges, run->memory_fault.gpa,
+		       timespec_to_ns(ts_diff));
+}
+
 static void *vcpu_worker(void *data)
 {
 	int ret;
@@ -57,7 +107,16 @@ static void *vcpu_worker(void *data)
 	clock_gettime(CLOCK_MONOTONIC, &start);
 
 	/* Let the guest access its memory */
-	ret = _vcpu_run(vm, vcpu_id);
+	for (;;) {
+		ret = _vcpu_run(vm, vcpu_id);
+		if (!exit_on_missing || ret != -1 || errno != EFAULT)
+			break;
+
+		TEST_ASSERT(run->exit_reason == KVM_EXIT_MEMORY_FAULT,
+			    "KVM_RUN failed with EFAULT, exit_reason=%s\n",
+			    exit_reason_str(run->exit_reason));
+		handle_memory_fault(vm, vcpu_args, run);
+	}
 	TEST_ASSERT(ret == 0, "vcpu_run failed: %d\n", ret);
 	if (get_ucall(vm, vcpu_id, NULL) != UCALL_SYNC) {
 		TEST_ASSERT(false,
@@ -310,6 +369,23 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 	perf_test_setup_vcpus(vm, nr_vcpus, guest_percpu_mem_size,
 			      p->partition_vcpu_memory_access);
 
+	if (exit_on_missing) {
+		uint64_t size = guest_percpu_mem_size * nr_vcpus;
+		char *alias = addr_gpa2alias(vm, guest_test_phys_mem);
+		uint64_t off;
+
+		TEST_ASSERT(alias, "Exit-on-missing mode needs an alias mapping");
+
+		/* All the data "arrives" first, the vCPUs then map it in */
+		for (off = 0; off < size; off += demand_paging_size)
+			memcpy(alias + off, guest_data_prototype,
+			       demand_paging_size);
+
+		vm_mem_region_set_flags(vm, PERF_TEST_MEM_SLOT_INDEX,
+					KVM_MEM_EXIT_ON_MISSING);
+		nr_memory_faults = 0;
+	}
+
 	if (p->uffd_mode) {
 		uffd_handler_threads =
 			malloc(nr_vcpus * sizeof(*uffd_handler_threads));
@@ -397,6 +473,10 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 
 	pr_info("Total guest execution time: %ld.%.9lds\n",
 		ts_diff.tv_sec, ts_diff.tv_nsec);
+	if (exit_on_missing)
+		pr_info("Handled %lu memory fault exits, %f exits/sec\n",
+			nr_memory_faults, nr_memory_faults /
+			((double)ts_diff.tv_sec + (double)ts_diff.tv_nsec / 1000000000.0));
 	pr_info("Overall demand paging rate: %f pgs/sec\n",
 		perf_test_args.vcpu_args[0].pages * nr_vcpus /
 		((double)ts_diff.tv_sec + (double)ts_diff.tv_nsec / 100000000.0));
@@ -416,13 +496,18 @@ static void help(char *name)
 {
 	puts("");
 	printf("usage: %s [-h] [-m vm_mode] [-u uffd_mode] [-d uffd_delay_usec]\n"
-	       "          [-b memory] [-s type] [-v vcpus] [-o]\n", name);
+	       "          [-e] [-p pages] [-b memory] [-s type] [-v vcpus] [-o]\n", name);
 	guest_modes_help();
 	printf(" -u: use userfaultfd to handle vCPU page faults. Mode is a\n"
 	       "     UFFD registration mode: 'MISSING' or 'MINOR'.\n");
 	printf(" -d: add a delay in usec to the User Fault\n"
 	       "     FD handler to simulate demand paging\n"
 	       "     overheads. Ignored without -u.\n");
+	printf(" -e: set KVM_MEM_EXIT_ON_MISSING on the test memslot and\n"
+	       "     map the pages in with KVM_POPULATE_MEMORY from the vCPU\n"
+	       "     threads instead of userfaultfd. Needs shared memory.\n");
+	printf(" -p: number of pages populated per memory fault exit,\n"
+	       "     starting at the faulting one. Default: 1\n");
 	printf(" -b: specify the size of the memory region which should be\n"
 	       "     demand paged by each vCPU. e.g. 10M or 3G.\n"
 	       "     Default: 1G\n");
@@ -445,7 +530,7 @@ int main(int argc, char *argv[])
 
 	guest_modes_append_default();
 
-	while ((opt = getopt(argc, argv, "hm:u:d:b:s:v:o")) != -1) {
+	while ((opt = getopt(argc, argv, "hm:u:d:ep:b:s:v:o")) != -1) {
 		switch (opt) {
 		case 'm':
 			guest_modes_cmdline(optarg);
@@ -461,6 +546,14 @@ int main(int argc, char *argv[])
 			p.uffd_delay = strtoul(optarg, NULL, 0);
 			TEST_ASSERT(p.uffd_delay >= 0, "A negative UFFD delay is not supported.");
 			break;
+		case 'e':
+			exit_on_missing = true;
+			break;
+		case 'p':
+			populate_batch = atoi(optarg);
+			TEST_ASSERT(populate_batch > 0 && populate_batch <= 1024,
+				    "Populate batch must be between 1 and 1024");
+			break;
 		case 'b':
 			guest_percpu_mem_size = parse_size(optarg);
 			break;
@@ -487,6 +580,16 @@ int main(int argc, char *argv[])
 		TEST_FAIL("userfaultfd MINOR mode requires shared memory; pick a different -s");
 	}
 
+	if (exit_on_missing) {
+		TEST_ASSERT(!p.uffd_mode, "-e and -u are mutually exclusive");
+		if (!backing_src_is_shared(p.src_type))
+			TEST_FAIL("Exit-on-missing mode requires shared memory; pick a different -s");
+		if (!kvm_check_cap(KVM_CAP_EXIT_ON_MISSING)) {
+			print_skip("KVM_CAP_EXIT_ON_MISSING not supported");
+			exit(KSFT_SKIP);
+		}
+	}
+
 	for_each_guest_mode(run_test, &p);
 
 	return 0;
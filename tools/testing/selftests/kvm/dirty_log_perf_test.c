@@ -30,6 +30,7 @@ static u64 dirty_log_manual_caps;
 static bool host_quit;
 static int iteration;
 static int vcpu_last_completed_iteration[KVM_MAX_VCPUS];
+static struct timespec vcpu_iteration_time[KVM_MAX_VCPUS];
 
 static void *vcpu_worker(void *data)
 {
@@ -59,6 +60,7 @@ static void *vcpu_worker(void *data)
 			    exit_reason_str(run->exit_reason));
 
 		pr_debug("Got sync event from vCPU %d\n", vcpu_id);
+		vcpu_iteration_time[vcpu_id] = ts_diff;
 		vcpu_last_completed_iteration[vcpu_id] = current_iteration;
 		pr_debug("vCPU %d updated last completed iteration to %d\n",
 			 vcpu_id, vcpu_last_completed_iteration[vcpu_id]);
@@ -184,6 +186,8 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 	struct timespec avg;
 	struct kvm_enable_cap cap = {};
 	struct timespec clear_dirty_log_total = (struct timespec){0};
+	struct timespec vcpu_max_total = (struct timespec){0};
+	struct timespec vcpu_max;
 
 	vm = perf_test_create_vm(mode, nr_vcpus, guest_percpu_mem_size,
 				 p->slots, p->backing_src);
@@ -251,16 +255,28 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 		iteration++;
 
 		pr_debug("Starting iteration %d\n", iteration);
+		vcpu_max = (struct timespec){0};
 		for (vcpu_id = 0; vcpu_id < nr_vcpus; vcpu_id++) {
 			while (READ_ONCE(vcpu_last_completed_iteration[vcpu_id])
 			       != iteration)
 				;
+			if (timespec_to_ns(vcpu_iteration_time[vcpu_id]) >
+			    timespec_to_ns(vcpu_max))
+				vcpu_max = vcpu_iteration_time[vcpu_id];
 		}
 
 		ts_diff = timespec_elapsed(start);
 		vcpu_dirty_total = timespec_add(vcpu_dirty_total, ts_diff);
+		vcpu_max_total = timespec_add(vcpu_max_total, vcpu_max);
 		pr_info("Iteration %d dirty memory time: %ld.%.9lds\n",
 			iteration, ts_diff.tv_sec, ts_diff.tv_nsec);
+		/*
+		 * The slowest vCPU shows how long the guest stalls on write
+		 * protection faults, i.e. on splitting huge pages if they were
+		 * not split eagerly when dirty logging was enabled.
+		 */
+		pr_info("Iteration %d slowest vCPU time: %ld.%.9lds\n",
+			iteration, vcpu_max.tv_sec, vcpu_max.tv_nsec);
 
 		clock_gettime(CLOCK_MONOTONIC, &start);
 		get_dirty_log(vm, bitmaps, p->slots);
@@ -298,6 +314,11 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 		p->iterations, get_dirty_log_total.tv_sec,
 		get_dirty_log_total.tv_nsec, avg.tv_sec, avg.tv_nsec);
 
+	avg = timespec_div(vcpu_max_total, p->iterations);
+	pr_info("Slowest vCPU over %lu iterations took %ld.%.9lds. (Avg %ld.%.9lds/iteration)\n",
+		p->iterations, vcpu_max_total.tv_sec, vcpu_max_total.tv_nsec,
+		avg.tv_sec, avg.tv_nsec);
+
 	if (dirty_log_manual_caps) {
 		avg = timespec_div(clear_dirty_log_total, p->iterations);
 		pr_info("Clear dirty log over %lu iterations took %ld.%.9lds. (Avg %ld.%.9lds/iteration)\n",
@@ -336,6 +357,10 @@ static void help(char *name)
 	printf(" -x: Split the memory region into this number of memslots.\n"
 	       "     (default: 1)\n");
 	puts("");
+	printf("On x86 the huge pages of the memory region are split when dirty\n"
+	       "logging is enabled unless kvm.eager_page_split=N, compare the\n"
+	       "slowest vCPU times of both settings with -s anonymous_hugetlb.\n");
+	puts("");
 	exit(0);
 }
 
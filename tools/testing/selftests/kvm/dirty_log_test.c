@@ -354,7 +354,18 @@ static void dirty_ring_collect_dirty_pages(struct kvm_vm *vm, int slot,
 	count = dirty_ring_collect_one(vcpu_map_dirty_ring(vm, VCPU_ID),
 				       slot, bitmap, num_pages, &fetch_index);
 
-	cleared = kvm_vm_reset_dirty_ring(vm);
+	/*
+	 * Alternate between resetting all the rings and resetting only the
+	 * ring of our vcpu, when the latter is supported.
+	 */
+	if ((iteration & 1) &&
+	    kvm_check_cap(KVM_CAP_DIRTY_LOG_RING_VCPU_RESET)) {
+		cleared = _vcpu_ioctl(vm, VCPU_ID, KVM_RESET_DIRTY_RING, NULL);
+		TEST_ASSERT((int)cleared >= 0, "KVM_RESET_DIRTY_RING failed, errno: %d",
+			    errno);
+	} else {
+		cleared = kvm_vm_reset_dirty_ring(vm);
+	}
 
 	/* Cleared pages should be the same as collected */
 	TEST_ASSERT(cleared == count, "Reset dirty pages (%u) mismatch "
@@ -75,6 +75,9 @@ static struct test_args test_args;
 static enum test_stage *current_stage;
 static bool host_quit;
 
+/* Execution time of each vCPU in the last stage */
+static struct timespec vcpu_stage_time[KVM_MAX_VCPUS];
+
 /* Whether the test stage is updated, or completed */
 static sem_t test_stage_updated;
 static sem_t test_stage_completed;
@@ -232,6 +235,7 @@ static void *vcpu_worker(void *data)
 			 "execution time is: %ld.%.9lds\n\n",
 			 vcpu_id, test_stage_string[stage],
 			 ts_diff.tv_sec, ts_diff.tv_nsec);
+		vcpu_stage_time[vcpu_id] = ts_diff;
 
 		ret = sem_post(&test_stage_completed);
 		TEST_ASSERT(ret == 0, "Error in sem_post");
@@ -398,8 +402,13 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 		ts_diff.tv_sec, ts_diff.tv_nsec);
 
 	/* Test the stage of KVM updating mappings */
+	clock_gettime(CLOCK_MONOTONIC_RAW, &start);
 	vm_mem_region_set_flags(vm, TEST_MEM_SLOT_INDEX,
 				KVM_MEM_LOG_DIRTY_PAGES);
+	ts_diff = timespec_elapsed(start);
+
+	pr_info("Enabling dirty logging time: %ld.%.9lds\n",
+		ts_diff.tv_sec, ts_diff.tv_nsec);
 
 	*current_stage = KVM_UPDATE_MAPPINGS;
 
@@ -407,7 +416,21 @@ static void run_test(enum vm_guest_mode mode, void *arg)
 	vcpus_complete_new_stage(*current_stage);
 	ts_diff = timespec_elapsed(start);
 
-	pr_info("KVM_UPDATE_MAPPINGS: total execution time: %ld.%.9lds\n\n",
+	pr_info("KVM_UPDATE_MAPPINGS: total execution time: %ld.%.9lds\n",
+		ts_diff.tv_sec, ts_diff.tv_nsec);
+
+	/*
+	 * Without eager page splitting, the vCPUs split the huge pages one
+	 * write protection fault at a time in this stage.
+	 */
+	ts_diff = (struct timespec){0};
+	for (vcpu_id = 0; vcpu_id < nr_vcpus; vcpu_id++) {
+		if (timespec_to_ns(vcpu_stage_time[vcpu_id]) >
+		    timespec_to_ns(ts_diff))
+			ts_diff = vcpu_stage_time[vcpu_id];
+	}
+
+	pr_info("KVM_UPDATE_MAPPINGS: slowest vCPU execution time: %ld.%.9lds\n\n",
 		ts_diff.tv_sec, ts_diff.tv_nsec);
 
 	/* Test the stage of KVM adjusting mappings */
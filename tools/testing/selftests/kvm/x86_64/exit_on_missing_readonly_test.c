@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * KVM_MEM_EXIT_ON_MISSING on a read-only memslot
+ *
+ * The pages of a KVM_MEM_READONLY slot are only ever mapped read-only
+ * into the guest, so looking them up must not require a writable host
+ * mapping.  The guest reads every page of the slot once: each read exits
+ * with KVM_EXIT_MEMORY_FAULT until the page is populated and then sees
+ * the data written through the alias mapping.  A write to the slot still
+ * exits to userspace as MMIO.
+ */
+#define _GNU_SOURCE /* for program_invocation_short_name */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+
+#include <linux/compiler.h>
+
+#include "test_util.h"
+#include "kvm_util.h"
+#include "processor.h"
+
+#define VCPU_ID			0
+
+#define TEST_MEM_GPA		0xc0000000
+#define TEST_MEM_SLOT		10
+#define TEST_MEM_PAGES		16
+#define TEST_PAGE_SIZE		4096
+
+static void guest_code(void)
+{
+	uint64_t sum = 0;
+	int i;
+
+	for (i = 0; i < TEST_MEM_PAGES; i++)
+		sum += READ_ONCE(*(uint64_t *)(TEST_MEM_GPA +
+					       i * TEST_PAGE_SIZE));
+	GUEST_SYNC(sum);
+
+	WRITE_ONCE(*(uint64_t *)TEST_MEM_GPA, 0);
+	GUEST_DONE();
+}
+
+static void populate_page(struct kvm_vm *vm, uint64_t gpa)
+{
+	struct kvm_populate_range range = {
+		.gpa = gpa & ~(TEST_PAGE_SIZE - 1),
+		.size = TEST_PAGE_SIZE,
+	};
+	struct kvm_populate_memory pop = {
+		.nr_ranges = 1,
+		.ranges = (uint64_t)&range,
+	};
+
+	vm_ioctl(vm, KVM_POPULATE_MEMORY, &pop);
+}
+
+int main(int argc, char *argv[])
+{
+	struct kvm_vm *vm;
+	struct kvm_run *run;
+	struct ucall uc;
+	uint64_t expected = 0, faults = 0;
+	uint64_t *alias;
+	int i, r;
+
+	if (!kvm_check_cap(KVM_CAP_EXIT_ON_MISSING) ||
+	    !kvm_check_cap(KVM_CAP_READONLY_MEM)) {
+		print_skip("KVM_CAP_EXIT_ON_MISSING or KVM_CAP_READONLY_MEM not supported");
+		exit(KSFT_SKIP);
+	}
+
+	vm = vm_create_default(VCPU_ID, 0, guest_code);
+	run = vcpu_state(vm, VCPU_ID);
+
+	vm_userspace_mem_region_add(vm, VM_MEM_SRC_SHMEM, TEST_MEM_GPA,
+				    TEST_MEM_SLOT, TEST_MEM_PAGES,
+				    KVM_MEM_READONLY | KVM_MEM_EXIT_ON_MISSING);
+	virt_map(vm, TEST_MEM_GPA, TEST_MEM_GPA, TEST_MEM_PAGES);
+
+	/* The data only goes through the alias, the slot's mapping stays empty */
+	alias = addr_gpa2alias(vm, TEST_MEM_GPA);
+	TEST_ASSERT(alias, "No alias mapping for the test memslot");
+	for (i = 0; i < TEST_MEM_PAGES; i++) {
+		alias[i * TEST_PAGE_SIZE / sizeof(*alias)] = 0x1000 + i;
+		expected += 0x1000 + i;
+	}
+
+	for (;;) {
+		r = _vcpu_run(vm, VCPU_ID);
+		if (r == -1 && errno == EFAULT) {
+			TEST_ASSERT(run->exit_reason == KVM_EXIT_MEMORY_FAULT,
+				    "KVM_RUN failed with EFAULT, exit_reason=%s",
+				    exit_reason_str(run->exit_reason));
+			TEST_ASSERT(run->memory_fault.gpa >= TEST_MEM_GPA &&
+				    run->memory_fault.gpa < TEST_MEM_GPA +
+				    TEST_MEM_PAGES * TEST_PAGE_SIZE,
+				    "Memory fault at 0x%llx outside the test memslot",
+				    run->memory_fault.gpa);
+			populate_page(vm, run->memory_fault.gpa);
+			faults++;
+			continue;
+		}
+		TEST_ASSERT(r == 0, "vcpu_run failed: %d, errno: %d", r, errno);
+		TEST_ASSERT(run->exit_reason == KVM_EXIT_IO,
+			    "Unexpected exit_reason=%s",
+			    exit_reason_str(run->exit_reason));
+		break;
+	}
+
+	TEST_ASSERT(get_ucall(vm, VCPU_ID, &uc) == UCALL_SYNC,
+		    "Expected UCALL_SYNC after the reads");
+	TEST_ASSERT(uc.args[1] == expected,
+		    "Guest read 0x%lx, expected 0x%lx", uc.args[1], expected);
+	TEST_ASSERT(faults == TEST_MEM_PAGES,
+		    "%lu memory faults, expected one per page (%d)",
+		    faults, TEST_MEM_PAGES);
+
+	/* Writes to a read-only slot are still MMIO */
+	vcpu_run(vm, VCPU_ID);
+	TEST_ASSERT(run->exit_reason == KVM_EXIT_MMIO && run->mmio.is_write &&
+		    run->mmio.phys_addr == TEST_MEM_GPA,
+		    "Expected an MMIO write exit, got exit_reason=%s",
+		    exit_reason_str(run->exit_reason));
+
+	vcpu_run(vm, VCPU_ID);
+	TEST_ASSERT(get_ucall(vm, VCPU_ID, &uc) == UCALL_DONE,
+		    "Expected UCALL_DONE, exit_reason=%s",
+		    exit_reason_str(run->exit_reason));
+
+	kvm_vm_free(vm);
+	return 0;
+}
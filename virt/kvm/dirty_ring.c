@@ -45,11 +45,51 @@ struct kvm_dirty_ring *kvm_dirty_ring_get(struct kvm *kvm)
 	return &vcpu->dirty_ring;
 }
 
-static void kvm_reset_dirty_gfn(struct kvm *kvm, u32 slot, u64 offset, u64 mask)
+/*
+ * Number of coalesced GFN runs write-protected with a single acquisition of
+ * the mmu_lock, which bounds how long the vCPUs can be kept out of it.
+ */
+#define KVM_DIRTY_RING_RESET_BATCH	16
+
+struct kvm_dirty_ring_reset_batch {
+	int nr;
+	struct {
+		struct kvm_memory_slot *memslot;
+		u64 offset;
+		u64 mask;
+	} runs[KVM_DIRTY_RING_RESET_BATCH];
+};
+
+static void kvm_reset_dirty_gfn_flush(struct kvm *kvm,
+				      struct kvm_dirty_ring_reset_batch *batch)
+{
+	int i;
+
+	if (!batch->nr)
+		return;
+
+	KVM_MMU_LOCK(kvm);
+	for (i = 0; i < batch->nr; i++)
+		kvm_arch_mmu_enable_log_dirty_pt_masked(kvm,
+							batch->runs[i].memslot,
+							batch->runs[i].offset,
+							batch->runs[i].mask);
+	KVM_MMU_UNLOCK(kvm);
+
+	batch->nr = 0;
+}
+
+static void kvm_reset_dirty_gfn(struct kvm *kvm,
+				struct kvm_dirty_ring_reset_batch *batch,
+				u32 slot, u64 offset, u64 mask)
 {
 	struct kvm_memory_slot *memslot;
 	int as_id, id;
 
+	/* Nothing was harvested yet, or the ring was empty */
+	if (!mask)
+		return;
+
 	as_id = slot >> 16;
 	id = (u16)slot;
 
@@ -58,12 +98,19 @@ static void kvm_reset_dirty_gfn(struct kvm *kvm, u32 slot, u64 offset, u64 mask)
 
 	memslot = id_to_memslot(__kvm_memslots(kvm, as_id), id);
 
-	if (!memslot || (offset + __fls(mask)) >= memslot->npages)
+	/*
+	 * Without slots_lock the slot may be going away, nothing needs to be
+	 * write-protected in that case.
+	 */
+	if (!memslot || (memslot->flags & KVM_MEMSLOT_INVALID) ||
+	    (offset + __fls(mask)) >= memslot->npages)
 		return;
 
-	KVM_MMU_LOCK(kvm);
-	kvm_arch_mmu_enable_log_dirty_pt_masked(kvm, memslot, offset, mask);
-	KVM_MMU_UNLOCK(kvm);
+	batch->runs[batch->nr].memslot = memslot;
+	batch->runs[batch->nr].offset = offset;
+	batch->runs[batch->nr].mask = mask;
+	if (++batch->nr == KVM_DIRTY_RING_RESET_BATCH)
+		kvm_reset_dirty_gfn_flush(kvm, batch);
 }
 
 int kvm_dirty_ring_alloc(struct kvm_dirty_ring *ring, int index, u32 size)
@@ -77,6 +124,7 @@ int kvm_dirty_ring_alloc(struct kvm_dirty_ring *ring, int index, u32 size)
 	ring->dirty_index = 0;
 	ring->reset_index = 0;
 	ring->index = index;
+	mutex_init(&ring->reset_lock);
 
 	return 0;
 }
@@ -98,15 +146,23 @@ static inline bool kvm_dirty_gfn_harvested(struct kvm_dirty_gfn *gfn)
 
 int kvm_dirty_ring_reset(struct kvm *kvm, struct kvm_dirty_ring *ring)
 {
+	struct kvm_vcpu *vcpu = container_of(ring, struct kvm_vcpu, dirty_ring);
+	struct kvm_dirty_ring_reset_batch batch;
 	u32 cur_slot, next_slot;
 	u64 cur_offset, next_offset;
 	unsigned long mask;
 	int count = 0;
 	struct kvm_dirty_gfn *entry;
 	bool first_round = true;
+	ktime_t start;
 
 	/* This is only needed to make compilers happy */
 	cur_slot = cur_offset = mask = 0;
+	batch.nr = 0;
+
+	/* Both the VM and the vCPU ioctls can reset this ring */
+	mutex_lock(&ring->reset_lock);
+	start = ktime_get();
 
 	while (true) {
 		entry = &ring->dirty_gfns[ring->reset_index & (ring->size - 1)];
@@ -142,22 +198,29 @@ int kvm_dirty_ring_reset(struct kvm *kvm, struct kvm_dirty_ring *ring)
 				continue;
 			}
 		}
-		kvm_reset_dirty_gfn(kvm, cur_slot, cur_offset, mask);
+		kvm_reset_dirty_gfn(kvm, &batch, cur_slot, cur_offset, mask);
 		cur_slot = next_slot;
 		cur_offset = next_offset;
 		mask = 1;
 		first_round = false;
 	}
 
-	kvm_reset_dirty_gfn(kvm, cur_slot, cur_offset, mask);
+	kvm_reset_dirty_gfn(kvm, &batch, cur_slot, cur_offset, mask);
+	kvm_reset_dirty_gfn_flush(kvm, &batch);
+
+	vcpu->stat.generic.dirty_ring_reset += count;
+	vcpu->stat.generic.dirty_ring_reset_ns +=
+		ktime_to_ns(ktime_sub(ktime_get(), start));
 
 	trace_kvm_dirty_ring_reset(ring);
+	mutex_unlock(&ring->reset_lock);
 
 	return count;
 }
 
 void kvm_dirty_ring_push(struct kvm_dirty_ring *ring, u32 slot, u64 offset)
 {
+	struct kvm_vcpu *vcpu = container_of(ring, struct kvm_vcpu, dirty_ring);
 	struct kvm_dirty_gfn *entry;
 
 	/* It should never get full */
@@ -174,6 +237,7 @@ void kvm_dirty_ring_push(struct kvm_dirty_ring *ring, u32 slot, u64 offset)
 	smp_wmb();
 	kvm_dirty_gfn_set_dirtied(entry);
 	ring->dirty_index++;
+	vcpu->stat.generic.dirty_ring_push++;
 	trace_kvm_dirty_ring_push(ring, slot, offset);
 }
 
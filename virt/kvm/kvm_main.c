@@ -93,6 +93,14 @@ unsigned int halt_poll_ns_shrink;
 module_param(halt_poll_ns_shrink, uint, 0644);
 EXPORT_SYMBOL_GPL(halt_poll_ns_shrink);
 
+/*
+ * Percentage of the recent halts that the halt polling window tries to
+ * cover.  Zero falls back to growing and shrinking halt_poll_ns.
+ */
+unsigned int halt_poll_pct = 75;
+module_param(halt_poll_pct, uint, 0644);
+EXPORT_SYMBOL_GPL(halt_poll_pct);
+
 /*
  * Ordering of locks:
  *
@@ -1140,6 +1148,7 @@ static struct kvm *kvm_create_vm(unsigned long type)
 	}
 
 	kvm->max_halt_poll_ns = halt_poll_ns;
+	kvm->halt_poll_pct = min(READ_ONCE(halt_poll_pct), 100U);
 
 	r = kvm_arch_init_vm(kvm, type);
 	if (r)
@@ -1492,6 +1501,10 @@ static int check_memory_region_flags(const struct kvm_userspace_memory_region *m
 	valid_flags |= KVM_MEM_READONLY;
 #endif
 
+#ifdef CONFIG_HAVE_KVM_EXIT_ON_MISSING
+	valid_flags |= KVM_MEM_EXIT_ON_MISSING;
+#endif
+
 	if (mem->flags & ~valid_flags)
 		return -EINVAL;
 
@@ -1728,6 +1741,28 @@ static int kvm_delete_memslot(struct kvm *kvm,
 	return kvm_set_memslot(kvm, mem, &new, as_id, KVM_MR_DELETE);
 }
 
+/*
+ * Does a VM_IO or VM_PFNMAP mapping, which GUP-fast cannot see, back part of
+ * the range?  See KVM_MEMSLOT_PFNMAP.
+ */
+static bool kvm_hva_range_has_pfnmap(unsigned long start, unsigned long size)
+{
+	struct vm_area_struct *vma;
+	unsigned long end = start + size;
+	bool ret = false;
+
+	mmap_read_lock(current->mm);
+	for (vma = find_vma(current->mm, start); vma && vma->vm_start < end;
+	     vma = vma->vm_next) {
+		if (vma->vm_flags & (VM_IO | VM_PFNMAP)) {
+			ret = true;
+			break;
+		}
+	}
+	mmap_read_unlock(current->mm);
+	return ret;
+}
+
 /*
  * Allocate some memory and give it an address in the guest physical address
  * space.
@@ -1797,6 +1832,18 @@ int __kvm_set_memory_region(struct kvm *kvm,
 	if (new.npages > KVM_MEM_MAX_NR_PAGES)
 		return -EINVAL;
 
+	/*
+	 * Only the lookups of exit-on-missing slots care about the kind of
+	 * mapping, the address can't change for an existing slot.
+	 */
+	if (new.flags & KVM_MEM_EXIT_ON_MISSING) {
+		if (old.flags & KVM_MEM_EXIT_ON_MISSING)
+			new.flags |= old.flags & KVM_MEMSLOT_PFNMAP;
+		else if (kvm_hva_range_has_pfnmap(new.userspace_addr,
+						  mem->memory_size))
+			new.flags |= KVM_MEMSLOT_PFNMAP;
+	}
+
 	if (!old.npages) {
 		change = KVM_MR_CREATE;
 		new.dirty_bitmap = NULL;
@@ -2392,7 +2439,7 @@ static int kvm_try_get_pfn(kvm_pfn_t pfn)
 static int hva_to_pfn_remapped(struct vm_area_struct *vma,
 			       unsigned long addr, bool *async,
 			       bool write_fault, bool *writable,
-			       kvm_pfn_t *p_pfn)
+			       bool nofault, kvm_pfn_t *p_pfn)
 {
 	kvm_pfn_t pfn;
 	pte_t *ptep;
@@ -2400,6 +2447,8 @@ static int hva_to_pfn_remapped(struct vm_area_struct *vma,
 	int r;
 
 	r = follow_pte(vma->vm_mm, addr, &ptep, &ptl);
+	if (r && nofault)
+		return r;
 	if (r) {
 		/*
 		 * get_user_pages fails for VM_IO and VM_PFNMAP vmas and does
@@ -2502,7 +2551,8 @@ static kvm_pfn_t hva_to_pfn(unsigned long addr, bool atomic, bool *async,
 	if (vma == NULL)
 		pfn = KVM_PFN_ERR_FAULT;
 	else if (vma->vm_flags & (VM_IO | VM_PFNMAP)) {
-		r = hva_to_pfn_remapped(vma, addr, async, write_fault, writable, &pfn);
+		r = hva_to_pfn_remapped(vma, addr, async, write_fault, writable,
+					false, &pfn);
 		if (r == -EAGAIN)
 			goto retry;
 		if (r < 0)
@@ -2549,6 +2599,82 @@ kvm_pfn_t __gfn_to_pfn_memslot(struct kvm_memory_slot *slot, gfn_t gfn,
 }
 EXPORT_SYMBOL_GPL(__gfn_to_pfn_memslot);
 
+/*
+ * Like hva_to_pfn(), but only look at what is mapped at @addr right now
+ * and never fault it in.  Unlike the atomic fast path this also finds
+ * pages that are mapped read-only.  Only with @pfnmap, for the slots
+ * known to have VM_IO/VM_PFNMAP mappings, does a miss take mmap_lock to
+ * look for those; a page that is simply missing does not.
+ */
+static kvm_pfn_t hva_to_pfn_nofault(unsigned long addr, bool write_fault,
+				    bool *writable, bool pfnmap)
+{
+	struct vm_area_struct *vma;
+	struct page *page;
+	kvm_pfn_t pfn;
+	int r;
+
+	if (hva_to_pfn_fast(addr, write_fault, writable, &pfn))
+		return pfn;
+
+	if (!write_fault && get_user_page_fast_only(addr, 0, &page)) {
+		if (writable)
+			*writable = false;
+		return page_to_pfn(page);
+	}
+
+	pfn = KVM_PFN_ERR_FAULT;
+	if (!pfnmap)
+		return pfn;
+
+	mmap_read_lock(current->mm);
+	vma = vma_lookup(current->mm, addr);
+	if (vma && (vma->vm_flags & (VM_IO | VM_PFNMAP))) {
+		r = hva_to_pfn_remapped(vma, addr, NULL, write_fault, writable,
+					true, &pfn);
+		if (r < 0)
+			pfn = KVM_PFN_ERR_FAULT;
+	}
+	mmap_read_unlock(current->mm);
+	return pfn;
+}
+
+/*
+ * Look up the pfn for @gfn without faulting in the host page, for the
+ * slots with KVM_MEM_EXIT_ON_MISSING.  KVM_PFN_ERR_FAULT means that it
+ * is not mapped yet.
+ */
+kvm_pfn_t gfn_to_pfn_memslot_nofault(struct kvm_memory_slot *slot, gfn_t gfn,
+				     bool write_fault, bool *writable,
+				     hva_t *hva)
+{
+	unsigned long addr = __gfn_to_hva_many(slot, gfn, NULL, write_fault);
+
+	if (hva)
+		*hva = addr;
+
+	if (addr == KVM_HVA_ERR_RO_BAD) {
+		if (writable)
+			*writable = false;
+		return KVM_PFN_ERR_RO_FAULT;
+	}
+
+	if (kvm_is_error_hva(addr)) {
+		if (writable)
+			*writable = false;
+		return KVM_PFN_NOSLOT;
+	}
+
+	if (writable && memslot_is_readonly(slot)) {
+		*writable = false;
+		writable = NULL;
+	}
+
+	return hva_to_pfn_nofault(addr, write_fault, writable,
+				  READ_ONCE(slot->flags) & KVM_MEMSLOT_PFNMAP);
+}
+EXPORT_SYMBOL_GPL(gfn_to_pfn_memslot_nofault);
+
 kvm_pfn_t gfn_to_pfn_prot(struct kvm *kvm, gfn_t gfn, bool write_fault,
 		      bool *writable)
 {
@@ -3270,6 +3396,63 @@ static void shrink_halt_poll_ns(struct kvm_vcpu *vcpu)
 	trace_kvm_halt_poll_ns_shrink(vcpu->vcpu_id, val, old);
 }
 
+/* Halve the histogram every that many halts */
+#define HALT_BLOCK_HIST_DECAY	64
+
+/*
+ * Account a halt in the histogram of recent block times.  The counts are
+ * halved regularly, so that the prediction below follows the guest when
+ * its wakeup pattern changes.
+ */
+static void kvm_vcpu_record_block(struct kvm_vcpu *vcpu, u64 block_ns)
+{
+	unsigned int i, count = 0;
+
+	i = min_t(unsigned int, fls64(block_ns), HALT_POLL_HIST_COUNT - 1);
+	vcpu->halt_block_hist[i]++;
+	if (++vcpu->halt_block_count < HALT_BLOCK_HIST_DECAY)
+		return;
+
+	for (i = 0; i < HALT_POLL_HIST_COUNT; i++) {
+		vcpu->halt_block_hist[i] >>= 1;
+		count += vcpu->halt_block_hist[i];
+	}
+	vcpu->halt_block_count = count;
+}
+
+/*
+ * Poll for the shortest window that would have covered halt_poll_pct
+ * percent of the recent halts, i.e. until the predicted wakeup.  If that
+ * is beyond max_halt_poll_ns, most wakeups would come after the polling
+ * ended and it would only burn host CPU, so don't poll at all.
+ */
+static void predict_halt_poll_ns(struct kvm_vcpu *vcpu)
+{
+	unsigned int old = vcpu->halt_poll_ns, val = 0;
+	u64 target, sum = 0;
+	int i;
+
+	target = (u64)vcpu->halt_block_count * vcpu->kvm->halt_poll_pct;
+	for (i = 0; i < HALT_POLL_HIST_COUNT; i++) {
+		sum += vcpu->halt_block_hist[i];
+		if (sum * 100 >= target)
+			break;
+	}
+
+	/* Bucket i holds the block times below 2^i ns, the last one is open */
+	if (vcpu->halt_block_count && i < HALT_POLL_HIST_COUNT - 1 &&
+	    (1ULL << i) <= vcpu->kvm->max_halt_poll_ns)
+		val = 1U << i;
+	else if (vcpu->kvm->max_halt_poll_ns)
+		++vcpu->stat.generic.halt_poll_skipped;
+
+	vcpu->halt_poll_ns = val;
+	if (val > old)
+		trace_kvm_halt_poll_ns_grow(vcpu->vcpu_id, val, old);
+	else if (val < old)
+		trace_kvm_halt_poll_ns_shrink(vcpu->vcpu_id, val, old);
+}
+
 static int kvm_vcpu_check_block(struct kvm_vcpu *vcpu)
 {
 	int ret = -EINTR;
@@ -3370,7 +3553,12 @@ void kvm_vcpu_block(struct kvm_vcpu *vcpu)
 		vcpu, ktime_to_ns(ktime_sub(poll_end, start)), waited);
 
 	if (halt_poll_allowed) {
-		if (!vcpu_valid_wakeup(vcpu)) {
+		if (vcpu->kvm->halt_poll_pct) {
+			/* Invalid wakeups are never worth polling for */
+			kvm_vcpu_record_block(vcpu, vcpu_valid_wakeup(vcpu) ?
+						    block_ns : U64_MAX);
+			predict_halt_poll_ns(vcpu);
+		} else if (!vcpu_valid_wakeup(vcpu)) {
 			shrink_halt_poll_ns(vcpu);
 		} else if (vcpu->kvm->max_halt_poll_ns) {
 			if (block_ns <= vcpu->halt_poll_ns)
@@ -3844,6 +4032,29 @@ static int kvm_vcpu_ioctl_get_stats_fd(struct kvm_vcpu *vcpu)
 	return fd;
 }
 
+/*
+ * Reset a single ring, so that userspace can harvest and reset the rings of
+ * different vCPUs from different threads.  Unlike KVM_RESET_DIRTY_RINGS this
+ * does not take slots_lock, the memslots are looked up under SRCU instead.
+ */
+static int kvm_vcpu_ioctl_reset_dirty_ring(struct kvm_vcpu *vcpu)
+{
+	struct kvm *kvm = vcpu->kvm;
+	int cleared, idx;
+
+	if (!kvm->dirty_ring_size)
+		return -EINVAL;
+
+	idx = srcu_read_lock(&kvm->srcu);
+	cleared = kvm_dirty_ring_reset(kvm, &vcpu->dirty_ring);
+	srcu_read_unlock(&kvm->srcu, idx);
+
+	if (cleared)
+		kvm_flush_remote_tlbs(kvm);
+
+	return cleared;
+}
+
 static long kvm_vcpu_ioctl(struct file *filp,
 			   unsigned int ioctl, unsigned long arg)
 {
@@ -3867,6 +4078,13 @@ static long kvm_vcpu_ioctl(struct file *filp,
 	if (r != -ENOIOCTLCMD)
 		return r;
 
+	/*
+	 * The ring is harvested while the vCPU runs, so the reset must not
+	 * wait for KVM_RUN to return.
+	 */
+	if (ioctl == KVM_RESET_DIRTY_RING)
+		return kvm_vcpu_ioctl_reset_dirty_ring(vcpu);
+
 	if (mutex_lock_killable(&vcpu->mutex))
 		return -EINTR;
 	switch (ioctl) {
@@ -4279,6 +4497,7 @@ static long kvm_vm_ioctl_check_extension_generic(struct kvm *kvm, long arg)
 	case KVM_CAP_CHECK_EXTENSION_VM:
 	case KVM_CAP_ENABLE_CAP_VM:
 	case KVM_CAP_HALT_POLL:
+	case KVM_CAP_HALT_POLL_PERCENTILE:
 		return 1;
 #ifdef CONFIG_KVM_MMIO
 	case KVM_CAP_COALESCED_MMIO:
@@ -4306,6 +4525,10 @@ static long kvm_vm_ioctl_check_extension_generic(struct kvm *kvm, long arg)
 #else
 		return 0;
 #endif
+	case KVM_CAP_DIRTY_LOG_RING_VCPU_RESET:
+		return KVM_DIRTY_LOG_PAGE_OFFSET > 0;
+	case KVM_CAP_EXIT_ON_MISSING:
+		return IS_ENABLED(CONFIG_HAVE_KVM_EXIT_ON_MISSING);
 	case KVM_CAP_BINARY_STATS_FD:
 		return 1;
 	default:
@@ -4398,10 +4621,17 @@ static int kvm_vm_ioctl_enable_cap_generic(struct kvm *kvm,
 	}
 #endif
 	case KVM_CAP_HALT_POLL: {
-		if (cap->flags || cap->args[0] != (unsigned int)cap->args[0])
+		if ((cap->flags & ~KVM_HALT_POLL_PERCENTILE) ||
+		    cap->args[0] != (unsigned int)cap->args[0])
+			return -EINVAL;
+
+		/* args[1] is the percentile of halts to poll for, 0 to grow/shrink */
+		if ((cap->flags & KVM_HALT_POLL_PERCENTILE) && cap->args[1] > 100)
 			return -EINVAL;
 
 		kvm->max_halt_poll_ns = cap->args[0];
+		if (cap->flags & KVM_HALT_POLL_PERCENTILE)
+			kvm->halt_poll_pct = cap->args[1];
 		return 0;
 	}
 	case KVM_CAP_DIRTY_LOG_RING:
@@ -4459,6 +4689,106 @@ static int kvm_vm_ioctl_get_stats_fd(struct kvm *kvm)
 	return fd;
 }
 
+#ifdef CONFIG_HAVE_KVM_EXIT_ON_MISSING
+#define KVM_POPULATE_MAX_RANGES	1024
+
+static int kvm_populate_range(struct kvm *kvm, struct kvm_populate_range *range)
+{
+	struct kvm_memory_slot *slot;
+	struct vm_area_struct *vma;
+	unsigned int gup_flags;
+	unsigned long hva;
+	gfn_t gfn, npages;
+	long ret;
+
+	if (!PAGE_ALIGNED(range->gpa) || !PAGE_ALIGNED(range->size) ||
+	    !range->size || range->gpa + range->size < range->gpa)
+		return -EINVAL;
+
+	gfn = gpa_to_gfn(range->gpa);
+	npages = range->size >> PAGE_SHIFT;
+
+	/* a range may not straddle memslots */
+	slot = gfn_to_memslot(kvm, gfn);
+	if (!kvm_is_visible_memslot(slot) ||
+	    gfn + npages > slot->base_gfn + slot->npages)
+		return -EINVAL;
+
+	hva = __gfn_to_hva_memslot(slot, gfn);
+	gup_flags = (slot->flags & KVM_MEM_READONLY) ? 0 : FOLL_WRITE;
+
+	while (npages) {
+		if (fatal_signal_pending(current))
+			return -EINTR;
+
+		vma = vma_lookup(current->mm, hva);
+		if (!vma)
+			return -EFAULT;
+
+		/*
+		 * get_user_pages() refuses these, fault them in one by one.
+		 * A mapping installed after the slot was created is only seen
+		 * here, from now on the faults look for it too.
+		 */
+		if (vma->vm_flags & (VM_IO | VM_PFNMAP)) {
+			if ((slot->flags & KVM_MEM_EXIT_ON_MISSING) &&
+			    !(slot->flags & KVM_MEMSLOT_PFNMAP))
+				WRITE_ONCE(slot->flags,
+					   slot->flags | KVM_MEMSLOT_PFNMAP);
+			ret = fixup_user_fault(current->mm, hva,
+					       (gup_flags & FOLL_WRITE) ?
+					       FAULT_FLAG_WRITE : 0, NULL);
+			if (ret)
+				return ret;
+			ret = 1;
+		} else {
+			ret = get_user_pages(hva, npages, gup_flags, NULL, NULL);
+			if (ret <= 0)
+				return ret ? ret : -EFAULT;
+		}
+
+		hva += ret << PAGE_SHIFT;
+		npages -= ret;
+	}
+	return 0;
+}
+
+/*
+ * Map in the pages backing a batch of guest physical ranges, typically
+ * after userspace has filled them through a second mapping of the same
+ * memory.  The vCPUs that exited with KVM_EXIT_MEMORY_FAULT on these
+ * ranges then find them present when they are resumed.
+ */
+static int kvm_vm_ioctl_populate_memory(struct kvm *kvm,
+					struct kvm_populate_memory *pop)
+{
+	struct kvm_populate_range *ranges;
+	int i, idx, r = 0;
+
+	if (pop->flags || !pop->nr_ranges ||
+	    pop->nr_ranges > KVM_POPULATE_MAX_RANGES)
+		return -EINVAL;
+
+	ranges = vmemdup_user(u64_to_user_ptr(pop->ranges),
+			      array_size(pop->nr_ranges, sizeof(*ranges)));
+	if (IS_ERR(ranges))
+		return PTR_ERR(ranges);
+
+	idx = srcu_read_lock(&kvm->srcu);
+	mmap_read_lock(current->mm);
+	for (i = 0; i < pop->nr_ranges; i++) {
+		r = kvm_populate_range(kvm, &ranges[i]);
+		if (r)
+			break;
+	}
+	mmap_read_unlock(current->mm);
+	srcu_read_unlock(&kvm->srcu, idx);
+
+	kvfree(ranges);
+	return r;
+}
+#endif
+
 static long kvm_vm_ioctl(struct file *filp,
 			   unsigned int ioctl, unsigned long arg)
 {
@@ -4641,6 +4971,17 @@ static long kvm_vm_ioctl(struct file *filp,
 	case KVM_RESET_DIRTY_RINGS:
 		r = kvm_vm_ioctl_reset_dirty_pages(kvm);
 		break;
+#ifdef CONFIG_HAVE_KVM_EXIT_ON_MISSING
+	case KVM_POPULATE_MEMORY: {
+		struct kvm_populate_memory pop;
+
+		r = -EFAULT;
+		if (copy_from_user(&pop, argp, sizeof(pop)))
+			goto out;
+		r = kvm_vm_ioctl_populate_memory(kvm, &pop);
+		break;
+	}
+#endif
 	case KVM_GET_STATS_FD:
 		r = kvm_vm_ioctl_get_stats_fd(kvm);
 		break;